@@ -111,9 +111,13 @@ final class AccountManager {
 
     var hasUploadedContacts: Bool = false
 
+    // The upload of the Digits contact matches in progress, if any.
+    private var contactMatchUploader: ContactMatchUploader?
+
     // Upload the Address Book contacts. This requires a Digits session.
     func uploadContacts(completion: Bool -> ()) {
-        let contacts = DGTContacts(userSession: self.digitsIdentity!)
+        let digitsIdentity = self.digitsIdentity!
+        let contacts = DGTContacts(userSession: digitsIdentity)
 
         // Start the contacts upload. The first time, Digits will display a modal UI
         // requesting permission to upload the user’s Address Book.
@@ -128,19 +132,36 @@ final class AccountManager {
             print("Your \(result.numberOfUploadedContacts) contacts have been successfully uploaded to Digits.")
             self.hasUploadedContacts = true
 
-            // Note: For this demo app, we only make one request,
-            // since we know the number of friends will be small.
-            // A production app should batch the requests using nextCursor.
-            contacts.lookupContactMatchesWithCursor(nil) { matches, nextCursor, error in
-                guard let matches = matches as? [DGTUser] else {
-                    print("Error looking up contacts: \(error)")
-                    completion(false)
-                    return
+            guard let authenticatedAPI = self.authenticatedAPI where self.contactMatchUploader == nil else {
+                completion(false)
+                return
+            }
+
+            // Follow the match cursors page by page, and post the Digits friends to our API in batches as they come.
+            let uploader = ContactMatchUploader(digitsUserID: digitsIdentity.userID,
+                lookupPage: { cursor, pageCompletion in
+                    contacts.lookupContactMatchesWithCursor(cursor) { matches, nextCursor, error in
+                        guard let matches = matches as? [DGTUser] else {
+                            print("Error looking up contacts: \(error)")
+                            pageCompletion(nil, nil)
+                            return
+                        }
+
+                        pageCompletion(matches.map { $0.userID }, nextCursor)
+                    }
+                },
+                uploadBatch: { userIDs, batchCompletion in
+                    authenticatedAPI.uploadDigitsFriends(digitsUserIDs: userIDs, completion: batchCompletion)
                 }
+            )
+            uploader.progressHandler = { progress in
+                print("Uploaded \(progress.uploadedCount) of \(progress.matchCount) contact matches (\(Int(progress.throughput)) matches/s).")
+            }
 
-                // We can then do something with these Digits friends,
-                // for instance post them to our API.
-                self.authenticatedAPI!.uploadDigitsFriends(digitsUserIDs: matches.map { $0.userID }, completion: completion)
+            self.contactMatchUploader = uploader
+            uploader.start { success in
+                self.contactMatchUploader = nil
+                completion(success)
             }
         }
     }
@@ -154,6 +175,8 @@ final class AccountManager {
             Twitter.sharedInstance().sessionStore.logOutUserID(twitterSession.userID)
         }
 
+        self.user?.favorites.removeAll()
+        Cart.sharedInstance.reset()
         self.user = nil
         self.authenticatedAPI = nil
     }
@@ -229,6 +252,11 @@ final class AccountManager {
         user.digitsPhoneNumber = self.digitsIdentity?.phoneNumber
         user.cognitoID = self.cognitoID
 
+        // Restore the favorites saved during the previous session until the API returns the current ones.
+        // Each user has their own file, so signing in with another account does not show the previous user's favorites.
+        let favoritesURL = WriteBehindStore.fileURL(name: "Favorites", userID: user.digitsUserID ?? user.twitterUserID)
+        user.favorites = FavoritesStore(persistenceURL: favoritesURL)
+
         user.populateWithLocalContact()
 
         self.user = user
@@ -241,10 +269,11 @@ final class AccountManager {
     // Note: This is a naive implementation for demo purposes.
     private func updateFavoriteProducts() {
         guard let user = self.user else { return }
-        guard user.favorites.isEmpty else { return }
 
         authenticatedAPI?.userFavoriteProducts() { products in
-            user.favorites = products ?? []
+            guard let products = products else { return }
+
+            user.favorites.replaceProducts(products)
         }
     }
 
@@ -44,6 +44,13 @@ final class AccountViewController: UIViewController {
         super.viewDidLoad()
 
         signOutButton.decorateForFurni()
+
+        // The contact image of the user is loaded in the background.
+        NSNotificationCenter.defaultCenter().addObserver(self, selector: Selector("userImageChangedNotificationReceived:"), name: User.imageChangedNotificationName, object: nil)
+    }
+
+    deinit {
+        NSNotificationCenter.defaultCenter().removeObserver(self)
     }
 
     override func viewDidLayoutSubviews() {
@@ -63,4 +70,12 @@ final class AccountViewController: UIViewController {
         self.nameLabel.text = user?.fullName
         self.pictureImageView.image = user?.image
     }
+
+    // MARK: Utilities
+
+    @objc private func userImageChangedNotificationReceived(notification: NSNotification) {
+        guard let user = AccountManager.defaultAccountManager.user where notification.object === user else { return }
+
+        pictureImageView.image = user.image
+    }
 }
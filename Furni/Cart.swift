@@ -17,58 +17,99 @@
 import Foundation
 import Crashlytics
 
+// The products the user is about to buy, in the order they were added, indexed by product ID.
+// Totals are kept up to date as items change, and changes made during a run loop turn are posted
+// as a single notification and then written to disk in the background.
 final class Cart {
-    static let sharedInstance = Cart()
+    static let sharedInstance = Cart(persistenceURL: WriteBehindStore.fileURL(name: "Cart"))
 
     static let cartUpdatedNotificationName = "xyz.furni.cart.updated.notification"
 
-    var items: [CartItem] = [] {
-        didSet {
-            postCartUpdatedNotification()
+    // The most units of a single product that can be ordered.
+    static let maximumQuantity = 10
+
+    private(set) var items: [CartItem] = []
+    private var indexesByProductID: [Int : Int] = [:]
+
+    private var cachedProductCount = 0
+    private(set) var subtotalCents: Int64 = 0
+
+    private let persistentStore: WriteBehindStore?
+
+    private var isFlushScheduled = false
+
+    // Create a cart, restoring the items previously saved at the given URL if any.
+    init(items: [CartItem] = [], persistenceURL: NSURL? = nil) {
+        persistentStore = persistenceURL.map(WriteBehindStore.init)
+
+        if let persistentStore = persistentStore where items.isEmpty {
+            replaceItems(persistentStore.load().flatMap { dictionary -> CartItem? in
+                guard let productDictionary = dictionary["product"] as? [String : AnyObject], quantity = dictionary["quantity"] as? Int else { return nil }
+                let product = Product(dictionary: productDictionary, collectionPermalink: (productDictionary["collection"] as? String) ?? "")
+                return CartItem(product: product, quantity: quantity)
+            })
+
+            // Let observers such as the cart tab badge pick up the restored items.
+            if !self.items.isEmpty {
+                scheduleFlush()
+            }
+        } else {
+            replaceItems(items)
         }
     }
 
-    init() {
+    // MARK: Totals
+
+    func productCount() -> Int {
+        return cachedProductCount
     }
 
-    init(items: [CartItem]) {
-        self.items = items
+    var shippingCents: Int64 {
+        return 0
     }
 
-    func productCount() -> Int {
-        var count = 0
-        for item in items {
-            count += item.quantity
-        }
-        return count
+    var totalCents: Int64 {
+        return subtotalCents + shippingCents
     }
 
     func subtotalAmount() -> Float {
-        return items.map { $0.price }.reduce(0, combine: +)
+        return Float(subtotalCents) / 100
     }
 
     func shippingAmount() -> Float {
-        return 0
+        return Float(shippingCents) / 100
     }
 
     func totalAmount() -> Float {
-        return subtotalAmount() + shippingAmount()
+        return Float(totalCents) / 100
+    }
+
+    func isEmpty() -> Bool {
+        return cachedProductCount == 0
+    }
+
+    // MARK: Items
+
+    func quantityOfProductWithID(productID: Int) -> Int {
+        guard let index = indexesByProductID[productID] else { return 0 }
+        return items[index].quantity
     }
 
     func addProduct(product: Product) {
         // Check if the product is already part of the cart.
-        let existingCartItem = items.filter { $0.product.id == product.id }.first
-
-        if let existingCartItem = existingCartItem {
-            if existingCartItem.quantity < 10 {
-                existingCartItem.quantity += 1
+        if let index = indexesByProductID[product.id] {
+            let existingCartItem = items[index]
+            if existingCartItem.quantity < Cart.maximumQuantity {
+                replaceItemAtIndex(index, withItem: existingCartItem.itemWithQuantity(existingCartItem.quantity + 1))
             }
         } else {
-            items.append(CartItem(product: product))
+            let cartItem = CartItem(product: product)
+            indexesByProductID[product.id] = items.count
+            items.append(cartItem)
+            addItemToTotals(cartItem)
+            scheduleFlush()
         }
 
-        postCartUpdatedNotification()
-
         // Log Cart Event in Answers.
         Answers.logAddToCartWithPrice(NSDecimalNumber(float: product.price),
             currency: "USD",
@@ -79,19 +120,103 @@ final class Cart {
         )
     }
 
+    // Change the quantity of a product already in the cart, removing it when the quantity drops to zero.
+    func setQuantity(quantity: Int, ofProductWithID productID: Int) {
+        guard let index = indexesByProductID[productID] else { return }
+
+        if quantity > 0 {
+            replaceItemAtIndex(index, withItem: items[index].itemWithQuantity(min(quantity, Cart.maximumQuantity)))
+        } else {
+            removeItemAtIndex(index)
+        }
+    }
+
     func removeProduct(product: Product) {
-        items = items.filter { $0.product.id != product.id }
+        guard let index = indexesByProductID[product.id] else { return }
+        removeItemAtIndex(index)
     }
 
-    func isEmpty() -> Bool {
-        return productCount() == 0
+    func removeItemAtIndex(index: Int) {
+        let cartItem = items.removeAtIndex(index)
+        indexesByProductID[cartItem.product.id] = nil
+        for shiftedIndex in index..<items.count {
+            indexesByProductID[items[shiftedIndex].product.id] = shiftedIndex
+        }
+
+        removeItemFromTotals(cartItem)
+        scheduleFlush()
     }
 
     func reset() {
+        replaceItems([])
+        scheduleFlush()
+    }
+
+    // MARK: Private
+
+    private func replaceItemAtIndex(index: Int, withItem cartItem: CartItem) {
+        removeItemFromTotals(items[index])
+        items[index] = cartItem
+        addItemToTotals(cartItem)
+        scheduleFlush()
+    }
+
+    // Items for the same product are merged into a single line.
+    private func replaceItems(newItems: [CartItem]) {
         items = []
+        items.reserveCapacity(newItems.count)
+        indexesByProductID = [:]
+        cachedProductCount = 0
+        subtotalCents = 0
+
+        for cartItem in newItems where cartItem.quantity > 0 {
+            if let index = indexesByProductID[cartItem.product.id] {
+                let quantity = min(items[index].quantity + cartItem.quantity, Cart.maximumQuantity)
+                removeItemFromTotals(items[index])
+                items[index] = items[index].itemWithQuantity(quantity)
+                addItemToTotals(items[index])
+            } else {
+                let boundedItem = cartItem.itemWithQuantity(min(cartItem.quantity, Cart.maximumQuantity))
+                indexesByProductID[cartItem.product.id] = items.count
+                items.append(boundedItem)
+                addItemToTotals(boundedItem)
+            }
+        }
+    }
+
+    private func addItemToTotals(cartItem: CartItem) {
+        cachedProductCount += cartItem.quantity
+        subtotalCents += cartItem.priceCents
+    }
+
+    private func removeItemFromTotals(cartItem: CartItem) {
+        cachedProductCount -= cartItem.quantity
+        subtotalCents -= cartItem.priceCents
+    }
+
+    private func scheduleFlush() {
+        guard !isFlushScheduled else { return }
+        isFlushScheduled = true
+
+        dispatch_async(dispatch_get_main_queue()) {
+            self.flush()
+        }
     }
 
-    private func postCartUpdatedNotification() {
+    private func flush() {
+        isFlushScheduled = false
+
         NSNotificationCenter.defaultCenter().postNotificationName(Cart.cartUpdatedNotificationName, object: self)
+
+        persistentStore?.schedule {
+            self.items.map { ["product": $0.product.dictionaryRepresentation, "quantity": $0.quantity] as [String : AnyObject] } as NSArray
+        }
+    }
+}
+
+extension NSDecimalNumber {
+    // An exact decimal amount from a number of cents.
+    convenience init(cents: Int64) {
+        self.init(mantissa: UInt64(abs(cents)), exponent: -2, isNegative: cents < 0)
     }
 }
@@ -16,23 +16,31 @@
 
 import Foundation
 
-class CartItem {
+// A line of the cart. Prices are kept in cents so that totals add up exactly.
+struct CartItem {
 
-    var product: Product
-    var quantity: Int = 0
+    let product: Product
+    let quantity: Int
 
-    init(product: Product) {
-        self.product = product
-        self.quantity = 1
-    }
+    // The price of a single unit in cents.
+    let unitPriceCents: Int64
 
-    init(product: Product, quantity: Int) {
+    init(product: Product, quantity: Int = 1) {
         self.product = product
         self.quantity = quantity
+        self.unitPriceCents = Int64(round(Double(product.price) * 100))
+    }
+
+    var priceCents: Int64 {
+        return unitPriceCents * Int64(quantity)
     }
 
     var price: Float {
-        return self.product.price * Float(self.quantity)
+        return Float(priceCents) / 100
     }
 
+    // A copy of this item with a different quantity.
+    func itemWithQuantity(quantity: Int) -> CartItem {
+        return CartItem(product: product, quantity: quantity)
+    }
 }
@@ -21,9 +21,8 @@ final class CartItemCell: UITableViewCell {
 
     static let reuseIdentifier = "CartItemCell"
 
-    var cartItemQuantityChangedCallback: (() -> ())!
-
-    private weak var cartItem: CartItem!
+    // Called with the quantity picked with the stepper.
+    var cartItemQuantityChangedCallback: ((Int) -> ())!
 
     // MARK: Properties
 
@@ -43,9 +42,8 @@ final class CartItemCell: UITableViewCell {
 
     @IBAction private func quantityStepperValueChanged(sender: UIStepper) {
         let value = Int(sender.value)
-        cartItem!.quantity = value
         quantityLabel.text = "Quantity: \(value)"
-        cartItemQuantityChangedCallback()
+        cartItemQuantityChangedCallback(value)
     }
 
     override func awakeFromNib() {
@@ -57,8 +55,6 @@ final class CartItemCell: UITableViewCell {
     }
 
     func configureWithCartItem(cartItem: CartItem) {
-        self.cartItem = cartItem
-
         // Assign the labels.
         nameLabel.text = cartItem.product.name
         priceLabel.text = cartItem.price.asCurrency
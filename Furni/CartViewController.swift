@@ -52,6 +52,9 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
     // Order price in cents.
     private var orderPriceCents: Float = 0
 
+    // Kept around so that the connection it warms up is still open when the payment is authorized.
+    private lazy var apiClient: STPAPIClient? = self.paymentConfiguration.map { STPAPIClient(publishableKey: $0.stripePublishableKey) }
+
     // MARK: View Life Cycle
 
     override func viewDidLoad() {
@@ -76,6 +79,15 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
         toggleEmptyCartLabel()
     }
 
+    override func viewDidAppear(animated: Bool) {
+        super.viewDidAppear(animated)
+
+        // A checkout is likely, so connect to Stripe while the user reviews the cart.
+        if !cart.isEmpty() {
+            apiClient?.warmUpConnection()
+        }
+    }
+
 
     // MARK: IBActions
 
@@ -113,18 +125,21 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
         paymentRequest.requiredShippingAddressFields = .PostalAddress
         paymentRequest.requiredBillingAddressFields = .Email
         paymentRequest.paymentSummaryItems = [
-            PKPaymentSummaryItem(label: "Subtotal", amount: NSDecimalNumber(float: cart.subtotalAmount())),
-            PKPaymentSummaryItem(label: "Shipping", amount: NSDecimalNumber(float: cart.shippingAmount())),
-            PKPaymentSummaryItem(label: "Furni", amount: NSDecimalNumber(float: cart.totalAmount()))
+            PKPaymentSummaryItem(label: "Subtotal", amount: NSDecimalNumber(cents: cart.subtotalCents)),
+            PKPaymentSummaryItem(label: "Shipping", amount: NSDecimalNumber(cents: cart.shippingCents)),
+            PKPaymentSummaryItem(label: "Furni", amount: NSDecimalNumber(cents: cart.totalCents))
         ]
 
         // Log Start Checkout Event in Answers.
-        Answers.logStartCheckoutWithPrice(NSDecimalNumber(float: cart.totalAmount()),
+        Answers.logStartCheckoutWithPrice(NSDecimalNumber(cents: cart.totalCents),
             currency: "USD",
             itemCount: cart.productCount(),
             customAttributes: nil
         )
 
+        // Make sure the connection to Stripe is open by the time the payment is authorized.
+        apiClient?.warmUpConnection()
+
         // Setup and present the payment view controller.
         let paymentAuthViewController = PKPaymentAuthorizationViewController(paymentRequest: paymentRequest)
         paymentAuthViewController.delegate = self
@@ -155,9 +170,14 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
         // Reset the cart.
         self.cart.reset()
 
-        // Setup the Stripe API client to create a token from the payment.
-        let apiClient = STPAPIClient(publishableKey: paymentConfiguration!.stripePublishableKey)
-        apiClient.createTokenWithPayment(payment, completion: { token, error in
+        // Create a token from the payment, and report how long it takes in Answers.
+        let tokenRequestStartTime = CFAbsoluteTimeGetCurrent()
+        apiClient!.createTokenWithPayment(payment, completion: { token, error in
+            Answers.logCustomEventWithName("Created Stripe Token", customAttributes: [
+                "Duration (ms)": Int((CFAbsoluteTimeGetCurrent() - tokenRequestStartTime) * 1000),
+                "Success": token != nil ? "Yes" : "No"
+            ])
+
             guard let token = token else {
                 completion(.Failure)
                 return
@@ -225,8 +245,8 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
         let cartItem = cart.items[indexPath.row]
 
         // Keep a weak reference on the table view.
-        cell.cartItemQuantityChangedCallback = { [unowned self] in
-            self.refreshCartDisplay()
+        cell.cartItemQuantityChangedCallback = { [unowned self] quantity in
+            self.cart.setQuantity(quantity, ofProductWithID: cartItem.product.id)
             self.tableView.reloadData()
         }
 
@@ -241,7 +261,7 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
         guard editingStyle == .Delete else { return }
 
         // Remove this item from the cart and refresh the table view.
-        cart.items.removeAtIndex(indexPath.row)
+        cart.removeItemAtIndex(indexPath.row)
 
         // Either delete some rows within the section (leaving at least one) or the entire section.
         if cart.items.count > 0 {
@@ -279,7 +299,7 @@ final class CartViewController: UITableViewController, PKPaymentAuthorizationVie
 
     @objc private func cartUpdatedNotificationReceived() {
         // Update the price of the cart in cents.
-        orderPriceCents = cart.totalAmount() * 100.0
+        orderPriceCents = Float(cart.totalCents)
 
         // Refresh the cart display.
         self.refreshCartDisplay()
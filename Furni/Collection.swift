@@ -26,7 +26,7 @@ class Collection {
     let imageURL: NSURL
     let largeImageURL: NSURL
     let date: NSDate?
-    var products: [Product] = []
+    var catalog = ProductCatalog.emptyCatalog
 
     init(id: Int, permalink: String, name: String, tagline: String, description: String, collectionURL: NSURL, imageURL: NSURL, largeImageURL: NSURL) {
         self.id = id
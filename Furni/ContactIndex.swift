@@ -0,0 +1,300 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+import UIKit
+import Contacts
+
+// The parts of a local contact needed to enrich a user. The image is left out and fetched lazily.
+struct IndexedContact {
+    let identifier: String
+    let fullName: String?
+    let postalAddress: CNPostalAddress?
+    let phoneNumbers: [String]
+}
+
+// Maps normalized phone numbers to local contacts.
+// The index is built once, on first use, and then patched whenever the contact store changes,
+// so that matching a user against the Address Book is a few hash lookups instead of a full enumeration.
+final class ContactIndex {
+    static let sharedIndex = ContactIndex(store: CNContactStore())
+
+    // Keys fetched when building the index. Image data is deliberately not part of them.
+    private static let keysToFetch: [CNKeyDescriptor] = [CNContactIdentifierKey, CNContactPhoneNumbersKey, CNContactFormatter.descriptorForRequiredKeysForStyle(.FullName), CNContactPostalAddressesKey]
+
+    private let store: CNContactStore?
+
+    // All the state below is only accessed on this queue.
+    private let queue = dispatch_queue_create("xyz.furni.contact-index", DISPATCH_QUEUE_SERIAL)
+    private var contactsByIdentifier: [String : IndexedContact] = [:]
+    // Every contact with a number, in the order they were indexed. Lookups return the first one.
+    private var identifiersByPhoneNumberKey: [PhoneNumberKey : [String]] = [:]
+    private var isLoaded = false
+    private var isRefreshScheduled = false
+
+    private let thumbnailCache = NSCache()
+    private let thumbnailQueue = dispatch_queue_create("xyz.furni.contact-thumbnails", DISPATCH_QUEUE_SERIAL)
+    private var contactStoreObserver: NSObjectProtocol?
+
+    init(store: CNContactStore?) {
+        self.store = store
+
+        guard store != nil else { return }
+
+        // The Contacts framework does not tell which contacts changed, so refresh the whole index off the main thread.
+        contactStoreObserver = NSNotificationCenter.defaultCenter().addObserverForName(CNContactStoreDidChangeNotification, object: nil, queue: nil) { [weak self] _ in
+            self?.scheduleRefresh()
+        }
+    }
+
+    // Create an index over a fixed set of contacts, without a contact store.
+    convenience init(contacts: [IndexedContact]) {
+        self.init(store: nil)
+        self.updateWithContacts(contacts)
+        self.isLoaded = true
+    }
+
+    deinit {
+        if let contactStoreObserver = contactStoreObserver {
+            NSNotificationCenter.defaultCenter().removeObserver(contactStoreObserver)
+        }
+    }
+
+    // Replace the contacts of an index created over a fixed set of contacts.
+    func replaceContacts(contacts: [IndexedContact]) {
+        dispatch_sync(queue) {
+            self.updateWithContacts(contacts)
+        }
+    }
+
+    var count: Int {
+        var count = 0
+        dispatch_sync(queue) {
+            count = self.contactsByIdentifier.count
+        }
+        return count
+    }
+
+    // Build the index in the background ahead of the first lookup.
+    func warmUp() {
+        dispatch_async(queue) {
+            self.loadIfNeeded()
+        }
+    }
+
+    // Find the local contact whose phone number matches the given one, e.g. a Digits phone number.
+    func contactMatchingPhoneNumber(phoneNumber: String) -> IndexedContact? {
+        var contact: IndexedContact?
+        dispatch_sync(queue) {
+            self.loadIfNeeded()
+
+            // Contacts are often saved without a country code, so look up the longest known suffix first.
+            let digits = phoneNumberDigits(phoneNumber)
+            guard digits.count >= PhoneNumberKeyMinimumDigits else { return }
+
+            for length in (PhoneNumberKeyMinimumDigits...min(PhoneNumberKeyMaximumDigits, digits.count)).reverse() {
+                if let identifier = self.identifiersByPhoneNumberKey[phoneNumberKey(digits, length: length)]?.first {
+                    contact = self.contactsByIdentifier[identifier]
+                    return
+                }
+            }
+        }
+        return contact
+    }
+
+    // The thumbnail of a contact, if it was already read from the store.
+    func cachedThumbnailForContactWithIdentifier(identifier: String) -> UIImage? {
+        return thumbnailCache.objectForKey(identifier) as? UIImage
+    }
+
+    // Read the thumbnail of a contact from the store in the background and call back on the main queue.
+    // Thumbnails are only read from the store the first time they are requested.
+    func loadThumbnailForContactWithIdentifier(identifier: String, completion: UIImage? -> Void) {
+        if let image = cachedThumbnailForContactWithIdentifier(identifier) {
+            completion(image)
+            return
+        }
+
+        guard let store = store else {
+            completion(nil)
+            return
+        }
+
+        dispatch_async(thumbnailQueue) {
+            var image: UIImage?
+            do {
+                let contact = try store.unifiedContactWithIdentifier(identifier, keysToFetch: [CNContactThumbnailImageDataKey])
+                image = contact.thumbnailImageData.flatMap(UIImage.init)
+                if let image = image {
+                    self.thumbnailCache.setObject(image, forKey: identifier)
+                }
+            }
+            catch let error as NSError {
+                print("Error fetching contact thumbnail: \(error)")
+            }
+
+            dispatch_async(dispatch_get_main_queue()) {
+                completion(image)
+            }
+        }
+    }
+
+    // MARK: Private
+
+    // Replace the indexed contacts. Contacts that did not change keep their entries.
+    private func updateWithContacts(contacts: [IndexedContact]) {
+        var removedIdentifiers = Set(contactsByIdentifier.keys)
+
+        for contact in contacts {
+            removedIdentifiers.remove(contact.identifier)
+
+            if let existingContact = contactsByIdentifier[contact.identifier] {
+                guard !contact.isEquivalentToContact(existingContact) else { continue }
+
+                removeContact(existingContact)
+                thumbnailCache.removeObjectForKey(contact.identifier)
+            }
+
+            addContact(contact)
+        }
+
+        for identifier in removedIdentifiers {
+            removeContact(contactsByIdentifier[identifier]!)
+            thumbnailCache.removeObjectForKey(identifier)
+        }
+    }
+
+    private func loadIfNeeded() {
+        guard !isLoaded else { return }
+        guard CNContactStore.authorizationStatusForEntityType(.Contacts) == .Authorized else { return }
+
+        if let contacts = fetchContacts() {
+            updateWithContacts(contacts)
+            isLoaded = true
+        }
+    }
+
+    private func scheduleRefresh() {
+        dispatch_async(queue) {
+            // Coalesce bursts of change notifications into a single refresh.
+            guard self.isLoaded && !self.isRefreshScheduled else { return }
+            self.isRefreshScheduled = true
+
+            dispatch_async(self.queue) {
+                self.isRefreshScheduled = false
+
+                if let contacts = self.fetchContacts() {
+                    self.updateWithContacts(contacts)
+                }
+            }
+        }
+    }
+
+    private func fetchContacts() -> [IndexedContact]? {
+        guard let store = store else { return nil }
+
+        let fetchRequest = CNContactFetchRequest(keysToFetch: ContactIndex.keysToFetch)
+        var contacts: [IndexedContact] = []
+
+        do {
+            try store.enumerateContactsWithFetchRequest(fetchRequest) { contact, _ in
+                contacts.append(IndexedContact(
+                    identifier: contact.identifier,
+                    fullName: CNContactFormatter.stringFromContact(contact, style: .FullName),
+                    postalAddress: contact.postalAddresses.map { $0.value as! CNPostalAddress }.first,
+                    phoneNumbers: contact.phoneNumbers.map { ($0.value as! CNPhoneNumber).stringValue }))
+            }
+        }
+        catch let error as NSError {
+            print("Error indexing contacts: \(error)")
+            return nil
+        }
+
+        return contacts
+    }
+
+    private func addContact(contact: IndexedContact) {
+        contactsByIdentifier[contact.identifier] = contact
+
+        for phoneNumber in contact.phoneNumbers {
+            guard let key = phoneNumberKey(phoneNumber) else { continue }
+
+            // When several contacts share a number, the first one indexed wins. The others are kept so that the number
+            // still matches one of them once that contact is removed.
+            var identifiers = identifiersByPhoneNumberKey[key] ?? []
+            if !identifiers.contains(contact.identifier) {
+                identifiers.append(contact.identifier)
+                identifiersByPhoneNumberKey[key] = identifiers
+            }
+        }
+    }
+
+    private func removeContact(contact: IndexedContact) {
+        contactsByIdentifier.removeValueForKey(contact.identifier)
+
+        for phoneNumber in contact.phoneNumbers {
+            guard let key = phoneNumberKey(phoneNumber) else { continue }
+
+            guard var identifiers = identifiersByPhoneNumberKey[key], let index = identifiers.indexOf(contact.identifier) else { continue }
+
+            identifiers.removeAtIndex(index)
+            identifiersByPhoneNumberKey[key] = identifiers.isEmpty ? nil : identifiers
+        }
+    }
+}
+
+private extension IndexedContact {
+    func isEquivalentToContact(contact: IndexedContact) -> Bool {
+        return fullName == contact.fullName && phoneNumbers == contact.phoneNumbers && postalAddress == contact.postalAddress
+    }
+}
+
+// MARK: Phone Number Keys
+
+// A phone number is keyed by its trailing digits, packed into an integer along with their count
+// so that "0155" and "155" stay distinct. Punctuation and spaces are ignored.
+private typealias PhoneNumberKey = UInt64
+
+private let PhoneNumberKeyMaximumDigits = 10
+private let PhoneNumberKeyMinimumDigits = 7
+
+private func phoneNumberDigits(phoneNumber: String) -> [UInt8] {
+    var digits: [UInt8] = []
+    digits.reserveCapacity(16)
+
+    for unit in phoneNumber.utf8 where unit >= 48 && unit <= 57 {
+        digits.append(unit - 48)
+    }
+
+    return digits
+}
+
+private func phoneNumberKey(digits: [UInt8], length: Int) -> PhoneNumberKey {
+    var value: UInt64 = 0
+    for digit in digits[(digits.count - length)..<digits.count] {
+        value = value * 10 + UInt64(digit)
+    }
+
+    return value * 16 + UInt64(length)
+}
+
+// The key a contact's phone number is indexed under, or nil if it is too short to be matched reliably.
+private func phoneNumberKey(phoneNumber: String) -> PhoneNumberKey? {
+    let digits = phoneNumberDigits(phoneNumber)
+    guard digits.count >= PhoneNumberKeyMinimumDigits else { return nil }
+
+    return phoneNumberKey(digits, length: min(PhoneNumberKeyMaximumDigits, digits.count))
+}
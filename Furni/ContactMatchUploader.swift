@@ -0,0 +1,227 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+// Streams the Digits contact matches of a user to the friendships API.
+// Pages of matches are looked up while earlier matches are uploaded in batches of bounded size, and lookups pause
+// when too many matches are waiting. The cursor of the first page not fully uploaded is saved after every step,
+// so an interrupted upload resumes from there instead of starting over.
+final class ContactMatchUploader {
+    typealias UserID = String
+
+    // Looks up the page of matches at a cursor, or the first page for a nil cursor, then calls back with the
+    // matched user IDs (nil on error) and the cursor of the next page (nil after the last page).
+    typealias LookupPage = (String?, ([UserID]?, String?) -> ()) -> ()
+
+    // Uploads a batch of matched user IDs, then calls back with whether it succeeded.
+    typealias UploadBatch = ([UserID], Bool -> ()) -> ()
+
+    struct Progress {
+        var pageCount = 0
+        var matchCount = 0
+        var uploadedCount = 0
+        var isFinished = false
+        let startDate = NSDate()
+
+        var elapsedTime: NSTimeInterval {
+            return -startDate.timeIntervalSinceNow
+        }
+
+        // Matches uploaded per second.
+        var throughput: Double {
+            let elapsedTime = self.elapsedTime
+            return elapsedTime > 0 ? Double(uploadedCount) / elapsedTime : 0
+        }
+    }
+
+    let batchSize: Int
+
+    // The number of matches that can wait for upload before lookups pause.
+    let maximumPendingCount: Int
+
+    // Called on the main queue after every page looked up and every batch uploaded.
+    var progressHandler: (Progress -> ())?
+
+    private(set) var progress = Progress()
+
+    private let lookupPage: LookupPage
+    private let uploadBatch: UploadBatch
+    private let userDefaults: NSUserDefaults
+    private let checkpointKey: String
+
+    // The cursor each page was looked up with, by page index.
+    private var pageCursors: [String?] = []
+    private var nextCursor: String?
+    private var isLookupFinished = false
+    private var isLookupInFlight = false
+
+    // Matches waiting for upload and matches being uploaded, with the index of the page they come from.
+    private var pendingMatches: [(userID: UserID, pageIndex: Int)] = []
+    private var uploadingMatches: [(userID: UserID, pageIndex: Int)] = []
+    private var seenUserIDs = Set<UserID>()
+
+    private var completion: (Bool -> ())?
+
+    // Incremented by every run, so callbacks still in flight from an earlier, failed run are ignored.
+    private var generation = 0
+
+    init(digitsUserID: String, batchSize: Int = 100, userDefaults: NSUserDefaults = NSUserDefaults.standardUserDefaults(), lookupPage: LookupPage, uploadBatch: UploadBatch) {
+        self.batchSize = batchSize
+        self.maximumPendingCount = batchSize * 4
+        self.userDefaults = userDefaults
+        self.checkpointKey = "xyz.furni.contact-matches.cursor.\(digitsUserID)"
+        self.lookupPage = lookupPage
+        self.uploadBatch = uploadBatch
+    }
+
+    var isRunning: Bool {
+        return completion != nil
+    }
+
+    // Start uploading, resuming after the last page fully uploaded by a previous run if any.
+    func start(completion: Bool -> ()) {
+        guard !isRunning else { return }
+
+        self.completion = completion
+        generation += 1
+        progress = Progress()
+        pageCursors = []
+        nextCursor = userDefaults.stringForKey(checkpointKey)
+        isLookupFinished = false
+        isLookupInFlight = false
+        pendingMatches = []
+        uploadingMatches = []
+        seenUserIDs = []
+
+        if nextCursor != nil {
+            print("Resuming the contact matches upload.")
+        }
+
+        advance()
+    }
+
+    // MARK: Private
+
+    private func advance() {
+        guard isRunning else { return }
+
+        if !isLookupInFlight && !isLookupFinished && pendingMatches.count < maximumPendingCount {
+            lookUpNextPage()
+        }
+
+        if uploadingMatches.isEmpty && (pendingMatches.count >= batchSize || (isLookupFinished && !pendingMatches.isEmpty)) {
+            uploadNextBatch()
+        }
+
+        if isLookupFinished && pendingMatches.isEmpty && uploadingMatches.isEmpty {
+            finish(true)
+        }
+    }
+
+    private func lookUpNextPage() {
+        let cursor = nextCursor
+        let pageIndex = pageCursors.count
+        pageCursors.append(cursor)
+        isLookupInFlight = true
+
+        let generation = self.generation
+        lookupPage(cursor) { userIDs, nextCursor in
+            guard self.isRunning && generation == self.generation else { return }
+            self.isLookupInFlight = false
+
+            guard let userIDs = userIDs else {
+                self.finish(false)
+                return
+            }
+
+            for userID in userIDs where !self.seenUserIDs.contains(userID) {
+                self.seenUserIDs.insert(userID)
+                self.pendingMatches.append((userID: userID, pageIndex: pageIndex))
+            }
+
+            self.nextCursor = nextCursor
+            self.isLookupFinished = nextCursor?.isEmpty ?? true
+
+            self.progress.pageCount += 1
+            self.progress.matchCount = self.seenUserIDs.count
+            self.saveCheckpoint()
+            self.reportProgress()
+
+            self.advance()
+        }
+    }
+
+    private func uploadNextBatch() {
+        let batchCount = min(batchSize, pendingMatches.count)
+        uploadingMatches = Array(pendingMatches[0..<batchCount])
+        pendingMatches.removeRange(0..<batchCount)
+
+        let generation = self.generation
+        uploadBatch(uploadingMatches.map { $0.userID }) { success in
+            guard self.isRunning && generation == self.generation else { return }
+
+            guard success else {
+                self.finish(false)
+                return
+            }
+
+            self.progress.uploadedCount += self.uploadingMatches.count
+            self.uploadingMatches = []
+            self.saveCheckpoint()
+            self.reportProgress()
+
+            self.advance()
+        }
+    }
+
+    // Save the cursor of the first page with matches not uploaded yet. Nothing is saved once all pages are uploaded.
+    private func saveCheckpoint() {
+        let cursor: String?
+        if let firstMatch = uploadingMatches.first ?? pendingMatches.first {
+            cursor = pageCursors[firstMatch.pageIndex]
+        } else if !isLookupFinished {
+            cursor = nextCursor
+        } else {
+            cursor = nil
+        }
+
+        if let cursor = cursor {
+            userDefaults.setObject(cursor, forKey: checkpointKey)
+        } else {
+            userDefaults.removeObjectForKey(checkpointKey)
+        }
+    }
+
+    private func reportProgress() {
+        progressHandler?(progress)
+    }
+
+    private func finish(success: Bool) {
+        guard let completion = completion else { return }
+        self.completion = nil
+
+        if success {
+            progress.isFinished = true
+            reportProgress()
+            print("Uploaded \(progress.uploadedCount) contact matches from \(progress.pageCount) pages in \(String(format: "%.1f", progress.elapsedTime))s (\(Int(progress.throughput)) matches/s).")
+        } else {
+            print("Error uploading contact matches after \(progress.uploadedCount) of \(progress.matchCount). The upload will resume from the last saved page.")
+        }
+
+        completion(success)
+    }
+}
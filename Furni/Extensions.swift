@@ -47,13 +47,18 @@ extension String {
     }
 }
 
+// Number formatters are expensive to create, so share one. It follows changes to the device locale.
+private let currencyFormatter: NSNumberFormatter = {
+    let formatter = NSNumberFormatter()
+    formatter.numberStyle = .CurrencyStyle
+    formatter.locale = NSLocale.autoupdatingCurrentLocale()
+    return formatter
+}()
+
 extension Float {
     // Format a price with currency based on the device locale.
     var asCurrency: String {
-        let formatter = NSNumberFormatter()
-        formatter.numberStyle = .CurrencyStyle
-        formatter.locale = NSLocale.currentLocale()
-        return formatter.stringFromNumber(self)!
+        return currencyFormatter.stringFromNumber(self)!
     }
 }
 
@@ -26,10 +26,16 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
 
     var friends: [User] = [] {
         didSet {
-            self.collectionView!.reloadData()
+            self.updateCollectionView()
         }
     }
 
+    // The users and favorite products currently displayed, used to find what changed on refresh.
+    private var displayedSections: [(userID: String, productIDs: [Int])] = []
+
+    // Whether the find friends footer was hidden when the collection view was last reloaded.
+    private var displayedHasUploadedContacts = false
+
     static let emptyFooterReusableID = "EmptyFooter"
 
     var refreshControl: UIRefreshControl?
@@ -48,6 +54,9 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
 
         collectionView!.delegate = self
 
+        // Listen to notifications about favorites being added or removed.
+        NSNotificationCenter.defaultCenter().addObserver(self, selector: Selector("favoritesChangedNotificationReceived:"), name: FavoritesStore.favoritesChangedNotificationName, object: nil)
+
         // Fetch friends and favorite products from the API.
         fetchFavoriteProducts()
     }
@@ -59,6 +68,10 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
         self.fetchFavoriteProducts()
     }
 
+    deinit {
+        NSNotificationCenter.defaultCenter().removeObserver(self)
+    }
+
     // MARK: UICollectionViewDataSource
 
     override func numberOfSectionsInCollectionView(collectionView: UICollectionView) -> Int {
@@ -95,18 +108,8 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
                 // Dequeue the friend header view.
                 let friendHeaderView = collectionView.dequeueReusableSupplementaryViewOfKind(UICollectionElementKindSectionHeader, withReuseIdentifier: FriendHeaderView.reuseIdentifier, forIndexPath: indexPath) as! FriendHeaderView
 
-                // Find the corresponding user.
-                let user = friends[indexPath.section]
-
-                // Show or hide the message button.
-                let friendIsMe = user === AccountManager.defaultAccountManager.user
-                friendHeaderView.showMessageButton = !friendIsMe
-                friendHeaderView.sendMessageCallback = { [unowned self] in
-                    self.sendMessageToFriend(user)
-                }
-
-                // Configure the view with the user.
-                friendHeaderView.configureWithUser(user)
+                // Configure the view with the corresponding user.
+                configureHeaderView(friendHeaderView, inSection: indexPath.section)
 
                 // Return the header view.
                 return friendHeaderView
@@ -135,6 +138,21 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
         return UICollectionReusableView()
     }
 
+    private func configureHeaderView(friendHeaderView: FriendHeaderView, inSection section: Int) {
+        // Find the corresponding user.
+        let user = friends[section]
+
+        // Show or hide the message button.
+        let friendIsMe = user === AccountManager.defaultAccountManager.user
+        friendHeaderView.showMessageButton = !friendIsMe
+        friendHeaderView.sendMessageCallback = { [unowned self] in
+            self.sendMessageToFriend(user)
+        }
+
+        // Configure the view with the user.
+        friendHeaderView.configureWithUser(user)
+    }
+
     // MARK: UICollectionViewDelegateFlowLayout
 
     func collectionView(collectionView: UICollectionView, layout collectionViewLayout: UICollectionViewLayout, sizeForItemAtIndexPath indexPath: NSIndexPath) -> CGSize {
@@ -207,6 +225,69 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
         controller.dismissViewControllerAnimated(true, completion: nil)
     }
 
+    // MARK: Utilities
+
+    @objc private func favoritesChangedNotificationReceived(notification: NSNotification) {
+        guard friends.contains({ $0.favorites === notification.object }) else { return }
+
+        updateCollectionView()
+    }
+
+    // Only touch the cells of favorites that were added, removed or moved.
+    // When the friends themselves changed, or the find friends footer appeared or went away, the sections and footers
+    // need to be rebuilt, so reload everything.
+    private func updateCollectionView() {
+        let sections: [(userID: String, productIDs: [Int])] = friends.map { (userID: $0.cognitoID ?? "", productIDs: $0.favorites.products.map { $0.id }) }
+        let oldSections = displayedSections
+        displayedSections = sections
+
+        let hasUploadedContacts = AccountManager.defaultAccountManager.hasUploadedContacts
+        let footerChanged = hasUploadedContacts != displayedHasUploadedContacts
+        displayedHasUploadedContacts = hasUploadedContacts
+
+        guard sections.map({ $0.userID }) == oldSections.map({ $0.userID }) && !footerChanged && collectionView!.window != nil else {
+            collectionView!.reloadData()
+            return
+        }
+
+        var diffs: [(section: Int, diff: ListDiff)] = []
+        for (section, (oldSection, newSection)) in zip(oldSections, sections).enumerate() {
+            guard let diff = ListDiff(from: oldSection.productIDs, to: newSection.productIDs, key: { $0 }) else {
+                collectionView!.reloadData()
+                return
+            }
+
+            if !diff.isEmpty {
+                diffs.append((section: section, diff: diff))
+            }
+        }
+
+        if !diffs.isEmpty {
+            collectionView!.performBatchUpdates({
+                for (section, diff) in diffs {
+                    self.collectionView!.deleteItemsAtIndexPaths(diff.deletions.map { NSIndexPath(forItem: $0, inSection: section) })
+                    self.collectionView!.insertItemsAtIndexPaths(diff.insertions.map { NSIndexPath(forItem: $0, inSection: section) })
+                    for move in diff.moves {
+                        self.collectionView!.moveItemAtIndexPath(NSIndexPath(forItem: move.from, inSection: section), toIndexPath: NSIndexPath(forItem: move.to, inSection: section))
+                    }
+                }
+            }, completion: nil)
+        }
+
+        // A refresh from the API replaces the User instances even when they are the same friends,
+        // so the visible headers always need to point at the current ones.
+        reconfigureVisibleHeaderViews()
+    }
+
+    // Update the favorite counts, users and message callbacks of the visible headers.
+    private func reconfigureVisibleHeaderViews() {
+        for indexPath in collectionView!.indexPathsForVisibleSupplementaryElementsOfKind(UICollectionElementKindSectionHeader) {
+            if let headerView = collectionView!.supplementaryViewForElementKind(UICollectionElementKindSectionHeader, atIndexPath: indexPath) as? FriendHeaderView {
+                configureHeaderView(headerView, inSection: indexPath.section)
+            }
+        }
+    }
+
     // MARK: API
 
     // We need to upload the contacts before this.
@@ -215,15 +296,20 @@ class FavoritesCollectionViewController: UICollectionViewController, UICollectio
         AccountManager.defaultAccountManager.authenticatedAPI?.friends() { friends in
             // Add the logged in user as the first account to display.
             let loggedUser = AccountManager.defaultAccountManager.user!
-            self.friends = [loggedUser]
+            var users = [loggedUser]
 
             // For this demo app, only append friends once the Address Book has been uploaded.
             // if CNContactStore.authorizationStatusForEntityType(.Contacts) == .Authorized {
             if AccountManager.defaultAccountManager.hasUploadedContacts {
-                self.friends.appendContentsOf(friends ?? [])
+                users.appendContentsOf(friends ?? [])
             }
 
-            self.refreshControl!.endRefreshing()
+            // Format the prices in the background, then update the collection view once for the whole list.
+            ProductViewModelCache.sharedCache.prepareViewModelsForProducts(users.flatMap { $0.favorites.products }) {
+                self.friends = users
+
+                self.refreshControl!.endRefreshing()
+            }
         }
     }
 }
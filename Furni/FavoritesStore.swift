@@ -0,0 +1,161 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+// The favorite products of a user, in display order, indexed by product ID.
+// Changes made during a run loop turn are posted as a single notification and then written to disk in the background.
+final class FavoritesStore {
+    static let favoritesChangedNotificationName = "xyz.furni.favorites.changed.notification"
+
+    // Keys of the notification user info, each containing an array of product IDs.
+    static let insertedProductIDsKey = "insertedProductIDs"
+    static let removedProductIDsKey = "removedProductIDs"
+
+    private(set) var products: [Product] = []
+    private var indexesByProductID: [Int : Int] = [:]
+
+    private let persistentStore: WriteBehindStore?
+
+    private var pendingInsertedProductIDs = Set<Int>()
+    private var pendingRemovedProductIDs = Set<Int>()
+    private var isFlushScheduled = false
+
+    // Create a store, restoring the favorites previously saved at the given URL if any.
+    init(products: [Product] = [], persistenceURL: NSURL? = nil) {
+        persistentStore = persistenceURL.map(WriteBehindStore.init)
+
+        if let persistentStore = persistentStore where products.isEmpty {
+            replaceProducts(persistentStore.load().map { Product(dictionary: $0, collectionPermalink: ($0["collection"] as? String) ?? "") }, notify: false)
+        } else {
+            replaceProducts(products, notify: false)
+        }
+    }
+
+    var count: Int {
+        return products.count
+    }
+
+    var isEmpty: Bool {
+        return products.isEmpty
+    }
+
+    subscript(index: Int) -> Product {
+        return products[index]
+    }
+
+    func containsProductWithID(productID: Int) -> Bool {
+        return indexesByProductID[productID] != nil
+    }
+
+    func addProduct(product: Product) {
+        guard indexesByProductID[product.id] == nil else { return }
+
+        indexesByProductID[product.id] = products.count
+        products.append(product)
+
+        recordChangeOfProductWithID(product.id, inserted: true)
+    }
+
+    func removeProductWithID(productID: Int) {
+        guard let index = indexesByProductID.removeValueForKey(productID) else { return }
+
+        products.removeAtIndex(index)
+        for shiftedIndex in index..<products.count {
+            indexesByProductID[products[shiftedIndex].id] = shiftedIndex
+        }
+
+        recordChangeOfProductWithID(productID, inserted: false)
+    }
+
+    // Replace all the favorites, e.g. with the ones fetched from the API.
+    func replaceProducts(products: [Product]) {
+        replaceProducts(products, notify: true)
+    }
+
+    // Forget all the favorites, including the saved copy.
+    func removeAll() {
+        replaceProducts([])
+    }
+
+    // MARK: Private
+
+    private func replaceProducts(newProducts: [Product], notify: Bool) {
+        let oldProductIDs = Set(indexesByProductID.keys)
+
+        products = []
+        products.reserveCapacity(newProducts.count)
+        indexesByProductID = [:]
+
+        for product in newProducts where indexesByProductID[product.id] == nil {
+            indexesByProductID[product.id] = products.count
+            products.append(product)
+        }
+
+        guard notify else { return }
+
+        let newProductIDs = Set(indexesByProductID.keys)
+        for productID in newProductIDs.subtract(oldProductIDs) {
+            recordChangeOfProductWithID(productID, inserted: true)
+        }
+        for productID in oldProductIDs.subtract(newProductIDs) {
+            recordChangeOfProductWithID(productID, inserted: false)
+        }
+
+        // A new order is a change too, even if the same products are favorited.
+        scheduleFlush()
+    }
+
+    private func recordChangeOfProductWithID(productID: Int, inserted: Bool) {
+        if inserted {
+            if pendingRemovedProductIDs.remove(productID) == nil {
+                pendingInsertedProductIDs.insert(productID)
+            }
+        } else {
+            if pendingInsertedProductIDs.remove(productID) == nil {
+                pendingRemovedProductIDs.insert(productID)
+            }
+        }
+
+        scheduleFlush()
+    }
+
+    private func scheduleFlush() {
+        guard !isFlushScheduled else { return }
+        isFlushScheduled = true
+
+        dispatch_async(dispatch_get_main_queue()) {
+            self.flush()
+        }
+    }
+
+    private func flush() {
+        isFlushScheduled = false
+
+        let userInfo = [
+            FavoritesStore.insertedProductIDsKey: Array(pendingInsertedProductIDs),
+            FavoritesStore.removedProductIDsKey: Array(pendingRemovedProductIDs)
+        ]
+        pendingInsertedProductIDs.removeAll()
+        pendingRemovedProductIDs.removeAll()
+
+        NSNotificationCenter.defaultCenter().postNotificationName(FavoritesStore.favoritesChangedNotificationName, object: self, userInfo: userInfo)
+
+        persistentStore?.schedule {
+            self.products.map { $0.dictionaryRepresentation } as NSArray
+        }
+    }
+}
@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import UIKit
+
+// A summary of the frames rendered while a frame time monitor was running.
+struct FrameTimeReport: CustomStringConvertible {
+    let frameCount: Int
+    let droppedFrameCount: Int
+    let medianFrameDuration: CFTimeInterval
+    let slowFrameDuration: CFTimeInterval
+    let maximumFrameDuration: CFTimeInterval
+
+    // Summarize frame durations, counting the refreshes each frame missed given the display refresh interval.
+    init(frameDurations: [CFTimeInterval], refreshInterval: CFTimeInterval = 1.0 / 60.0) {
+        let sortedDurations = frameDurations.sort()
+        let percentile = { (fraction: Double) -> CFTimeInterval in
+            sortedDurations.isEmpty ? 0 : sortedDurations[min(sortedDurations.count - 1, Int(Double(sortedDurations.count) * fraction))]
+        }
+
+        frameCount = frameDurations.count
+        droppedFrameCount = frameDurations.reduce(0) { count, duration in
+            count + max(0, Int(round(duration / refreshInterval)) - 1)
+        }
+        medianFrameDuration = percentile(0.5)
+        slowFrameDuration = percentile(0.95)
+        maximumFrameDuration = sortedDurations.last ?? 0
+    }
+
+    var description: String {
+        return String(format: "%d frames, %d dropped, median %.1f ms, 95th percentile %.1f ms, max %.1f ms", frameCount, droppedFrameCount, medianFrameDuration * 1000, slowFrameDuration * 1000, maximumFrameDuration * 1000)
+    }
+}
+
+// Records the duration of every frame between start() and stop(), e.g. while scrolling rapidly through a collection.
+// Launch the app with the -FurniMeasureFrameTimes argument to log a report after each scroll of a product collection.
+final class FrameTimeMonitor {
+    static let isEnabled = NSProcessInfo.processInfo().arguments.contains("-FurniMeasureFrameTimes")
+
+    private var displayLink: CADisplayLink?
+    private var lastTimestamp: CFTimeInterval?
+    private var frameDurations: [CFTimeInterval] = []
+
+    var isRunning: Bool {
+        return displayLink != nil
+    }
+
+    func start() {
+        guard displayLink == nil else { return }
+
+        lastTimestamp = nil
+        frameDurations = []
+        frameDurations.reserveCapacity(600)
+
+        // The display link retains its target, so go through a proxy to avoid a cycle.
+        displayLink = CADisplayLink(target: FrameTimeMonitorDisplayLinkTarget(monitor: self), selector: Selector("displayLinkFired:"))
+        displayLink!.addToRunLoop(NSRunLoop.mainRunLoop(), forMode: NSRunLoopCommonModes)
+    }
+
+    func stop() -> FrameTimeReport {
+        displayLink?.invalidate()
+        displayLink = nil
+
+        return FrameTimeReport(frameDurations: frameDurations)
+    }
+
+    deinit {
+        displayLink?.invalidate()
+    }
+
+    private func recordFrameWithTimestamp(timestamp: CFTimeInterval) {
+        if let lastTimestamp = lastTimestamp {
+            frameDurations.append(timestamp - lastTimestamp)
+        }
+        lastTimestamp = timestamp
+    }
+}
+
+private final class FrameTimeMonitorDisplayLinkTarget: NSObject {
+    weak var monitor: FrameTimeMonitor?
+
+    init(monitor: FrameTimeMonitor) {
+        self.monitor = monitor
+    }
+
+    @objc func displayLinkFired(displayLink: CADisplayLink) {
+        monitor?.recordFrameWithTimestamp(displayLink.timestamp)
+    }
+}
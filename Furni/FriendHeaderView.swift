@@ -40,6 +40,9 @@ final class FriendHeaderView: UICollectionReusableView {
 
     var sendMessageCallback: (() -> ())!
 
+    // The user displayed, so that their image can be updated once it has loaded.
+    private var user: User?
+
     @IBAction func sendMessageButtonTapped(sender: UIButton) {
         self.sendMessageCallback()
     }
@@ -52,6 +55,12 @@ final class FriendHeaderView: UICollectionReusableView {
         // Draw a border layer at the top and bottom.
         self.drawTopBorderWithColor(UIColor.furniBrownColor(), height: 0.5)
         self.drawTopBorderWithColor(UIColor.furniBrownColor(), height: 0.5)
+
+        NSNotificationCenter.defaultCenter().addObserver(self, selector: Selector("userImageChangedNotificationReceived:"), name: User.imageChangedNotificationName, object: nil)
+    }
+
+    deinit {
+        NSNotificationCenter.defaultCenter().removeObserver(self)
     }
 
     override func layoutSubviews() {
@@ -63,8 +72,15 @@ final class FriendHeaderView: UICollectionReusableView {
     }
 
     func configureWithUser(user: User) {
+        self.user = user
         friendNameLabel.text = user.fullName
         friendImageView.image = user.image
         friendFavoriteCountLabel.text = "\(user.favorites.count) Favorites"
     }
+
+    @objc private func userImageChangedNotificationReceived(notification: NSNotification) {
+        guard let user = user where notification.object === user else { return }
+
+        friendImageView.image = user.image
+    }
 }
@@ -27,6 +27,9 @@ final class FurniAPI {
 
     private var cachedCollections: [Collection] = []
 
+    // Completions waiting for a collection request in flight, by permalink.
+    private var pendingCollectionCompletions: [String : [Collection -> Void]] = [:]
+
     func getCollectionList(completion: [Collection] -> Void) {
         if cachedCollections.count > 0 {
             completion(cachedCollections)
@@ -45,26 +48,43 @@ final class FurniAPI {
         }
     }
 
-    func getCollection(permalink: String, completion: Collection -> Void) {
+    func getCollection(permalink: String, priority: Float = NSURLSessionTaskPriorityDefault, completion: Collection -> Void) {
         let collection = self.cachedCollections.filter{ $0.permalink == permalink }.first
-        if collection?.products.count > 0 {
+        if collection?.catalog.count > 0 {
             completion(collection!)
         }
 
-        get("collections/" + permalink) { JSON in
+        // Share the request already in flight for this collection, e.g. a prefetch.
+        if pendingCollectionCompletions[permalink] != nil {
+            pendingCollectionCompletions[permalink]!.append(completion)
+            return
+        }
+        pendingCollectionCompletions[permalink] = [completion]
+
+        get("collections/" + permalink, priority: priority) { JSON in
+            let completions = self.pendingCollectionCompletions.removeValueForKey(permalink) ?? []
+
             if let result = JSON as? JSONObject {
                 let productArray = result["products"] as! [JSONObject]
-                for productDict in productArray {
-                    collection!.products.append(Product(dictionary: productDict, collectionPermalink: permalink))
-                }
-                completion(collection!)
+
+                // Replace the cached products rather than appending duplicates on every refresh.
+                collection!.catalog = ProductCatalog(dictionaries: productArray, collectionPermalink: permalink)
+                completions.forEach { $0(collection!) }
             }
         }
     }
 
+    // Load the products of a collection ahead of display, at low priority, unless they are already loaded or loading.
+    func prefetchCollection(permalink: String) {
+        guard let collection = self.cachedCollections.filter({ $0.permalink == permalink }).first
+            where collection.catalog.isEmpty && pendingCollectionCompletions[permalink] == nil else { return }
+
+        getCollection(permalink, priority: NSURLSessionTaskPriorityLow) { _ in }
+    }
+
     // Convenience method to perform a GET request on an API endpoint.
-    private func get(endpoint: String, completion: AnyObject? -> Void) {
-        request(endpoint, method: "GET", encoding: .JSON, parameters: nil, completion: completion)
+    private func get(endpoint: String, priority: Float = NSURLSessionTaskPriorityDefault, completion: AnyObject? -> Void) {
+        request(endpoint, method: "GET", encoding: .JSON, parameters: nil, priority: priority, completion: completion)
     }
 
     // Convenience method to perform a POST request on an API endpoint.
@@ -73,7 +93,7 @@ final class FurniAPI {
     }
 
     // Perform a request on an API endpoint using Alamofire.
-    private func request(endpoint: String, method: String, encoding: Alamofire.ParameterEncoding, parameters: [String: AnyObject]?, completion: AnyObject? -> Void) {
+    private func request(endpoint: String, method: String, encoding: Alamofire.ParameterEncoding, parameters: [String: AnyObject]?, priority: Float = NSURLSessionTaskPriorityDefault, completion: AnyObject? -> Void) {
         let URL = NSURL(string: apiBaseURL + endpoint)!
         let URLRequest = NSMutableURLRequest(URL: URL)
         URLRequest.HTTPMethod = method
@@ -81,7 +101,9 @@ final class FurniAPI {
         let request = encoding.encode(URLRequest, parameters: parameters).0
 
         print("Starting \(method) \(URL) (\(parameters ?? [:]))")
-        Alamofire.request(request).responseJSON { _, response, result in
+        let dataRequest = Alamofire.request(request)
+        dataRequest.task.priority = priority
+        dataRequest.responseJSON { _, response, result in
             print("Finished \(method) \(URL): \(response?.statusCode)")
             switch result {
             case .Success(let JSON):
@@ -171,7 +193,6 @@ final class AuthenticatedFurniAPI {
             "from": self.cognitoID,
             "to": digitsUserIDs
             ]) { response in
-                print("\(response as! NSDictionary)")
                 let success = response != nil
 
                 completion(success)
@@ -179,6 +200,9 @@ final class AuthenticatedFurniAPI {
     }
 
     func friends(completion: [User]? -> ()) {
+        // Build the contact index while the request is in flight, so matching the friends below is only lookups.
+        ContactIndex.sharedIndex.warmUp()
+
         FurniAPI.sharedInstance.get("friendships/\(self.cognitoID)") { response in
             guard let result = response as? JSONObject,
                 let friendsDictionaries = result["friends"] as? [JSONObject] else {
@@ -207,7 +231,7 @@ final class AuthenticatedFurniAPI {
 
                 for user in users {
                     let favoriteProducts = user.cognitoID.flatMap { productsByCognitoID[$0] } ?? []
-                    user.favorites = favoriteProducts
+                    user.favorites.replaceProducts(favoriteProducts)
                 }
 
                 completion(users)
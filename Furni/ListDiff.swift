@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import UIKit
+
+// The changes turning a list into another one, computed in O(n log n) time by matching the elements on a unique key.
+// As with batch updates, deleted and reloaded indexes refer to the old list and inserted indexes to the new one.
+struct ListDiff {
+    private(set) var deletions: [Int] = []
+    private(set) var insertions: [Int] = []
+    private(set) var moves: [(from: Int, to: Int)] = []
+    private(set) var reloads: [Int] = []
+
+    // Fails when keys are not unique, since the changes would then be ambiguous.
+    init?<Element, Key: Hashable>(from oldElements: [Element], to newElements: [Element], key: Element -> Key, isEqual: (Element, Element) -> Bool = { _, _ in true }) {
+        var oldIndexesByKey = [Key : Int](minimumCapacity: oldElements.count)
+        for (index, element) in oldElements.enumerate() {
+            guard oldIndexesByKey.updateValue(index, forKey: key(element)) == nil else { return nil }
+        }
+
+        var newIndexesByKey = [Key : Int](minimumCapacity: newElements.count)
+        for (index, element) in newElements.enumerate() {
+            guard newIndexesByKey.updateValue(index, forKey: key(element)) == nil else { return nil }
+        }
+
+        for (index, element) in oldElements.enumerate() where newIndexesByKey[key(element)] == nil {
+            deletions.append(index)
+        }
+
+        // The old and new index of each element in both lists, in the new order.
+        var keptOldIndexes: [Int] = []
+        var keptNewIndexes: [Int] = []
+        keptOldIndexes.reserveCapacity(newElements.count)
+        keptNewIndexes.reserveCapacity(newElements.count)
+        for (index, element) in newElements.enumerate() {
+            if let oldIndex = oldIndexesByKey[key(element)] {
+                keptOldIndexes.append(oldIndex)
+                keptNewIndexes.append(index)
+            } else {
+                insertions.append(index)
+            }
+        }
+
+        // The elements on a longest increasing subsequence of the old indexes keep their relative order, so they stay in
+        // place and the fewest possible elements are moved: moving one element reports one move.
+        let isInPlace = ListDiff.longestIncreasingSubsequence(keptOldIndexes)
+
+        for (position, (oldIndex, newIndex)) in zip(keptOldIndexes, keptNewIndexes).enumerate() {
+            let moved = !isInPlace[position]
+            let changed = !isEqual(oldElements[oldIndex], newElements[newIndex])
+
+            switch (moved, changed) {
+            case (true, false):
+                moves.append((from: oldIndex, to: newIndex))
+            case (true, true):
+                // A moved cell can't also be reloaded in the same batch, so replace it.
+                deletions.append(oldIndex)
+                insertions.append(newIndex)
+            case (false, true):
+                reloads.append(oldIndex)
+            case (false, false):
+                break
+            }
+        }
+    }
+
+    // Flags the values on one longest strictly increasing subsequence, found by patience sorting in O(n log n).
+    private static func longestIncreasingSubsequence(values: [Int]) -> [Bool] {
+        // The index of the smallest value ending an increasing subsequence of each length so far, and the value before each one.
+        var tailIndexes: [Int] = []
+        var predecessorIndexes = [Int](count: values.count, repeatedValue: -1)
+
+        for (index, value) in values.enumerate() {
+            var low = 0
+            var high = tailIndexes.count
+            while low < high {
+                let middle = (low + high) / 2
+                if values[tailIndexes[middle]] < value {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+
+            if low > 0 {
+                predecessorIndexes[index] = tailIndexes[low - 1]
+            }
+            if low == tailIndexes.count {
+                tailIndexes.append(index)
+            } else {
+                tailIndexes[low] = index
+            }
+        }
+
+        var isInSubsequence = [Bool](count: values.count, repeatedValue: false)
+        var index = tailIndexes.last ?? -1
+        while index >= 0 {
+            isInSubsequence[index] = true
+            index = predecessorIndexes[index]
+        }
+        return isInSubsequence
+    }
+
+    var isEmpty: Bool {
+        return deletions.isEmpty && insertions.isEmpty && moves.isEmpty && reloads.isEmpty
+    }
+
+    // The number of cells dequeued and configured when applying the changes.
+    var reconfiguredCount: Int {
+        return insertions.count + reloads.count
+    }
+}
+
+extension UICollectionView {
+    // Apply the changes to the items of a section with batch updates.
+    // Fall back to reloading everything when the changes are unknown or the view is not on screen.
+    func applyDiff(diff: ListDiff?, inSection section: Int = 0) {
+        guard let diff = diff where window != nil else {
+            reloadData()
+            return
+        }
+
+        guard !diff.isEmpty else { return }
+
+        let indexPaths = { (indexes: [Int]) -> [NSIndexPath] in indexes.map { NSIndexPath(forItem: $0, inSection: section) } }
+
+        performBatchUpdates({
+            self.deleteItemsAtIndexPaths(indexPaths(diff.deletions))
+            self.insertItemsAtIndexPaths(indexPaths(diff.insertions))
+            self.reloadItemsAtIndexPaths(indexPaths(diff.reloads))
+            for move in diff.moves {
+                self.moveItemAtIndexPath(NSIndexPath(forItem: move.from, inSection: section), toIndexPath: NSIndexPath(forItem: move.to, inSection: section))
+            }
+        }, completion: nil)
+    }
+}
+
+extension UITableView {
+    // Apply the changes to a list displayed as one section per element.
+    // Fall back to reloading everything when the changes are unknown or the view is not on screen.
+    func applySectionDiff(diff: ListDiff?, withRowAnimation animation: UITableViewRowAnimation = .Automatic) {
+        guard let diff = diff where window != nil else {
+            reloadData()
+            return
+        }
+
+        guard !diff.isEmpty else { return }
+
+        let indexSet = { (indexes: [Int]) -> NSIndexSet in
+            let indexSet = NSMutableIndexSet()
+            indexes.forEach { indexSet.addIndex($0) }
+            return indexSet
+        }
+
+        beginUpdates()
+        deleteSections(indexSet(diff.deletions), withRowAnimation: animation)
+        insertSections(indexSet(diff.insertions), withRowAnimation: animation)
+        reloadSections(indexSet(diff.reloads), withRowAnimation: animation)
+        for move in diff.moves {
+            moveSection(move.from, toSection: move.to)
+        }
+        endUpdates()
+    }
+}
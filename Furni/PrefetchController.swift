@@ -0,0 +1,188 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import UIKit
+import Alamofire
+import AlamofireImage
+
+// Watches the scrolling of a list and asks to warm the items about to appear.
+// Items are identified by their index in the list, e.g. the item of a collection view or the section of a table view.
+final class PrefetchController {
+    enum ScrollDirection {
+        case Forward
+        case Backward
+    }
+
+    // The number of items warmed ahead of the visible ones. It doubles when scrolling fast.
+    var prefetchDistance: Int
+
+    // The velocity, in points per second, above which scrolling is considered fast.
+    var fastScrollVelocity: CGFloat = 2000
+
+    private(set) var direction: ScrollDirection?
+
+    private let axis: UILayoutConstraintAxis
+    private let prefetchHandler: [Int] -> ()
+    private let cancelHandler: [Int] -> ()
+
+    private var lastOffset: CGFloat?
+    private var lastTimestamp: CFTimeInterval = 0
+    private var prefetchedIndexes = Set<Int>()
+
+    init(axis: UILayoutConstraintAxis, prefetchDistance: Int, prefetch: [Int] -> (), cancel: [Int] -> () = { _ in }) {
+        self.axis = axis
+        self.prefetchDistance = prefetchDistance
+        self.prefetchHandler = prefetch
+        self.cancelHandler = cancel
+    }
+
+    // Call on every scroll with the indexes of the visible items and the total number of items.
+    func scrollViewDidScroll(scrollView: UIScrollView, visibleIndexes: [Int], itemCount: Int) {
+        let offset = axis == .Vertical ? scrollView.contentOffset.y : scrollView.contentOffset.x
+        let timestamp = CACurrentMediaTime()
+        let previousOffset = lastOffset
+        let previousTimestamp = lastTimestamp
+        lastOffset = offset
+        lastTimestamp = timestamp
+
+        guard let lastOffset = previousOffset where offset != lastOffset else { return }
+        guard let firstVisibleIndex = visibleIndexes.minElement(), lastVisibleIndex = visibleIndexes.maxElement() else { return }
+
+        let newDirection: ScrollDirection = offset > lastOffset ? .Forward : .Backward
+        let velocity = abs(offset - lastOffset) / CGFloat(max(timestamp - previousTimestamp, 0.001))
+
+        // The user turned around: the items warmed in the other direction are not needed anymore.
+        if let direction = direction where direction != newDirection {
+            let staleIndexes = prefetchedIndexes.subtract(visibleIndexes)
+            if !staleIndexes.isEmpty {
+                cancelHandler(Array(staleIndexes))
+            }
+            prefetchedIndexes.removeAll()
+        }
+        direction = newDirection
+
+        let distance = velocity > fastScrollVelocity ? prefetchDistance * 2 : prefetchDistance
+        let candidateIndexes: [Int]
+        switch newDirection {
+        case .Forward:
+            // The visible indexes can outlive a shrinking item count until the next reload.
+            let startIndex = lastVisibleIndex + 1
+            let endIndex = min(itemCount, startIndex + distance)
+            candidateIndexes = startIndex < endIndex ? Array(startIndex..<endIndex) : []
+        case .Backward:
+            let endIndex = min(itemCount, firstVisibleIndex)
+            candidateIndexes = Array((max(0, endIndex - distance)..<endIndex).reverse())
+        }
+
+        let indexes = candidateIndexes.filter { !prefetchedIndexes.contains($0) }
+        guard !indexes.isEmpty else { return }
+
+        prefetchedIndexes.unionInPlace(indexes)
+        prefetchHandler(indexes)
+    }
+
+    // Forget what was warmed, e.g. when the items were replaced.
+    func reset() {
+        lastOffset = nil
+        direction = nil
+        prefetchedIndexes.removeAll()
+    }
+}
+
+// Downloads images ahead of display, at low priority and on its own download queue,
+// into the image cache used by the image views. Only use it from the main thread.
+// Launch the app with the -FurniLogImagePrefetching argument to log its statistics when leaving a product collection.
+final class ImagePrefetcher {
+    static let sharedPrefetcher = ImagePrefetcher()
+    static let isLoggingEnabled = NSProcessInfo.processInfo().arguments.contains("-FurniLogImagePrefetching")
+
+    struct Statistics: CustomStringConvertible {
+        // Images downloaded by the prefetcher.
+        var prefetchedCount = 0
+        // Images displayed, prefetched or not.
+        var displayedCount = 0
+        // Images displayed after being prefetched.
+        var hitCount = 0
+        // Images displayed while their prefetch was still in flight.
+        var lateCount = 0
+
+        var hitRate: Double {
+            return displayedCount > 0 ? Double(hitCount) / Double(displayedCount) : 0
+        }
+
+        var description: String {
+            return String(format: "%d prefetched, %d displayed, %.0f%% hits, %d late", prefetchedCount, displayedCount, hitRate * 100, lateCount)
+        }
+    }
+
+    private(set) var statistics = Statistics()
+
+    private let downloader: ImageDownloader
+    private var requestsByURL: [NSURL : Request] = [:]
+    private var prefetchedURLs = Set<NSURL>()
+
+    init(imageCache: ImageRequestCache? = UIImageView.af_sharedImageDownloader.imageCache) {
+        // Keep the disk cache to the image views' downloader, the prefetched images go to the shared memory cache.
+        let configuration = ImageDownloader.defaultURLSessionConfiguration()
+        configuration.URLCache = nil
+
+        downloader = ImageDownloader(configuration: configuration, downloadPrioritization: .LIFO, maximumActiveDownloads: 2, imageCache: imageCache)
+    }
+
+    // Use the filter of the image view that will display the image, since the cache stores filtered images.
+    func prefetchImageWithURL(URL: NSURL, filter: ImageFilter?) {
+        guard requestsByURL[URL] == nil && !prefetchedURLs.contains(URL) else { return }
+
+        let URLRequest = NSMutableURLRequest(URL: URL)
+        URLRequest.addValue("image/*", forHTTPHeaderField: "Accept")
+
+        let request = downloader.downloadImage(URLRequest: URLRequest, filter: filter) { [weak self] _, response, result in
+            guard let strongSelf = self else { return }
+
+            strongSelf.requestsByURL.removeValueForKey(URL)
+
+            // Images already in the cache come back without a response and don't count as prefetched.
+            if result.isSuccess && response != nil {
+                strongSelf.prefetchedURLs.insert(URL)
+                strongSelf.statistics.prefetchedCount += 1
+            }
+        }
+
+        if let request = request {
+            request.task.priority = NSURLSessionTaskPriorityLow
+            requestsByURL[URL] = request
+        }
+    }
+
+    func cancelPrefetchingImageWithURL(URL: NSURL) {
+        requestsByURL.removeValueForKey(URL)?.cancel()
+    }
+
+    // Call when an image view starts loading an image, to measure how many images were prefetched in time.
+    func recordDisplayOfImageWithURL(URL: NSURL) {
+        statistics.displayedCount += 1
+
+        if prefetchedURLs.remove(URL) != nil {
+            statistics.hitCount += 1
+        } else if requestsByURL[URL] != nil {
+            statistics.lateCount += 1
+        }
+    }
+
+    func resetStatistics() {
+        statistics = Statistics()
+    }
+}
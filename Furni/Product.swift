@@ -65,3 +65,20 @@ class Product {
         imageURL = imageURLComponents.URL!
     }
 }
+
+extension Product {
+    // A dictionary that can be saved as a property list and read back with `init(dictionary:collectionPermalink:)`.
+    var dictionaryRepresentation: [String : AnyObject] {
+        return [
+            "id": id,
+            "collection": collectionPermalink,
+            "name": name,
+            "description": description,
+            "price": "\(price)",
+            "retail_price": "\(retailPrice)",
+            "percentoff": percentOff,
+            "url": productURL.absoluteString,
+            "image_url": imageURL.absoluteString
+        ]
+    }
+}
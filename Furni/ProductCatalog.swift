@@ -0,0 +1,297 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+// An immutable list of products stored column by column.
+// Names, descriptions and permalinks are interned in a string table and URLs are kept as strings in a URL table,
+// so a large collection is a handful of arrays rather than thousands of objects. Sorting and filtering work on the columns.
+final class ProductCatalog: CollectionType {
+    static let emptyCatalog = ProductCatalog(builder: ProductCatalogBuilder())
+
+    let ids: [Int]
+    let prices: [Float]
+    let retailPrices: [Float]
+    let percentOffs: [Int32]
+
+    private let nameIndexes: [Int32]
+    private let descriptionIndexes: [Int32]
+    private let collectionPermalinkIndexes: [Int32]
+    private let currencyIndexes: [Int32]
+    private let productURLIndexes: [Int32]
+    private let imageURLIndexes: [Int32]
+
+    private let strings: [String]
+    private let URLStrings: [String]
+
+    // Product objects handed out to the views, created on first access. Only access them from the main thread.
+    private var materializedProducts: [Int : Product] = [:]
+
+    private init(builder: ProductCatalogBuilder) {
+        ids = builder.ids
+        prices = builder.prices
+        retailPrices = builder.retailPrices
+        percentOffs = builder.percentOffs
+        nameIndexes = builder.nameIndexes
+        descriptionIndexes = builder.descriptionIndexes
+        collectionPermalinkIndexes = builder.collectionPermalinkIndexes
+        currencyIndexes = builder.currencyIndexes
+        productURLIndexes = builder.productURLIndexes
+        imageURLIndexes = builder.imageURLIndexes
+        strings = builder.strings.values
+        URLStrings = builder.URLStrings.values
+    }
+
+    // Build a catalog from the product dictionaries of the API.
+    convenience init(dictionaries: [[String : AnyObject]], collectionPermalink permalink: String) {
+        var builder = ProductCatalogBuilder()
+        builder.reserveCapacity(dictionaries.count)
+        for dictionary in dictionaries {
+            builder.appendProductWithDictionary(dictionary, collectionPermalink: permalink)
+        }
+        self.init(builder: builder)
+    }
+
+    convenience init(products: [Product]) {
+        var builder = ProductCatalogBuilder()
+        builder.reserveCapacity(products.count)
+        for product in products {
+            builder.appendProduct(product)
+        }
+        self.init(builder: builder)
+    }
+
+    // MARK: CollectionType
+
+    var startIndex: Int {
+        return 0
+    }
+
+    var endIndex: Int {
+        return ids.count
+    }
+
+    subscript(index: Int) -> CatalogProduct {
+        return CatalogProduct(catalog: self, index: index)
+    }
+
+    // MARK: Products
+
+    // The product object at an index, for the views and models that keep a reference on a product.
+    func productAtIndex(index: Int) -> Product {
+        if let product = materializedProducts[index] {
+            return product
+        }
+
+        let product = Product(id: ids[index], collectionPermalink: collectionPermalinkAtIndex(index), name: nameAtIndex(index), description: descriptionAtIndex(index), price: prices[index], retailPrice: retailPrices[index], percentOff: Int(percentOffs[index]), currency: currencyAtIndex(index), productURL: NSURL(string: productURLStringAtIndex(index))!, imageURL: NSURL(string: imageURLStringAtIndex(index))!)
+        materializedProducts[index] = product
+        return product
+    }
+
+    func nameAtIndex(index: Int) -> String {
+        return strings[Int(nameIndexes[index])]
+    }
+
+    func descriptionAtIndex(index: Int) -> String {
+        return strings[Int(descriptionIndexes[index])]
+    }
+
+    func collectionPermalinkAtIndex(index: Int) -> String {
+        return strings[Int(collectionPermalinkIndexes[index])]
+    }
+
+    func currencyAtIndex(index: Int) -> String {
+        return strings[Int(currencyIndexes[index])]
+    }
+
+    func productURLStringAtIndex(index: Int) -> String {
+        return URLStrings[Int(productURLIndexes[index])]
+    }
+
+    func imageURLStringAtIndex(index: Int) -> String {
+        return URLStrings[Int(imageURLIndexes[index])]
+    }
+
+    // MARK: Sorting and Filtering
+
+    func indexesSortedByPrice(ascending ascending: Bool = true) -> [Int] {
+        var indexes = Array(0..<count)
+        prices.withUnsafeBufferPointer { prices in
+            if ascending {
+                indexes.sortInPlace { prices[$0] < prices[$1] }
+            } else {
+                indexes.sortInPlace { prices[$0] > prices[$1] }
+            }
+        }
+        return indexes
+    }
+
+    func indexesOfProductsWithPriceFrom(minimumPrice: Float, to maximumPrice: Float) -> [Int] {
+        var indexes: [Int] = []
+        prices.withUnsafeBufferPointer { prices in
+            for index in 0..<prices.count where prices[index] >= minimumPrice && prices[index] <= maximumPrice {
+                indexes.append(index)
+            }
+        }
+        return indexes
+    }
+
+    func indexesOfDiscountedProducts() -> [Int] {
+        return (0..<count).filter { prices[$0] < retailPrices[$0] && percentOffs[$0] > 0 }
+    }
+
+    // Names are interned, so each distinct name is only searched once.
+    func indexesOfProductsWithNameContainingString(string: String) -> [Int] {
+        var matchesByStringIndex = [Bool?](count: strings.count, repeatedValue: nil)
+        return (0..<count).filter { index in
+            let stringIndex = Int(nameIndexes[index])
+            if let matches = matchesByStringIndex[stringIndex] {
+                return matches
+            }
+
+            let matches = strings[stringIndex].localizedCaseInsensitiveContainsString(string)
+            matchesByStringIndex[stringIndex] = matches
+            return matches
+        }
+    }
+}
+
+// A product in a catalog. It is only a reference on the catalog and an index, so it is cheap to create and copy.
+struct CatalogProduct {
+    let catalog: ProductCatalog
+    let index: Int
+
+    var id: Int {
+        return catalog.ids[index]
+    }
+
+    var name: String {
+        return catalog.nameAtIndex(index)
+    }
+
+    var price: Float {
+        return catalog.prices[index]
+    }
+
+    var retailPrice: Float {
+        return catalog.retailPrices[index]
+    }
+
+    var percentOff: Int {
+        return Int(catalog.percentOffs[index])
+    }
+
+    var imageURLString: String {
+        return catalog.imageURLStringAtIndex(index)
+    }
+
+    var imageURL: NSURL {
+        return NSURL(string: imageURLString)!
+    }
+
+    var product: Product {
+        return catalog.productAtIndex(index)
+    }
+}
+
+// MARK: Building
+
+// A table of distinct strings, each referenced by its position.
+private struct InternedStringTable {
+    private(set) var values: [String] = []
+    private var indexesByValue: [String : Int32] = [:]
+
+    mutating func indexOfString(string: String) -> Int32 {
+        if let index = indexesByValue[string] {
+            return index
+        }
+
+        let index = Int32(values.count)
+        values.append(string)
+        indexesByValue[string] = index
+        return index
+    }
+}
+
+private struct ProductCatalogBuilder {
+    var ids: [Int] = []
+    var prices: [Float] = []
+    var retailPrices: [Float] = []
+    var percentOffs: [Int32] = []
+    var nameIndexes: [Int32] = []
+    var descriptionIndexes: [Int32] = []
+    var collectionPermalinkIndexes: [Int32] = []
+    var currencyIndexes: [Int32] = []
+    var productURLIndexes: [Int32] = []
+    var imageURLIndexes: [Int32] = []
+    var strings = InternedStringTable()
+    var URLStrings = InternedStringTable()
+
+    mutating func reserveCapacity(capacity: Int) {
+        ids.reserveCapacity(capacity)
+        prices.reserveCapacity(capacity)
+        retailPrices.reserveCapacity(capacity)
+        percentOffs.reserveCapacity(capacity)
+        nameIndexes.reserveCapacity(capacity)
+        descriptionIndexes.reserveCapacity(capacity)
+        collectionPermalinkIndexes.reserveCapacity(capacity)
+        currencyIndexes.reserveCapacity(capacity)
+        productURLIndexes.reserveCapacity(capacity)
+        imageURLIndexes.reserveCapacity(capacity)
+    }
+
+    // Note: This mirrors the naive JSON parsing of `Product.init(dictionary:collectionPermalink:)`.
+    mutating func appendProductWithDictionary(dictionary: [String : AnyObject], collectionPermalink permalink: String) {
+        ids.append(dictionary["id"] as! Int)
+        prices.append((dictionary["price"] as! NSString).floatValue)
+        retailPrices.append((dictionary["retail_price"] as! NSString).floatValue)
+        percentOffs.append(Int32((dictionary["percentoff"] as? Int) ?? 0))
+        nameIndexes.append(strings.indexOfString((dictionary["name"] as! String).stringByTrimmingCharactersInSet(NSCharacterSet.whitespaceCharacterSet())))
+        descriptionIndexes.append(strings.indexOfString((dictionary["description"] as! String).stringByTrimmingCharactersInSet(NSCharacterSet.whitespaceCharacterSet())))
+        collectionPermalinkIndexes.append(strings.indexOfString(permalink))
+        currencyIndexes.append(strings.indexOfString("USD"))
+        productURLIndexes.append(URLStrings.indexOfString(dictionary["url"] as! String))
+        imageURLIndexes.append(URLStrings.indexOfString(HTTPSURLString(dictionary["image_url"] as! String)))
+    }
+
+    mutating func appendProduct(product: Product) {
+        ids.append(product.id)
+        prices.append(product.price)
+        retailPrices.append(product.retailPrice)
+        percentOffs.append(Int32(product.percentOff))
+        nameIndexes.append(strings.indexOfString(product.name))
+        descriptionIndexes.append(strings.indexOfString(product.description))
+        collectionPermalinkIndexes.append(strings.indexOfString(product.collectionPermalink))
+        currencyIndexes.append(strings.indexOfString(product.currency))
+        productURLIndexes.append(URLStrings.indexOfString(product.productURL.absoluteString))
+        imageURLIndexes.append(URLStrings.indexOfString(product.imageURL.absoluteString))
+    }
+}
+
+// Make sure an image URL is HTTPS, without going through NSURLComponents for the common case.
+private func HTTPSURLString(URLString: String) -> String {
+    if URLString.hasPrefix("https://") {
+        return URLString
+    }
+
+    if URLString.hasPrefix("http://") {
+        return "https://" + URLString.substringFromIndex(URLString.startIndex.advancedBy(7))
+    }
+
+    let URLComponents = NSURLComponents(string: URLString)!
+    URLComponents.scheme = "https"
+    return URLComponents.URL!.absoluteString
+}
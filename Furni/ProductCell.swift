@@ -45,6 +45,11 @@ final class ProductCell: UICollectionViewCell {
         }
     }
 
+    // The filter giving product images the aspect ratio of the cell. Prefetch images with it so that they are found in the cache.
+    var imageFilter: ImageFilter {
+        return AspectScaledToFillSizeFilter(size: imageView.bounds.size)
+    }
+
     // MARK: IBActions
 
     @IBAction private func favoriteButtonTapped(sender: AnyObject) {
@@ -83,15 +88,18 @@ final class ProductCell: UICollectionViewCell {
         // Keep a reference on the model.
         self.product = product
 
+        // Find the display values, usually prepared in the background when the products loaded.
+        let viewModel = ProductViewModelCache.sharedCache.viewModelForProduct(product)
+
         // Add the product name.
-        nameLabel.text = product.name
+        nameLabel.text = viewModel.name
 
         // Load the image from the network and give it the correct aspect ratio.
-        let size = CGSize(width: imageView.bounds.width, height: imageView.bounds.height)
+        ImagePrefetcher.sharedPrefetcher.recordDisplayOfImageWithURL(product.imageURL)
         imageView.af_setImageWithURL(
             product.imageURL,
             placeholderImage: UIImage(named: "Placeholder"),
-            filter: AspectScaledToFillSizeFilter(size: size),
+            filter: imageFilter,
             imageTransition: .CrossDissolve(0.6)
         )
 
@@ -99,14 +107,8 @@ final class ProductCell: UICollectionViewCell {
         favorited = product.isFavorited
 
         // Add the current and retail prices with their currency.
-        priceLabel.text = product.price.asCurrency
-        if product.price < product.retailPrice && product.percentOff > 0 {
-            let retailPriceString = String(product.retailPrice.asCurrency)
-            let attributedRetailPrice = NSMutableAttributedString(string: retailPriceString)
-            attributedRetailPrice.addAttribute(NSStrikethroughStyleAttributeName, value: 1, range: NSMakeRange(0, retailPriceString.characters.count))
-            attributedRetailPrice.addAttribute(NSStrikethroughColorAttributeName, value: UIColor.furniDarkGrayColor(), range: NSMakeRange(0, retailPriceString.characters.count))
-            retailPriceLabel.attributedText = attributedRetailPrice
-            percentOffLabel.text = "-\(product.percentOff)%"
-        }
+        priceLabel.text = viewModel.priceText
+        retailPriceLabel.attributedText = viewModel.retailPriceText
+        percentOffLabel.text = viewModel.percentOffText
     }
 }
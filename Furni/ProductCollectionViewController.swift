@@ -29,6 +29,21 @@ final class ProductCollectionViewController: UICollectionViewController {
 
     private var refreshControl: UIRefreshControl!
 
+    private lazy var frameTimeMonitor = FrameTimeMonitor()
+
+    // Warm the images of the products about to scroll into view.
+    private lazy var prefetchController: PrefetchController = PrefetchController(axis: .Vertical, prefetchDistance: 6, prefetch: { [unowned self] indexes in
+        guard let filter = (self.collectionView!.visibleCells().first as? ProductCell)?.imageFilter else { return }
+
+        for index in indexes {
+            ImagePrefetcher.sharedPrefetcher.prefetchImageWithURL(self.collection.catalog[index].imageURL, filter: filter)
+        }
+    }, cancel: { [unowned self] indexes in
+        for index in indexes where index < self.collection.catalog.count {
+            ImagePrefetcher.sharedPrefetcher.cancelPrefetchingImageWithURL(self.collection.catalog[index].imageURL)
+        }
+    })
+
     // MARK: View Life Cycle
 
     override func viewDidLoad() {
@@ -56,17 +71,26 @@ final class ProductCollectionViewController: UICollectionViewController {
         Crashlytics.sharedInstance().setObjectValue(collection.id, forKey: "Collection")
     }
 
+    override func viewDidDisappear(animated: Bool) {
+        super.viewDidDisappear(animated)
+
+        // Report how many of the displayed images were prefetched in time.
+        if ImagePrefetcher.isLoggingEnabled {
+            print("Image prefetching: \(ImagePrefetcher.sharedPrefetcher.statistics)")
+        }
+    }
+
     // MARK: UICollectionViewDataSource
 
     override func collectionView(collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
-        return collection.products.count
+        return collection.catalog.count
     }
 
     override func collectionView(collectionView: UICollectionView, cellForItemAtIndexPath indexPath: NSIndexPath) -> UICollectionViewCell {
         let cell = collectionView.dequeueReusableCellWithReuseIdentifier(ProductCell.reuseIdentifier, forIndexPath: indexPath) as! ProductCell
 
         // Find the corresponding product.
-        let product = collection.products[indexPath.row]
+        let product = collection.catalog.productAtIndex(indexPath.row)
 
         // Configure the cell with the product.
         cell.configureWithProduct(product)
@@ -103,6 +127,34 @@ final class ProductCollectionViewController: UICollectionViewController {
         return CGSize(width: width, height: width + 50)
     }
 
+    // MARK: UIScrollViewDelegate
+
+    override func scrollViewDidScroll(scrollView: UIScrollView) {
+        prefetchController.scrollViewDidScroll(scrollView, visibleIndexes: collectionView!.indexPathsForVisibleItems().map { $0.item }, itemCount: collection.catalog.count)
+    }
+
+    override func scrollViewWillBeginDragging(scrollView: UIScrollView) {
+        if FrameTimeMonitor.isEnabled {
+            frameTimeMonitor.start()
+        }
+    }
+
+    override func scrollViewDidEndDragging(scrollView: UIScrollView, willDecelerate decelerate: Bool) {
+        if !decelerate {
+            logFrameTimes()
+        }
+    }
+
+    override func scrollViewDidEndDecelerating(scrollView: UIScrollView) {
+        logFrameTimes()
+    }
+
+    private func logFrameTimes() {
+        guard frameTimeMonitor.isRunning else { return }
+
+        print("Scrolled \(collection.name): \(frameTimeMonitor.stop())")
+    }
+
     // MARK: UIStoryboardSegue Handling
 
     override func prepareForSegue(segue: UIStoryboardSegue, sender: AnyObject?) {
@@ -140,11 +192,14 @@ final class ProductCollectionViewController: UICollectionViewController {
     private func fetchCollectionProducts() {
         // Fetch products from the API.
         FurniAPI.sharedInstance.getCollection(collection.permalink) { collection in
-            // Save and reload the table.
-            self.collectionView!.reloadData()
+            // Format the prices in the background, then reload the table.
+            ProductViewModelCache.sharedCache.prepareViewModelsForProducts(collection.catalog) {
+                self.prefetchController.reset()
+                self.collectionView!.reloadData()
 
-            // Stop animating the refresh control.
-            self.refreshControl!.endRefreshing()
+                // Stop animating the refresh control.
+                self.refreshControl!.endRefreshing()
+            }
         }
     }
 }
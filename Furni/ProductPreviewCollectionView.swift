@@ -17,16 +17,27 @@
 import UIKit
 
 final class ProductPreviewCollectionView: UICollectionView, UICollectionViewDataSource {
-    private var products: [Product] = [] {
-        didSet {
-            self.reloadData()
+    private var catalog = ProductCatalog.emptyCatalog
+
+    // Warm the images of the products about to scroll into view.
+    private lazy var prefetchController: PrefetchController = PrefetchController(axis: .Horizontal, prefetchDistance: 4, prefetch: { [unowned self] indexes in
+        let filter = ProductPreviewCollectionViewCell.imageFilterForSize((self.collectionViewLayout as! UICollectionViewFlowLayout).itemSize)
+
+        for index in indexes {
+            ImagePrefetcher.sharedPrefetcher.prefetchImageWithURL(self.catalog[index].imageURL, filter: filter)
         }
-    }
+    }, cancel: { [unowned self] indexes in
+        for index in indexes where index < self.catalog.count {
+            ImagePrefetcher.sharedPrefetcher.cancelPrefetchingImageWithURL(self.catalog[index].imageURL)
+        }
+    })
 
     var collection: Collection? {
         didSet {
             if collection !== oldValue {
-                self.products = []
+                self.catalog = ProductCatalog.emptyCatalog
+                self.prefetchController.reset()
+                self.reloadData()
             }
         }
     }
@@ -45,25 +56,38 @@ final class ProductPreviewCollectionView: UICollectionView, UICollectionViewData
                 return
             }
 
-            self.products = collection.products
+            self.updateWithCatalog(collection.catalog)
         }
     }
 
+    // Only touch the cells of products that were added, removed, moved or edited.
+    private func updateWithCatalog(catalog: ProductCatalog) {
+        let diff = ListDiff(from: Array(self.catalog), to: Array(catalog), key: { $0.id }) {
+            $0.name == $1.name && $0.price == $1.price && $0.imageURLString == $1.imageURLString
+        }
+
+        self.catalog = catalog
+        self.applyDiff(diff)
+    }
+
     override func layoutSubviews() {
         super.layoutSubviews()
 
         let layout = self.collectionViewLayout as! UICollectionViewFlowLayout
         layout.itemSize = CGSize(width: self.bounds.height, height: self.bounds.height)
+
+        // Scroll views lay out their subviews on every scroll.
+        prefetchController.scrollViewDidScroll(self, visibleIndexes: indexPathsForVisibleItems().map { $0.item }, itemCount: catalog.count)
     }
 
     func collectionView(collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
-        return self.products.count
+        return self.catalog.count
     }
 
     func collectionView(collectionView: UICollectionView, cellForItemAtIndexPath indexPath: NSIndexPath) -> UICollectionViewCell {
         let cell = collectionView.dequeueReusableCellWithReuseIdentifier(ProductPreviewCollectionViewCell.reuseIdentifier, forIndexPath: indexPath) as! ProductPreviewCollectionViewCell
 
-        cell.configureWithProduct(self.products[indexPath.row])
+        cell.configureWithProduct(self.catalog.productAtIndex(indexPath.row))
 
         return cell
     }
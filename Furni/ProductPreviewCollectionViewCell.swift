@@ -21,6 +21,11 @@ final class ProductPreviewCollectionViewCell: UICollectionViewCell {
 
     static let reuseIdentifier = "ProductPreviewCollectionViewCell"
 
+    // The filter giving product images the aspect ratio of a cell. Prefetch images with it so that they are found in the cache.
+    static func imageFilterForSize(size: CGSize) -> ImageFilter {
+        return AspectScaledToFitSizeFilter(size: size)
+    }
+
     // MARK: Properties
 
     var product: Product!
@@ -41,11 +46,11 @@ final class ProductPreviewCollectionViewCell: UICollectionViewCell {
         self.product = product
         
         // Load the image from the network and give it the correct aspect ratio.
-        let size = CGSize(width: self.bounds.width, height: self.bounds.height)
+        ImagePrefetcher.sharedPrefetcher.recordDisplayOfImageWithURL(product.imageURL)
         imageView.af_setImageWithURL(
             product.imageURL,
             placeholderImage: UIImage(named: "Placeholder"),
-            filter: AspectScaledToFitSizeFilter(size: size),
+            filter: ProductPreviewCollectionViewCell.imageFilterForSize(self.bounds.size),
             imageTransition: .CrossDissolve(0.6)
         )
     }
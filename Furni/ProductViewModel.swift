@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import UIKit
+
+// The values of a product displayed by a product cell, whether it is a product object or a catalog product.
+protocol ProductCellValues {
+    var id: Int { get }
+    var name: String { get }
+    var price: Float { get }
+    var retailPrice: Float { get }
+    var percentOff: Int { get }
+}
+
+extension Product: ProductCellValues {}
+
+extension CatalogProduct: ProductCellValues {}
+
+// The display values of a product cell, computed ahead of time so that configuring a cell only assigns them.
+struct ProductViewModel {
+    let name: String
+    let priceText: String
+    let retailPriceText: NSAttributedString?
+    let percentOffText: String?
+
+    // The values the view model was built from, to detect products updated by the API.
+    private let price: Float
+    private let retailPrice: Float
+    private let percentOff: Int
+
+    init<P: ProductCellValues>(product: P) {
+        name = product.name
+        priceText = product.price.asCurrency
+        price = product.price
+        retailPrice = product.retailPrice
+        percentOff = product.percentOff
+
+        // Strike through the retail price when the product is discounted.
+        if product.price < product.retailPrice && product.percentOff > 0 {
+            let retailPriceString = product.retailPrice.asCurrency
+            let range = NSMakeRange(0, (retailPriceString as NSString).length)
+            let attributedRetailPrice = NSMutableAttributedString(string: retailPriceString)
+            attributedRetailPrice.addAttribute(NSStrikethroughStyleAttributeName, value: 1, range: range)
+            attributedRetailPrice.addAttribute(NSStrikethroughColorAttributeName, value: UIColor.furniDarkGrayColor(), range: range)
+            retailPriceText = attributedRetailPrice
+            percentOffText = "-\(product.percentOff)%"
+        } else {
+            retailPriceText = nil
+            percentOffText = nil
+        }
+    }
+
+    private func isUpToDateWithProduct<P: ProductCellValues>(product: P) -> Bool {
+        return name == product.name && price == product.price && retailPrice == product.retailPrice && percentOff == product.percentOff
+    }
+}
+
+// Builds product view models on a background queue and keeps them by product ID.
+final class ProductViewModelCache {
+    static let sharedCache = ProductViewModelCache()
+
+    // Reads are synchronous, writes are barriers.
+    private let queue = dispatch_queue_create("xyz.furni.product-view-models", DISPATCH_QUEUE_CONCURRENT)
+    private var viewModelsByProductID: [Int : ProductViewModel] = [:]
+
+    // Build the view models of products, e.g. when a collection loads, and call back on the main queue once they are ready.
+    func prepareViewModelsForProducts<S: SequenceType where S.Generator.Element: ProductCellValues>(products: S, completion: (() -> ())? = nil) {
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0)) {
+            let viewModels = products.filter { self.cachedViewModelForProduct($0) == nil }.map { ($0.id, ProductViewModel(product: $0)) }
+
+            dispatch_barrier_async(self.queue) {
+                for (productID, viewModel) in viewModels {
+                    self.viewModelsByProductID[productID] = viewModel
+                }
+
+                if let completion = completion {
+                    dispatch_async(dispatch_get_main_queue(), completion)
+                }
+            }
+        }
+    }
+
+    // Return the view model of a product, building it right away if it was not prepared.
+    func viewModelForProduct<P: ProductCellValues>(product: P) -> ProductViewModel {
+        if let viewModel = cachedViewModelForProduct(product) {
+            return viewModel
+        }
+
+        let viewModel = ProductViewModel(product: product)
+        dispatch_barrier_async(queue) {
+            self.viewModelsByProductID[product.id] = viewModel
+        }
+        return viewModel
+    }
+
+    // MARK: Private
+
+    private func cachedViewModelForProduct<P: ProductCellValues>(product: P) -> ProductViewModel? {
+        var viewModel: ProductViewModel?
+        dispatch_sync(queue) {
+            viewModel = self.viewModelsByProductID[product.id]
+        }
+
+        guard let cachedViewModel = viewModel where cachedViewModel.isUpToDateWithProduct(product) else { return nil }
+        return cachedViewModel
+    }
+}
@@ -34,6 +34,13 @@ final class StoreViewController: UIViewController, UITableViewDelegate {
 
     private lazy var refreshControl = UIRefreshControl()
 
+    // Load the products of the collections about to scroll into view, so the rich layout can show them right away.
+    private lazy var prefetchController: PrefetchController = PrefetchController(axis: .Vertical, prefetchDistance: 2, prefetch: { [unowned self] indexes in
+        for index in indexes {
+            FurniAPI.sharedInstance.prefetchCollection(self.collections[index].permalink)
+        }
+    })
+
     private let collectionTableViewDataSource = CollectionTableViewDataSource<CollectionCell>()
     private let collectionPreviewTableViewDataSource = CollectionTableViewDataSource<CollectionPreviewCell>()
 
@@ -46,6 +53,11 @@ final class StoreViewController: UIViewController, UITableViewDelegate {
 
     private var storeLayout: StoreLayout = .Basic {
         didSet {
+            // Scrolls are only tracked in the rich layout, so start over whenever it is switched in or out.
+            if storeLayout != oldValue {
+                prefetchController.reset()
+            }
+
             switch storeLayout {
             case .Basic: self.dataSource = collectionTableViewDataSource
             case .Rich: self.dataSource = collectionPreviewTableViewDataSource
@@ -57,7 +69,12 @@ final class StoreViewController: UIViewController, UITableViewDelegate {
         didSet {
             collectionTableViewDataSource.collections = collections
             collectionPreviewTableViewDataSource.collections = collections
-            tableView.reloadData()
+
+            // Only touch the sections of collections that were added, removed, moved or edited.
+            let diff = ListDiff(from: oldValue, to: collections, key: { $0.id }) {
+                $0.name == $1.name && $0.tagline == $1.tagline && $0.imageURL == $1.imageURL
+            }
+            tableView.applySectionDiff(diff)
         }
     }
 
@@ -85,6 +102,16 @@ final class StoreViewController: UIViewController, UITableViewDelegate {
         )
     }
 
+    // MARK: UIScrollViewDelegate
+
+    func scrollViewDidScroll(scrollView: UIScrollView) {
+        // Only the rich layout shows products, so the basic layout has nothing to prefetch.
+        guard storeLayout == .Rich else { return }
+
+        // Each collection is a table view section.
+        prefetchController.scrollViewDidScroll(scrollView, visibleIndexes: tableView.indexPathsForVisibleRows?.map { $0.section } ?? [], itemCount: collections.count)
+    }
+
     // MARK: UITableViewDelegate
 
     func tableView(tableView: UITableView, heightForRowAtIndexPath indexPath: NSIndexPath) -> CGFloat {
@@ -159,9 +186,8 @@ final class StoreViewController: UIViewController, UITableViewDelegate {
     func fetchCollections() {
         // Fetch collections from the API.
         FurniAPI.sharedInstance.getCollectionList { collections in
-            // Sort collections by most recent first and reload the table.
+            // Sort collections by most recent first and update the table.
             self.collections = collections.sort { $0.date!.compare($1.date!) == .OrderedDescending }
-            self.tableView.reloadData()
 
             // Stop animating the refresh control.
             self.refreshControl.endRefreshing()
@@ -19,6 +19,9 @@ import UIKit
 import Contacts
 
 class User {
+    // Posted on the main thread when the image of the matching local contact has been loaded.
+    static let imageChangedNotificationName = "xyz.furni.user.image.notification"
+
     var cognitoID: String?
     var twitterUserID: String?
     var twitterUsername: String?
@@ -26,60 +29,74 @@ class User {
     var digitsPhoneNumber: String?
 
     var fullName: String? = "Romain Huet"
-    var image: UIImage? = UIImage(named: "Romain")!
     var postalAddress: CNPostalAddress?
 
-    var favorites: [Product] = []
-
-    // Enrich the user by fetching information from the local contact by phone number.
-    func populateWithLocalContact() {
-        guard let digitsPhoneNumber = digitsPhoneNumber else { return }
-
-        guard CNContactStore.authorizationStatusForEntityType(.Contacts) == .Authorized else { return }
-
-        let store = CNContactStore()
-        let fetchRequest = CNContactFetchRequest(keysToFetch: [CNContactPhoneNumbersKey, CNContactFormatter.descriptorForRequiredKeysForStyle(.FullName), CNContactPostalAddressesKey, CNContactImageDataKey])
+    // The image of the matching local contact is only fetched the first time it is needed, in the background.
+    // Until it arrives this is the previous image, and imageChangedNotificationName is posted once it is set.
+    var image: UIImage? {
+        get {
+            if let contactIndex = contactIndex, contactIdentifier = contactIdentifier where !hasLoadedContactImage {
+                if let thumbnail = contactIndex.cachedThumbnailForContactWithIdentifier(contactIdentifier) {
+                    contactImage = thumbnail
+                    hasLoadedContactImage = true
+                } else if !isLoadingContactImage {
+                    isLoadingContactImage = true
+                    contactIndex.loadThumbnailForContactWithIdentifier(contactIdentifier) { thumbnail in
+                        self.isLoadingContactImage = false
 
-        do {
-            try store.enumerateContactsWithFetchRequest(fetchRequest) { (contact, stop) in
-                let matchingPhoneNumbers = contact.phoneNumbers.map { $0.value as! CNPhoneNumber }.filter {
-                    phoneNumber($0, matchesPhoneNumberString: digitsPhoneNumber)
-                }
+                        // The user may have been matched with another contact in the meantime.
+                        guard self.contactIdentifier == contactIdentifier && !self.hasLoadedContactImage else { return }
 
-                guard matchingPhoneNumbers.count > 0 else {
-                    return
+                        self.contactImage = thumbnail
+                        self.hasLoadedContactImage = true
+                        NSNotificationCenter.defaultCenter().postNotificationName(User.imageChangedNotificationName, object: self)
+                    }
                 }
-
-                self.fullName = CNContactFormatter.stringFromContact(contact, style: .FullName)
-                self.image = contact.imageData.flatMap(UIImage.init)
-                self.postalAddress = contact.postalAddresses.map { $0.value as! CNPostalAddress }.first
-
-                stop.memory = true
             }
+
+            return contactImage
         }
-        catch let error as NSError {
-            print("Error looking for contact: \(error)")
+        set {
+            contactImage = newValue
+            hasLoadedContactImage = true
         }
     }
-}
 
-private func phoneNumber(phoneNumber: CNPhoneNumber, matchesPhoneNumberString phoneNumberString: String) -> Bool {
-    return phoneNumberString.rangeOfString(phoneNumber.stringValue.stringByRemovingOccurrencesOfCharacters(" )(- ")) != nil
+    var favorites = FavoritesStore()
+
+    private var contactIndex: ContactIndex?
+    private var contactIdentifier: String?
+    private var contactImage: UIImage? = UIImage(named: "Romain")!
+    private var hasLoadedContactImage = true
+    private var isLoadingContactImage = false
+
+    // Enrich the user with information from the local contact matching their phone number.
+    func populateWithLocalContact(contactIndex: ContactIndex = ContactIndex.sharedIndex) {
+        guard let digitsPhoneNumber = digitsPhoneNumber else { return }
+
+        guard let contact = contactIndex.contactMatchingPhoneNumber(digitsPhoneNumber) else { return }
+
+        self.fullName = contact.fullName
+        self.postalAddress = contact.postalAddress
+        self.contactIndex = contactIndex
+        self.contactIdentifier = contact.identifier
+        self.hasLoadedContactImage = false
+    }
 }
 
-// Note: This is a naive implementation that relies on global state. Avoid this in a production app.
+// Note: This relies on global state. Avoid this in a production app.
 extension Product {
     var isFavorited: Bool {
         get {
-            return AccountManager.defaultAccountManager.user?.favorites.contains { $0.id == self.id } ?? false
+            return AccountManager.defaultAccountManager.user?.favorites.containsProductWithID(self.id) ?? false
         }
         set {
             guard let user = AccountManager.defaultAccountManager.user else { return }
 
             if newValue {
-                user.favorites.append(self)
+                user.favorites.addProduct(self)
             } else {
-                user.favorites = user.favorites.filter { $0.id != self.id }
+                user.favorites.removeProductWithID(self.id)
             }
         }
     }
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+// Keeps a property list snapshot of an in-memory store on disk.
+// Snapshots scheduled during a run loop turn are coalesced: the last one is taken once and written in the background.
+// Only use it from the main thread.
+final class WriteBehindStore {
+    private static let queue = dispatch_queue_create("xyz.furni.write-behind", DISPATCH_QUEUE_SERIAL)
+
+    let fileURL: NSURL
+
+    private var pendingSnapshot: (() -> NSArray)?
+
+    init(fileURL: NSURL) {
+        self.fileURL = fileURL
+    }
+
+    // The snapshot last written, or an empty array if there is none.
+    func load() -> [[String : AnyObject]] {
+        return NSArray(contentsOfURL: fileURL) as? [[String : AnyObject]] ?? []
+    }
+
+    func schedule(snapshot snapshot: () -> NSArray) {
+        let isWriteScheduled = pendingSnapshot != nil
+        pendingSnapshot = snapshot
+        guard !isWriteScheduled else { return }
+
+        dispatch_async(dispatch_get_main_queue()) {
+            self.write()
+        }
+    }
+
+    // MARK: Private
+
+    private func write() {
+        guard let snapshot = pendingSnapshot?() else { return }
+        pendingSnapshot = nil
+
+        let fileURL = self.fileURL
+        dispatch_async(WriteBehindStore.queue) {
+            if !snapshot.writeToURL(fileURL, atomically: true) {
+                print("Error saving to \(fileURL)")
+            }
+        }
+    }
+}
+
+extension WriteBehindStore {
+    // The location in Application Support of the file with the given name, specific to a user if an ID is given.
+    static func fileURL(name name: String, userID: String? = nil) -> NSURL {
+        let directoryURL = NSFileManager.defaultManager().URLsForDirectory(.ApplicationSupportDirectory, inDomains: .UserDomainMask).first!
+        _ = try? NSFileManager.defaultManager().createDirectoryAtURL(directoryURL, withIntermediateDirectories: true, attributes: nil)
+        let fileName = userID.map { "\(name)-\($0)" } ?? name
+        return directoryURL.URLByAppendingPathComponent("\(fileName).plist")
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <libkern/OSAtomic.h>
+#import <AWSCore/AWSCore.h>
+
+// Each branch is a chain of continuations longer than the executors' inline depth limit, so both
+// the inline path and the overflow path (GCD for the default executor, the worker pool for the
+// work-stealing one) are exercised.
+static const NSUInteger AWSExecutorBenchmarkBranchCount = 64;
+static const NSUInteger AWSExecutorBenchmarkChainLength = 48;
+static const NSUInteger AWSExecutorBenchmarkGraphCount = 16;
+
+@interface AWSExecutorBenchmarkTests : XCTestCase
+
+@end
+
+@implementation AWSExecutorBenchmarkTests {
+    volatile int32_t _completedContinuations;
+}
+
+// Fans out from `trigger` into independent chains and fans back in once every chain has finished.
+- (AWSTask *)fanOutFanInFromTask:(AWSTask *)trigger executor:(AWSExecutor *)executor {
+    NSMutableArray *branches = [NSMutableArray arrayWithCapacity:AWSExecutorBenchmarkBranchCount];
+    for (NSUInteger branch = 0; branch < AWSExecutorBenchmarkBranchCount; branch++) {
+        AWSTask *task = trigger;
+        for (NSUInteger link = 0; link < AWSExecutorBenchmarkChainLength; link++) {
+            task = [task continueWithExecutor:executor withBlock:^id(AWSTask *task) {
+                OSAtomicIncrement32(&_completedContinuations);
+                return nil;
+            }];
+        }
+        [branches addObject:task];
+    }
+    return [[AWSTask taskForCompletionOfAllTasks:branches] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
+        OSAtomicIncrement32(&_completedContinuations);
+        return nil;
+    }];
+}
+
+// Builds and runs several graphs back to back, measuring continuations completed per unit of time.
+- (void)measureThroughputWithExecutor:(AWSExecutor *)executor {
+    [self measureBlock:^{
+        _completedContinuations = 0;
+        for (NSUInteger graph = 0; graph < AWSExecutorBenchmarkGraphCount; graph++) {
+            AWSTaskCompletionSource *trigger = [AWSTaskCompletionSource taskCompletionSource];
+            AWSTask *fanIn = [self fanOutFanInFromTask:trigger.task executor:executor];
+            [trigger setResult:nil];
+            [fanIn waitUntilFinished];
+        }
+        XCTAssertEqual(_completedContinuations, (int32_t)(AWSExecutorBenchmarkGraphCount * (AWSExecutorBenchmarkBranchCount * AWSExecutorBenchmarkChainLength + 1)));
+    }];
+}
+
+// Measures only the time from completing the trigger to the fan-in continuation running.
+- (void)measureLatencyWithExecutor:(AWSExecutor *)executor {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        _completedContinuations = 0;
+        AWSTaskCompletionSource *trigger = [AWSTaskCompletionSource taskCompletionSource];
+        AWSTask *fanIn = [self fanOutFanInFromTask:trigger.task executor:executor];
+
+        [self startMeasuring];
+        [trigger setResult:nil];
+        [fanIn waitUntilFinished];
+        [self stopMeasuring];
+
+        XCTAssertEqual(_completedContinuations, (int32_t)(AWSExecutorBenchmarkBranchCount * AWSExecutorBenchmarkChainLength + 1));
+    }];
+}
+
+- (void)testDefaultExecutorFanOutFanInThroughput {
+    [self measureThroughputWithExecutor:[AWSExecutor defaultExecutor]];
+}
+
+- (void)testWorkStealingExecutorFanOutFanInThroughput {
+    [self measureThroughputWithExecutor:[AWSExecutor workStealingExecutor]];
+}
+
+- (void)testDefaultExecutorFanOutFanInLatency {
+    [self measureLatencyWithExecutor:[AWSExecutor defaultExecutor]];
+}
+
+- (void)testWorkStealingExecutorFanOutFanInLatency {
+    [self measureLatencyWithExecutor:[AWSExecutor workStealingExecutor]];
+}
+
+@end
@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <AWSCore/AWSSignature.h>
+
+static NSString *const AWSSignatureTestsEmptyBodySha256 = @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+// The single-pass canonicalizer and the original split-and-join one it replaced are both private.
+@interface AWSSignatureV4Signer (CanonicalizationTests)
+
++ (NSString *)getCanonicalizedHeaderString:(NSDictionary *)headers;
++ (NSString *)getCanonicalizedHeaderString:(NSDictionary *)headers signedHeaders:(NSString *__autoreleasing *)signedHeaders;
+
+@end
+
+@interface AWSSignatureCanonicalizationTests : XCTestCase
+
+@end
+
+@implementation AWSSignatureCanonicalizationTests
+
+// Checks the single-pass canonicalizer against both the expected output and the original implementation.
+- (void)assertHeaders:(NSDictionary *)headers canonicalizeTo:(NSString *)expectedHeaderString signedHeaders:(NSString *)expectedSignedHeaders {
+    NSString *signedHeaders = nil;
+    NSString *headerString = [AWSSignatureV4Signer getCanonicalizedHeaderString:headers signedHeaders:&signedHeaders];
+
+    XCTAssertEqualObjects(headerString, expectedHeaderString);
+    XCTAssertEqualObjects(signedHeaders, expectedSignedHeaders);
+    XCTAssertEqualObjects([AWSSignatureV4Signer getCanonicalizedHeaderString:headers], expectedHeaderString);
+    XCTAssertEqualObjects([AWSSignatureV4Signer getSignedHeadersString:headers], expectedSignedHeaders);
+}
+
+- (void)testCanonicalRequestMatchesSigV4TestSuite {
+    NSDictionary *headers = @{@"Host" : @"example.amazonaws.com",
+                              @"X-Amz-Date" : @"20150830T123600Z"};
+    NSString *signedHeaders = nil;
+    NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:@"GET"
+                                                                          path:@"/"
+                                                                         query:@""
+                                                                       headers:headers
+                                                                 contentSha256:AWSSignatureTestsEmptyBodySha256
+                                                                 signedHeaders:&signedHeaders];
+
+    XCTAssertEqualObjects(canonicalRequest, @"GET\n"
+                                            @"/\n"
+                                            @"\n"
+                                            @"host:example.amazonaws.com\n"
+                                            @"x-amz-date:20150830T123600Z\n"
+                                            @"\n"
+                                            @"host;x-amz-date\n"
+                                            @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    XCTAssertEqualObjects(signedHeaders, @"host;x-amz-date");
+}
+
+- (void)testHeaderNamesAreLowercasedAndSortedCaseInsensitively {
+    [self assertHeaders:@{@"X-Amz-Date" : @"20150830T123600Z",
+                          @"host" : @"example.amazonaws.com",
+                          @"Content-Type" : @"application/x-amz-json-1.1"}
+         canonicalizeTo:@"content-type:application/x-amz-json-1.1\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n"
+          signedHeaders:@"content-type;host;x-amz-date"];
+}
+
+- (void)testWhitespaceIsFoldedToSingleSpaces {
+    [self assertHeaders:@{@"Host" : @"example.amazonaws.com",
+                          @"My-Header1" : @"  value1 \t  value2  ",
+                          @"My-Header2" : @"\"a   b   c\""}
+         canonicalizeTo:@"host:example.amazonaws.com\nmy-header1: value1 value2 \nmy-header2:\"a b c\"\n"
+          signedHeaders:@"host;my-header1;my-header2"];
+}
+
+- (void)testHeadersDifferingOnlyInCaseAreBothSigned {
+    [self assertHeaders:@{@"X-Amz-Meta-Color" : @"oak",
+                          @"x-amz-meta-color" : @"oak"}
+         canonicalizeTo:@"x-amz-meta-color:oak\nx-amz-meta-color:oak\n"
+          signedHeaders:@"x-amz-meta-color;x-amz-meta-color"];
+}
+
+- (void)testEmptyAndBlankValues {
+    [self assertHeaders:@{@"Host" : @"example.amazonaws.com",
+                          @"X-Amz-Blank" : @" \t ",
+                          @"X-Amz-Empty" : @""}
+         canonicalizeTo:@"host:example.amazonaws.com\nx-amz-blank: \nx-amz-empty:\n"
+          signedHeaders:@"host;x-amz-blank;x-amz-empty"];
+
+    [self assertHeaders:@{} canonicalizeTo:@"" signedHeaders:@""];
+}
+
+// Values longer than the canonicalizer's stack buffers are written out in several flushes.
+- (void)testLongValuesMatchOriginalCanonicalizer {
+    NSMutableString *value = [NSMutableString string];
+    for (NSUInteger word = 0; word < 200; word++) {
+        [value appendFormat:@"word%lu%@", (unsigned long)word, (word % 3 == 0) ? @" \t  " : @" "];
+    }
+    NSDictionary *headers = @{@"Host" : @"example.amazonaws.com",
+                              @"X-Amz-Long" : value};
+
+    NSString *headerString = [AWSSignatureV4Signer getCanonicalizedHeaderString:headers signedHeaders:NULL];
+
+    XCTAssertGreaterThan([headerString length], 1024u);
+    XCTAssertEqualObjects(headerString, [AWSSignatureV4Signer getCanonicalizedHeaderString:headers]);
+}
+
+@end
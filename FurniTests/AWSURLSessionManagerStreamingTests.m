@@ -0,0 +1,170 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import <AWSCore/AWSCore.h>
+
+// Mirrors what AWSURLSessionManager does with a successful body: the buffered path appends each chunk
+// to one NSMutableData sized from Content-Length, the streaming path hands the chunks to the serializer.
+static const NSUInteger AWSStreamingTestsChunkLength = 16 * 1024;
+static const NSUInteger AWSStreamingTestsBodyLength = 8 * 1024 * 1024;
+
+static int64_t AWSStreamingTestsBytesInUse(void) {
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return (int64_t)statistics.size_in_use;
+}
+
+@interface AWSURLSessionManagerStreamingTests : XCTestCase
+
+@property (nonatomic, strong) AWSJSONResponseSerializer *serializer;
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+@property (nonatomic, strong) NSData *body;
+
+@end
+
+@implementation AWSURLSessionManagerStreamingTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSDictionary *definition = @{@"operations" : @{@"ListItems" : @{@"output" : @{@"shape" : @"ListItemsOutput"}}},
+                                 @"shapes" : @{@"ListItemsOutput" : @{@"type" : @"structure",
+                                                                      @"members" : @{@"Items" : @{@"shape" : @"ItemList"}}},
+                                               @"ItemList" : @{@"type" : @"list",
+                                                               @"member" : @{@"shape" : @"Item"}},
+                                               @"Item" : @{@"type" : @"string"}}};
+    self.serializer = [[AWSJSONResponseSerializer alloc] initWithJSONDefinition:definition
+                                                                     actionName:@"ListItems"
+                                                                    outputClass:nil];
+
+    NSMutableString *item = [NSMutableString string];
+    while ([item length] < 1000) {
+        [item appendString:@"furni"];
+    }
+    NSMutableArray *items = [NSMutableArray array];
+    for (NSUInteger length = 0; length < AWSStreamingTestsBodyLength - 2 * [item length]; length += [item length] + 3) {
+        [items addObject:item];
+    }
+    self.body = [NSJSONSerialization dataWithJSONObject:@{@"Items" : items} options:0 error:nil];
+
+    self.response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://example.com/"]
+                                                statusCode:200
+                                               HTTPVersion:@"HTTP/1.1"
+                                              headerFields:@{@"Content-Type" : @"application/x-amz-json-1.1",
+                                                             @"Content-Length" : [@([self.body length]) stringValue]}];
+}
+
+- (void)tearDown {
+    [[AWSNetworkingBufferPool sharedPool] drain];
+    [super tearDown];
+}
+
+- (NSMutableData *)bufferBody {
+    NSMutableData *responseData = [NSMutableData dataWithCapacity:(NSUInteger)self.response.expectedContentLength];
+    const uint8_t *bytes = [self.body bytes];
+    for (NSUInteger offset = 0; offset < [self.body length]; offset += AWSStreamingTestsChunkLength) {
+        [responseData appendBytes:bytes + offset length:MIN(AWSStreamingTestsChunkLength, [self.body length] - offset)];
+    }
+    return responseData;
+}
+
+- (id<AWSHTTPURLResponseStream>)streamBody {
+    id<AWSHTTPURLResponseStream> stream = [self.serializer responseStreamForResponse:self.response];
+    const uint8_t *bytes = [self.body bytes];
+    for (NSUInteger offset = 0; offset < [self.body length]; offset += AWSStreamingTestsChunkLength) {
+        XCTAssertTrue([stream consumeResponseBytes:bytes + offset
+                                            length:MIN(AWSStreamingTestsChunkLength, [self.body length] - offset)
+                                             error:nil]);
+    }
+    return stream;
+}
+
+- (id)bufferedResponseObject {
+    NSError *error = nil;
+    id responseObject = [self.serializer responseObjectForResponse:self.response
+                                                   originalRequest:nil
+                                                    currentRequest:nil
+                                                              data:[self bufferBody]
+                                                             error:&error];
+    XCTAssertNil(error);
+    return responseObject;
+}
+
+- (id)streamedResponseObject {
+    NSError *error = nil;
+    id responseObject = [[self streamBody] finishWithOriginalRequest:nil currentRequest:nil error:&error];
+    XCTAssertNil(error);
+    return responseObject;
+}
+
+- (void)testStreamingMatchesBuffering {
+    id streamed = [self streamedResponseObject];
+
+    XCTAssertEqualObjects(streamed, [self bufferedResponseObject]);
+    XCTAssertGreaterThan([streamed[@"Items"] count], 0u);
+}
+
+- (void)testPayloadResponsesAreBuffered {
+    NSDictionary *definition = @{@"operations" : @{@"GetBlob" : @{@"output" : @{@"shape" : @"GetBlobOutput"}}},
+                                 @"shapes" : @{@"GetBlobOutput" : @{@"type" : @"structure",
+                                                                    @"payload" : @"Body",
+                                                                    @"members" : @{@"Body" : @{@"shape" : @"Blob"}}},
+                                               @"Blob" : @{@"type" : @"blob", @"streaming" : @YES}}};
+    AWSJSONResponseSerializer *serializer = [[AWSJSONResponseSerializer alloc] initWithJSONDefinition:definition
+                                                                                           actionName:@"GetBlob"
+                                                                                          outputClass:nil];
+
+    XCTAssertNil([serializer responseStreamForResponse:self.response]);
+}
+
+// Compares the heap growth while an 8 MB body is being received, once the pool has seen a body of that size.
+- (void)testStreamingReceivesIntoPooledBuffers {
+    [self streamedResponseObject];
+
+    int64_t bufferedBytes = 0;
+    int64_t streamedBytes = 0;
+    @autoreleasepool {
+        int64_t before = AWSStreamingTestsBytesInUse();
+        NSMutableData *responseData = [self bufferBody];
+        bufferedBytes = AWSStreamingTestsBytesInUse() - before;
+        XCTAssertEqual([responseData length], [self.body length]);
+    }
+    @autoreleasepool {
+        int64_t before = AWSStreamingTestsBytesInUse();
+        id<AWSHTTPURLResponseStream> stream = [self streamBody];
+        streamedBytes = AWSStreamingTestsBytesInUse() - before;
+        XCTAssertNotNil(stream);
+    }
+
+    XCTAssertGreaterThanOrEqual(bufferedBytes, (int64_t)[self.body length]);
+    XCTAssertLessThan(streamedBytes, (int64_t)AWSStreamingTestsBodyLength / 16);
+}
+
+- (void)testBufferedResponseThroughput {
+    [self measureBlock:^{
+        [self bufferedResponseObject];
+    }];
+}
+
+- (void)testStreamedResponseThroughput {
+    [self measureBlock:^{
+        [self streamedResponseObject];
+    }];
+}
+
+@end
@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class CartTests: XCTestCase {
+    private static let lineCount = 1_000
+
+    private let products: [Product] = (0..<CartTests.lineCount).map { makeProduct($0, price: 19.99, retailPrice: 39.99) }
+
+    private func makeCart() -> Cart {
+        return Cart(items: products.map { CartItem(product: $0, quantity: 2) })
+    }
+
+    func testTotalsAreExact() {
+        let cart = makeCart()
+        XCTAssertEqual(cart.productCount(), CartTests.lineCount * 2)
+        XCTAssertEqual(cart.subtotalCents, Int64(CartTests.lineCount) * 2 * 1_999)
+
+        cart.addProduct(products[0])
+        cart.setQuantity(1, ofProductWithID: 1)
+        cart.removeProduct(products[2])
+        XCTAssertEqual(cart.items.count, CartTests.lineCount - 1)
+        XCTAssertEqual(cart.productCount(), CartTests.lineCount * 2 - 2)
+        XCTAssertEqual(cart.subtotalCents, Int64(CartTests.lineCount * 2 - 2) * 1_999)
+        XCTAssertEqual(NSDecimalNumber(cents: cart.totalCents), NSDecimalNumber(string: "39940.02"))
+
+        cart.reset()
+        XCTAssertTrue(cart.isEmpty())
+        XCTAssertEqual(cart.subtotalCents, 0)
+    }
+
+    func testChangesArePostedInOneBatch() {
+        let cart = Cart()
+        let expectation = expectationWithDescription("Cart updated")
+
+        var notificationCount = 0
+        let observer = NSNotificationCenter.defaultCenter().addObserverForName(Cart.cartUpdatedNotificationName, object: cart, queue: nil) { _ in
+            notificationCount += 1
+            expectation.fulfill()
+        }
+
+        cart.addProduct(products[0])
+        cart.addProduct(products[0])
+        cart.addProduct(products[1])
+        cart.removeProduct(products[1])
+
+        waitForExpectationsWithTimeout(1) { _ in
+            NSNotificationCenter.defaultCenter().removeObserver(observer)
+            XCTAssertEqual(notificationCount, 1)
+            XCTAssertEqual(cart.quantityOfProductWithID(0), 2)
+        }
+    }
+
+    func testTotalsFollowQuantityChanges() {
+        let lamp = makeProduct(0, price: 5.25)
+        let cart = Cart(items: [CartItem(product: lamp, quantity: 1), CartItem(product: products[1], quantity: 1)])
+        XCTAssertEqual(cart.subtotalCents, 525 + 1_999)
+
+        cart.setQuantity(3, ofProductWithID: lamp.id)
+        XCTAssertEqual(cart.productCount(), 4)
+        XCTAssertEqual(cart.subtotalCents, 3 * 525 + 1_999)
+
+        cart.setQuantity(1, ofProductWithID: lamp.id)
+        XCTAssertEqual(cart.productCount(), 2)
+        XCTAssertEqual(cart.subtotalCents, 525 + 1_999)
+
+        // Quantities are capped, and a quantity of zero removes the line.
+        cart.setQuantity(Cart.maximumQuantity + 1, ofProductWithID: lamp.id)
+        cart.setQuantity(0, ofProductWithID: products[1].id)
+        XCTAssertEqual(cart.items.map { $0.product.id }, [lamp.id])
+        XCTAssertEqual(cart.quantityOfProductWithID(lamp.id), Cart.maximumQuantity)
+        XCTAssertEqual(cart.subtotalCents, Int64(Cart.maximumQuantity) * 525)
+        XCTAssertEqual(cart.totalCents, cart.subtotalCents + cart.shippingCents)
+    }
+
+    func testQuantitiesSurviveRelaunch() {
+        let URL = temporaryFileURL("CartTests.plist")
+
+        let cart = Cart(persistenceURL: URL)
+        cart.addProduct(products[0])
+        cart.setQuantity(3, ofProductWithID: 0)
+        cart.addProduct(products[1])
+        cart.addProduct(products[2])
+        cart.setQuantity(Cart.maximumQuantity, ofProductWithID: 2)
+        waitForPropertyListAtURL(URL, entryCount: 3)
+
+        var restoredCart = Cart(persistenceURL: URL)
+        XCTAssertEqual(restoredCart.items.map { $0.product.id }, [0, 1, 2])
+        XCTAssertEqual(restoredCart.items.map { $0.quantity }, [3, 1, Cart.maximumQuantity])
+        XCTAssertEqual(restoredCart.subtotalCents, cart.subtotalCents)
+
+        // Later changes replace the saved quantities.
+        cart.setQuantity(0, ofProductWithID: 1)
+        cart.setQuantity(2, ofProductWithID: 0)
+        waitForPropertyListAtURL(URL, entryCount: 2)
+
+        restoredCart = Cart(persistenceURL: URL)
+        XCTAssertEqual(restoredCart.items.map { $0.quantity }, [2, Cart.maximumQuantity])
+        XCTAssertEqual(restoredCart.productCount(), 2 + Cart.maximumQuantity)
+    }
+
+    func testPerformanceFillCart() {
+        self.measureBlock() {
+            let cart = Cart()
+            for product in self.products {
+                cart.addProduct(product)
+            }
+            for product in self.products {
+                cart.addProduct(product)
+            }
+        }
+    }
+
+    func testPerformanceUpdateQuantities() {
+        let cart = makeCart()
+
+        self.measureBlock() {
+            for product in self.products {
+                cart.setQuantity(cart.quantityOfProductWithID(product.id) % Cart.maximumQuantity + 1, ofProductWithID: product.id)
+                _ = cart.productCount()
+                _ = cart.totalAmount()
+            }
+        }
+    }
+
+    func testPerformanceRemoveItems() {
+        self.measureBlock() {
+            let cart = self.makeCart()
+            for product in self.products.reverse() {
+                cart.removeProduct(product)
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class ContactIndexTests: XCTestCase {
+    private static let contactCount = 5_000
+    private static let friendCount = 500
+
+    // Contacts are saved the way people type them: national format, with punctuation.
+    private let contacts: [IndexedContact] = (0..<ContactIndexTests.contactCount).map { index in
+        let lineNumber = String(format: "%04d", index)
+        return IndexedContact(identifier: "contact-\(index)", fullName: "Contact \(index)", postalAddress: nil, phoneNumbers: ["(415) 55\(index % 10)-\(lineNumber)", "+44 20 7946 \(lineNumber)"])
+    }
+
+    // Digits reports phone numbers in E.164 format.
+    private let friends: [User] = (0..<ContactIndexTests.friendCount).map { index in
+        let contactIndex = index * (ContactIndexTests.contactCount / ContactIndexTests.friendCount)
+        let user = User()
+        user.digitsPhoneNumber = "+141555\(contactIndex % 10)" + String(format: "%04d", contactIndex)
+        return user
+    }
+
+    func testMatchesPhoneNumbersRegardlessOfFormatting() {
+        let index = ContactIndex(contacts: contacts)
+
+        XCTAssertEqual(index.contactMatchingPhoneNumber("+14155520042")?.identifier, "contact-42")
+        XCTAssertEqual(index.contactMatchingPhoneNumber("415.552.0042")?.identifier, "contact-42")
+        XCTAssertEqual(index.contactMatchingPhoneNumber("+442079460042")?.identifier, "contact-42")
+        XCTAssertNil(index.contactMatchingPhoneNumber("+14155530042"))
+        XCTAssertNil(index.contactMatchingPhoneNumber("0042"))
+    }
+
+    func testSharedNumberStillMatchesAfterItsFirstContactIsRemoved() {
+        let home = IndexedContact(identifier: "home", fullName: "Home", postalAddress: nil, phoneNumbers: ["(415) 555-0100"])
+        let partner = IndexedContact(identifier: "partner", fullName: "Partner", postalAddress: nil, phoneNumbers: ["415-555-0100", "415-555-0199"])
+        let index = ContactIndex(contacts: [home, partner])
+        XCTAssertEqual(index.contactMatchingPhoneNumber("+14155550100")?.identifier, "home")
+
+        index.replaceContacts([partner])
+        XCTAssertEqual(index.contactMatchingPhoneNumber("+14155550100")?.identifier, "partner")
+
+        index.replaceContacts([])
+        XCTAssertNil(index.contactMatchingPhoneNumber("+14155550100"))
+        XCTAssertNil(index.contactMatchingPhoneNumber("+14155550199"))
+    }
+
+    func testPopulatesFriendsFromIndex() {
+        let index = ContactIndex(contacts: contacts)
+
+        for user in friends {
+            user.populateWithLocalContact(index)
+        }
+
+        XCTAssertEqual(friends[1].fullName, "Contact 10")
+        XCTAssertEqual(friends.filter { $0.fullName?.hasPrefix("Contact") ?? false }.count, ContactIndexTests.friendCount)
+    }
+
+    func testPerformanceBuildIndex() {
+        self.measureBlock() {
+            let index = ContactIndex(contacts: self.contacts)
+            XCTAssertEqual(index.count, ContactIndexTests.contactCount)
+        }
+    }
+
+    func testPerformanceMatchFriends() {
+        let index = ContactIndex(contacts: contacts)
+
+        self.measureBlock() {
+            for user in self.friends {
+                user.populateWithLocalContact(index)
+            }
+        }
+    }
+}
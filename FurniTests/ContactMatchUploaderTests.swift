@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+// A paged match lookup answering asynchronously, like the Digits API. Cursors are page numbers.
+private final class FakeMatchLookup {
+    static let pageCount = 50
+    static let pageSize = 200
+
+    var lookedUpCursors: [String?] = []
+
+    func lookUpPageWithCursor(cursor: String?, completion: ([String]?, String?) -> ()) {
+        lookedUpCursors.append(cursor)
+        let page = cursor.flatMap { Int($0) } ?? 0
+        let userIDs = (0..<FakeMatchLookup.pageSize).map { "\(page * FakeMatchLookup.pageSize + $0)" }
+        let nextCursor: String? = page + 1 < FakeMatchLookup.pageCount ? "\(page + 1)" : nil
+
+        dispatch_async(dispatch_get_main_queue()) {
+            completion(userIDs, nextCursor)
+        }
+    }
+}
+
+class ContactMatchUploaderTests: XCTestCase {
+    private let userDefaults = NSUserDefaults(suiteName: "ContactMatchUploaderTests")!
+
+    override func setUp() {
+        super.setUp()
+        userDefaults.removePersistentDomainForName("ContactMatchUploaderTests")
+    }
+
+    private func runUploader(uploader: ContactMatchUploader) -> Bool {
+        let expectation = expectationWithDescription("Upload finished")
+        var result = false
+        uploader.start { success in
+            result = success
+            expectation.fulfill()
+        }
+        waitForExpectationsWithTimeout(10, handler: nil)
+        return result
+    }
+
+    func testUploadsAllMatchesInBoundedBatches() {
+        let lookup = FakeMatchLookup()
+        var uploadedUserIDs: [String] = []
+        var isUploading = false
+        var overlappingLookupCount = 0
+
+        let uploader = ContactMatchUploader(digitsUserID: "user", batchSize: 150, userDefaults: userDefaults,
+            lookupPage: { cursor, completion in
+                if isUploading {
+                    overlappingLookupCount += 1
+                }
+                lookup.lookUpPageWithCursor(cursor, completion: completion)
+            },
+            uploadBatch: { userIDs, completion in
+                XCTAssertLessThanOrEqual(userIDs.count, 150)
+                isUploading = true
+                dispatch_async(dispatch_get_main_queue()) {
+                    isUploading = false
+                    uploadedUserIDs += userIDs
+                    completion(true)
+                }
+            }
+        )
+
+        XCTAssertTrue(runUploader(uploader))
+        XCTAssertEqual(lookup.lookedUpCursors.count, FakeMatchLookup.pageCount)
+        XCTAssertEqual(uploadedUserIDs, (0..<FakeMatchLookup.pageCount * FakeMatchLookup.pageSize).map { "\($0)" })
+        XCTAssertEqual(uploader.progress.uploadedCount, uploadedUserIDs.count)
+        XCTAssertGreaterThan(overlappingLookupCount, 0)
+        XCTAssertNil(userDefaults.stringForKey("xyz.furni.contact-matches.cursor.user"))
+    }
+
+    func testResumesAfterFailedUpload() {
+        let lookup = FakeMatchLookup()
+        var uploadedUserIDs: [String] = []
+        var uploadCount = 0
+
+        let uploader = ContactMatchUploader(digitsUserID: "user", batchSize: 100, userDefaults: userDefaults,
+            lookupPage: lookup.lookUpPageWithCursor,
+            uploadBatch: { userIDs, completion in
+                uploadCount += 1
+
+                // Fail in the middle of the 11th page.
+                let success = uploadCount != 22
+                if success {
+                    uploadedUserIDs += userIDs
+                }
+                dispatch_async(dispatch_get_main_queue()) {
+                    completion(success)
+                }
+            }
+        )
+
+        XCTAssertFalse(runUploader(uploader))
+        XCTAssertEqual(uploadedUserIDs, (0..<21 * 100).map { "\($0)" })
+
+        // The second run starts again from the page that was not fully uploaded, so only the half of that page
+        // uploaded before the failure is sent twice. Callbacks still in flight from the first run are ignored.
+        lookup.lookedUpCursors = []
+        XCTAssertTrue(runUploader(uploader))
+        XCTAssertTrue(lookup.lookedUpCursors.first! == "10")
+        let resumedUserIDs = (10 * FakeMatchLookup.pageSize..<FakeMatchLookup.pageCount * FakeMatchLookup.pageSize).map { "\($0)" }
+        XCTAssertEqual(uploadedUserIDs, (0..<21 * 100).map { "\($0)" } + resumedUserIDs)
+    }
+
+    func testPerformanceUploadMatches() {
+        self.measureBlock() {
+            let uploader = ContactMatchUploader(digitsUserID: "user", userDefaults: self.userDefaults,
+                lookupPage: FakeMatchLookup().lookUpPageWithCursor,
+                uploadBatch: { userIDs, completion in
+                    dispatch_async(dispatch_get_main_queue()) {
+                        completion(true)
+                    }
+                }
+            )
+            XCTAssertTrue(self.runUploader(uploader))
+        }
+    }
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class FavoritesStoreTests: XCTestCase {
+    private static let favoriteCount = 10_000
+
+    private let products: [Product] = (0..<FavoritesStoreTests.favoriteCount * 2).map { makeProduct($0) }
+
+    // Every other product is a favorite.
+    private func makeStore() -> FavoritesStore {
+        return FavoritesStore(products: products.enumerate().filter { $0.index % 2 == 0 }.map { $0.element })
+    }
+
+    func testMembershipAndOrder() {
+        let store = makeStore()
+        XCTAssertEqual(store.count, FavoritesStoreTests.favoriteCount)
+        XCTAssertTrue(store.containsProductWithID(42))
+        XCTAssertFalse(store.containsProductWithID(43))
+
+        store.removeProductWithID(2)
+        store.addProduct(products[43])
+        XCTAssertFalse(store.containsProductWithID(2))
+        XCTAssertEqual(store[1].id, 4)
+        XCTAssertEqual(store[store.count - 1].id, 43)
+    }
+
+    func testChangesArePostedInOneBatch() {
+        let store = makeStore()
+        let expectation = expectationWithDescription("Favorites changed")
+
+        var notificationCount = 0
+        let observer = NSNotificationCenter.defaultCenter().addObserverForName(FavoritesStore.favoritesChangedNotificationName, object: store, queue: nil) { notification in
+            notificationCount += 1
+            XCTAssertEqual((notification.userInfo?[FavoritesStore.insertedProductIDsKey] as? [Int]) ?? [], [1])
+            XCTAssertEqual((notification.userInfo?[FavoritesStore.removedProductIDsKey] as? [Int]) ?? [], [0])
+            expectation.fulfill()
+        }
+
+        store.addProduct(products[1])
+        store.removeProductWithID(0)
+        store.addProduct(products[3])
+        store.removeProductWithID(3)
+
+        waitForExpectationsWithTimeout(1) { _ in
+            NSNotificationCenter.defaultCenter().removeObserver(observer)
+            XCTAssertEqual(notificationCount, 1)
+        }
+    }
+
+    func testPersistsFavorites() {
+        let URL = temporaryFileURL("FavoritesStoreTests.plist")
+
+        let store = FavoritesStore(persistenceURL: URL)
+        store.replaceProducts(Array(products[0..<3]))
+
+        expectationForNotification(FavoritesStore.favoritesChangedNotificationName, object: store, handler: nil)
+        waitForExpectationsWithTimeout(1, handler: nil)
+
+        waitForPropertyListAtURL(URL, entryCount: 3)
+
+        let restoredStore = FavoritesStore(persistenceURL: URL)
+        XCTAssertEqual(restoredStore.products.map { $0.id }, [0, 1, 2])
+        XCTAssertEqual(restoredStore[1].name, "Product 1")
+    }
+
+    // Simulate scrolling through the whole catalog: every cell configure checks the favorited state.
+    func testPerformanceScrollingWithManyFavorites() {
+        let store = makeStore()
+
+        self.measureBlock() {
+            var favoritedCount = 0
+            for product in self.products where store.containsProductWithID(product.id) {
+                favoritedCount += 1
+            }
+            XCTAssertEqual(favoritedCount, FavoritesStoreTests.favoriteCount)
+        }
+    }
+
+    // Simulate scrolling through the favorites screen, which reads the favorites by row.
+    func testPerformanceScrollingFavorites() {
+        let store = makeStore()
+
+        self.measureBlock() {
+            var lastID = -1
+            for row in 0..<store.count {
+                lastID = store[row].id
+            }
+            XCTAssertEqual(lastID, FavoritesStoreTests.favoriteCount * 2 - 2)
+        }
+    }
+}
@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import UIKit
+import XCTest
+@testable import Furni
+
+// Counts the cells a collection view dequeues, which are the cells it configures.
+private final class CountingDataSource: NSObject, UICollectionViewDataSource {
+    static let reuseIdentifier = "Cell"
+
+    var items: [Int]
+    var dequeuedCount = 0
+
+    init(items: [Int]) {
+        self.items = items
+    }
+
+    @objc func collectionView(collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
+        return items.count
+    }
+
+    @objc func collectionView(collectionView: UICollectionView, cellForItemAtIndexPath indexPath: NSIndexPath) -> UICollectionViewCell {
+        dequeuedCount += 1
+        return collectionView.dequeueReusableCellWithReuseIdentifier(CountingDataSource.reuseIdentifier, forIndexPath: indexPath)
+    }
+}
+
+class ListDiffTests: XCTestCase {
+    private let productIDs = Array(0..<1_000)
+
+    // Apply the diff to an on-screen collection view showing the first 100 items, and return how many cells it configured.
+    private func reconfiguredCellCountApplying(diff: ListDiff, from oldItems: [Int], to newItems: [Int]) -> Int {
+        let window = UIWindow(frame: CGRect(x: 0, y: 0, width: 100, height: 100))
+        let layout = UICollectionViewFlowLayout()
+        layout.itemSize = CGSize(width: 10, height: 10)
+        layout.minimumInteritemSpacing = 0
+        layout.minimumLineSpacing = 0
+
+        let collectionView = UICollectionView(frame: window.bounds, collectionViewLayout: layout)
+        collectionView.registerClass(UICollectionViewCell.self, forCellWithReuseIdentifier: CountingDataSource.reuseIdentifier)
+        let dataSource = CountingDataSource(items: oldItems)
+        collectionView.dataSource = dataSource
+        window.addSubview(collectionView)
+        window.hidden = false
+        collectionView.layoutIfNeeded()
+
+        dataSource.items = newItems
+        dataSource.dequeuedCount = 0
+        UIView.performWithoutAnimation {
+            collectionView.applyDiff(diff)
+            collectionView.layoutIfNeeded()
+        }
+
+        window.hidden = true
+        return dataSource.dequeuedCount
+    }
+
+    func testIdenticalRefreshReconfiguresNothing() {
+        let diff = ListDiff(from: productIDs, to: productIDs, key: { $0 })!
+
+        XCTAssertTrue(diff.isEmpty)
+        XCTAssertEqual(diff.reconfiguredCount, 0)
+    }
+
+    func testInsertionAndDeletionReconfigureOnlyChangedCells() {
+        // Both changes are on screen, and the same 99 products stay visible around the new one.
+        var newProductIDs = productIDs
+        newProductIDs.removeAtIndex(10)
+        newProductIDs.insert(5_000, atIndex: 50)
+
+        let diff = ListDiff(from: productIDs, to: newProductIDs, key: { $0 })!
+
+        XCTAssertEqual(diff.deletions, [10])
+        XCTAssertEqual(diff.insertions, [50])
+        XCTAssertTrue(diff.moves.isEmpty)
+        XCTAssertEqual(diff.reconfiguredCount, 1)
+        XCTAssertEqual(reconfiguredCellCountApplying(diff, from: productIDs, to: newProductIDs), 1)
+    }
+
+    func testMoveIsNotReconfigured() {
+        var newProductIDs = productIDs
+        newProductIDs.insert(newProductIDs.removeAtIndex(20), atIndex: 0)
+
+        let diff = ListDiff(from: productIDs, to: newProductIDs, key: { $0 })!
+
+        XCTAssertEqual(diff.moves.count, 1)
+        XCTAssertTrue(diff.moves.first?.from == 20)
+        XCTAssertTrue(diff.moves.first?.to == 0)
+        XCTAssertTrue(diff.deletions.isEmpty)
+        XCTAssertTrue(diff.insertions.isEmpty)
+        XCTAssertEqual(reconfiguredCellCountApplying(diff, from: productIDs, to: newProductIDs), 0)
+    }
+
+    func testMovingOneElementAcrossTheListIsOneMove() {
+        var newProductIDs = productIDs
+        newProductIDs.append(newProductIDs.removeAtIndex(0))
+
+        let diff = ListDiff(from: productIDs, to: newProductIDs, key: { $0 })!
+
+        XCTAssertEqual(diff.moves.count, 1)
+        XCTAssertTrue(diff.moves.first?.from == 0)
+        XCTAssertTrue(diff.moves.first?.to == productIDs.count - 1)
+    }
+
+    func testSwappingNeighborsIsOneMove() {
+        var newProductIDs = productIDs
+        swap(&newProductIDs[500], &newProductIDs[501])
+
+        let diff = ListDiff(from: productIDs, to: newProductIDs, key: { $0 })!
+
+        XCTAssertEqual(diff.moves.count, 1)
+        XCTAssertTrue(diff.reloads.isEmpty)
+    }
+
+    func testEditedElementIsReloaded() {
+        let oldProducts = productIDs.map { (id: $0, price: 10) }
+        var newProducts = oldProducts
+        newProducts[42].price = 20
+
+        let diff = ListDiff(from: oldProducts, to: newProducts, key: { $0.id }, isEqual: { $0.price == $1.price })!
+
+        XCTAssertEqual(diff.reloads, [42])
+        XCTAssertEqual(diff.reconfiguredCount, 1)
+        XCTAssertEqual(reconfiguredCellCountApplying(diff, from: productIDs, to: productIDs), 1)
+    }
+
+    func testDuplicateKeysFail() {
+        XCTAssertNil(ListDiff(from: [1, 2, 2], to: [1, 2], key: { $0 }))
+    }
+
+    // Measure the cost of diffing a refresh that changes a few products in a large list.
+    func testPerformanceDiff() {
+        let oldProductIDs = Array(0..<100_000)
+        var newProductIDs = oldProductIDs
+        newProductIDs.removeAtIndex(50_000)
+        newProductIDs.insert(-1, atIndex: 0)
+
+        self.measureBlock() {
+            let diff = ListDiff(from: oldProductIDs, to: newProductIDs, key: { $0 })!
+            XCTAssertEqual(diff.reconfiguredCount, 1)
+        }
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class PrefetchControllerTests: XCTestCase {
+    private var prefetchedIndexes: [Int] = []
+    private var cancelledIndexes: [Int] = []
+    private let scrollView = UIScrollView()
+
+    private func makeController() -> PrefetchController {
+        let controller = PrefetchController(axis: .Vertical, prefetchDistance: 3, prefetch: { self.prefetchedIndexes += $0 }, cancel: { self.cancelledIndexes += $0 })
+        controller.fastScrollVelocity = CGFloat.max
+        return controller
+    }
+
+    private func scrollController(controller: PrefetchController, toOffset offset: CGFloat, visibleIndexes: [Int], itemCount: Int = 20) {
+        scrollView.contentOffset = CGPoint(x: 0, y: offset)
+        controller.scrollViewDidScroll(scrollView, visibleIndexes: visibleIndexes, itemCount: itemCount)
+    }
+
+    func testPrefetchesAheadOfScrollDirection() {
+        let controller = makeController()
+        scrollController(controller, toOffset: 0, visibleIndexes: [0, 1])
+        scrollController(controller, toOffset: 10, visibleIndexes: [0, 1])
+        XCTAssertEqual(prefetchedIndexes, [2, 3, 4])
+
+        // Items already warmed are not requested again.
+        scrollController(controller, toOffset: 20, visibleIndexes: [1, 2])
+        XCTAssertEqual(prefetchedIndexes, [2, 3, 4, 5])
+    }
+
+    func testCancelsWhenDirectionReverses() {
+        let controller = makeController()
+        scrollController(controller, toOffset: 100, visibleIndexes: [10, 11])
+        scrollController(controller, toOffset: 110, visibleIndexes: [10, 11])
+        scrollController(controller, toOffset: 100, visibleIndexes: [10, 11])
+
+        XCTAssertEqual(Set(cancelledIndexes), [12, 13, 14])
+        XCTAssertEqual(Array(prefetchedIndexes.suffixFrom(3)), [9, 8, 7])
+    }
+
+    func testStopsAtEndOfList() {
+        let controller = makeController()
+        scrollController(controller, toOffset: 0, visibleIndexes: [18])
+        scrollController(controller, toOffset: 10, visibleIndexes: [18])
+
+        XCTAssertEqual(prefetchedIndexes, [19])
+    }
+
+    func testToleratesItemCountShrinkingBelowVisibleIndexes() {
+        let controller = makeController()
+        scrollController(controller, toOffset: 0, visibleIndexes: [10, 11])
+        scrollController(controller, toOffset: 10, visibleIndexes: [10, 11], itemCount: 5)
+        XCTAssertEqual(prefetchedIndexes, [])
+
+        scrollController(controller, toOffset: 0, visibleIndexes: [10, 11], itemCount: 5)
+        XCTAssertEqual(prefetchedIndexes, [4, 3, 2])
+    }
+
+    func testImageHitRate() {
+        let prefetcher = ImagePrefetcher(imageCache: nil)
+        prefetcher.recordDisplayOfImageWithURL(NSURL(string: "https://furni.xyz/1.jpg")!)
+
+        XCTAssertEqual(prefetcher.statistics.displayedCount, 1)
+        XCTAssertEqual(prefetcher.statistics.hitRate, 0)
+    }
+
+    func testPerformanceScrolling() {
+        let controller = makeController()
+
+        self.measureBlock() {
+            for step in 0..<10_000 {
+                let offset = CGFloat(step % 2_000)
+                let firstVisibleIndex = step % 2_000 / 100
+                self.scrollController(controller, toOffset: offset, visibleIndexes: Array(firstVisibleIndex..<min(20, firstVisibleIndex + 4)))
+            }
+        }
+    }
+}
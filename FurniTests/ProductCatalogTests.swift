@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class ProductCatalogTests: XCTestCase {
+    private static let productCount = 50_000
+
+    // Product dictionaries as returned by the API. Names repeat across collections, as they do in a real catalog.
+    private static let dictionaries: [[String : AnyObject]] = (0..<ProductCatalogTests.productCount).map { index in
+        makeProductDictionary(index, name: "Chair \(index % 500)", price: Float(index % 1_000) + 0.5, retailPrice: Float(index % 1_000) * 2 + 1, percentOff: index % 3 == 0 ? 50 : 0)
+    }
+
+    private static let products = ProductCatalogTests.dictionaries.map { Product(dictionary: $0, collectionPermalink: "chairs") }
+
+    private static let catalog = ProductCatalog(dictionaries: ProductCatalogTests.dictionaries, collectionPermalink: "chairs")
+
+    func testCatalogMatchesProducts() {
+        let catalog = ProductCatalogTests.catalog
+        let product = ProductCatalogTests.products[1234]
+        let catalogProduct = catalog.productAtIndex(1234)
+
+        XCTAssertEqual(catalog.count, ProductCatalogTests.productCount)
+        XCTAssertEqual(catalogProduct.id, product.id)
+        XCTAssertEqual(catalogProduct.name, product.name)
+        XCTAssertEqual(catalogProduct.description, product.description)
+        XCTAssertEqual(catalogProduct.collectionPermalink, product.collectionPermalink)
+        XCTAssertEqual(catalogProduct.price, product.price)
+        XCTAssertEqual(catalogProduct.retailPrice, product.retailPrice)
+        XCTAssertEqual(catalogProduct.percentOff, product.percentOff)
+        XCTAssertEqual(catalogProduct.productURL, product.productURL)
+        XCTAssertEqual(catalogProduct.imageURL, product.imageURL)
+
+        // Product objects are only created once per index.
+        XCTAssertTrue(catalog.productAtIndex(1234) === catalogProduct)
+    }
+
+    func testSortingAndFiltering() {
+        let catalog = ProductCatalogTests.catalog
+        let products = ProductCatalogTests.products
+
+        XCTAssertEqual(catalog.indexesSortedByPrice().map { catalog.prices[$0] }, products.map { $0.price }.sort())
+        XCTAssertEqual(catalog.indexesOfDiscountedProducts().count, products.filter { $0.price < $0.retailPrice && $0.percentOff > 0 }.count)
+        XCTAssertEqual(catalog.indexesOfProductsWithPriceFrom(10, to: 20).count, products.filter { $0.price >= 10 && $0.price <= 20 }.count)
+        XCTAssertEqual(catalog.indexesOfProductsWithNameContainingString("chair 42").count, products.filter { $0.name.localizedCaseInsensitiveContainsString("chair 42") }.count)
+    }
+
+    // The bytes currently allocated on the heap by the process.
+    private func heapBytesInUse() -> Int {
+        var statistics = malloc_statistics_t()
+        malloc_zone_statistics(nil, &statistics)
+        return Int(statistics.size_in_use)
+    }
+
+    // Compare the heap growth of keeping the same products as a catalog and as product objects.
+    // Each representation is built in its own autorelease pool, so only what it keeps alive is counted.
+    func testMemoryFootprint() {
+        let dictionaries = ProductCatalogTests.dictionaries
+
+        var catalog: ProductCatalog?
+        var heapBytes = heapBytesInUse()
+        autoreleasepool {
+            catalog = ProductCatalog(dictionaries: dictionaries, collectionPermalink: "chairs")
+        }
+        let catalogBytes = heapBytesInUse() - heapBytes
+        XCTAssertEqual(catalog?.count ?? 0, ProductCatalogTests.productCount)
+        catalog = nil
+
+        var products: [Product] = []
+        heapBytes = heapBytesInUse()
+        autoreleasepool {
+            products = dictionaries.map { Product(dictionary: $0, collectionPermalink: "chairs") }
+        }
+        let productBytes = heapBytesInUse() - heapBytes
+        XCTAssertEqual(products.count, ProductCatalogTests.productCount)
+
+        XCTAssertGreaterThan(catalogBytes, 0)
+        XCTAssertLessThan(catalogBytes, productBytes)
+    }
+
+    func testPerformanceBuildCatalog() {
+        self.measureBlock() {
+            _ = ProductCatalog(dictionaries: ProductCatalogTests.dictionaries, collectionPermalink: "chairs")
+        }
+    }
+
+    func testPerformanceBuildProducts() {
+        self.measureBlock() {
+            _ = ProductCatalogTests.dictionaries.map { Product(dictionary: $0, collectionPermalink: "chairs") }
+        }
+    }
+
+    func testPerformanceSortCatalogByPrice() {
+        let catalog = ProductCatalogTests.catalog
+
+        self.measureBlock() {
+            _ = catalog.indexesSortedByPrice()
+        }
+    }
+
+    func testPerformanceSortProductsByPrice() {
+        let products = ProductCatalogTests.products
+
+        self.measureBlock() {
+            _ = products.sort { $0.price < $1.price }
+        }
+    }
+
+    func testPerformanceFilterCatalog() {
+        let catalog = ProductCatalogTests.catalog
+
+        self.measureBlock() {
+            _ = catalog.indexesOfDiscountedProducts()
+            _ = catalog.indexesOfProductsWithNameContainingString("chair 42")
+        }
+    }
+
+    func testPerformanceFilterProducts() {
+        let products = ProductCatalogTests.products
+
+        self.measureBlock() {
+            _ = products.filter { $0.price < $0.retailPrice && $0.percentOff > 0 }
+            _ = products.filter { $0.name.localizedCaseInsensitiveContainsString("chair 42") }
+        }
+    }
+}
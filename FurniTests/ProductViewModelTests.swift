@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+class ProductViewModelTests: XCTestCase {
+    private let products: [Product] = (0..<1_000).map { index in
+        makeProduct(index, price: Float(index) + 0.99, retailPrice: index % 2 == 0 ? Float(index) * 2 + 1 : 0, percentOff: index % 2 == 0 ? 50 : 0)
+    }
+
+    func testDiscountedProductStrikesThroughRetailPrice() {
+        let viewModel = ProductViewModel(product: products[2])
+
+        XCTAssertEqual(viewModel.priceText, products[2].price.asCurrency)
+        XCTAssertEqual(viewModel.retailPriceText?.string, products[2].retailPrice.asCurrency)
+        XCTAssertNotNil(viewModel.retailPriceText?.attribute(NSStrikethroughStyleAttributeName, atIndex: 0, effectiveRange: nil))
+        XCTAssertEqual(viewModel.percentOffText, "-50%")
+
+        XCTAssertNil(ProductViewModel(product: products[1]).retailPriceText)
+        XCTAssertNil(ProductViewModel(product: products[1]).percentOffText)
+    }
+
+    func testCacheRebuildsUpdatedProducts() {
+        let cache = ProductViewModelCache()
+        let product = products[0]
+        XCTAssertEqual(cache.viewModelForProduct(product).priceText, product.price.asCurrency)
+
+        let updatedProduct = Product(id: product.id, collectionPermalink: product.collectionPermalink, name: product.name, description: "", price: 5, retailPrice: 0, percentOff: 0, currency: "USD", productURL: product.productURL, imageURL: product.imageURL)
+        XCTAssertEqual(cache.viewModelForProduct(updatedProduct).priceText, Float(5).asCurrency)
+    }
+
+    func testFrameTimeReportCountsDroppedFrames() {
+        let report = FrameTimeReport(frameDurations: [1.0 / 60, 1.0 / 60, 3.0 / 60, 1.0 / 60], refreshInterval: 1.0 / 60)
+
+        XCTAssertEqual(report.frameCount, 4)
+        XCTAssertEqual(report.droppedFrameCount, 2)
+        XCTAssertEqualWithAccuracy(report.maximumFrameDuration, 3.0 / 60, accuracy: 0.0001)
+    }
+
+    // The main thread work of configuring the cells of a rapid scroll when nothing was prepared.
+    func testPerformanceConfigureWithoutCache() {
+        self.measureBlock() {
+            for product in self.products {
+                _ = ProductViewModel(product: product)
+            }
+        }
+    }
+
+    // The same scroll once the view models were prepared when the collection loaded.
+    func testPerformanceConfigureWithPreparedViewModels() {
+        let cache = ProductViewModelCache()
+        let expectation = expectationWithDescription("View models prepared")
+        cache.prepareViewModelsForProducts(products) {
+            expectation.fulfill()
+        }
+        waitForExpectationsWithTimeout(5, handler: nil)
+
+        self.measureBlock() {
+            for product in self.products {
+                _ = cache.viewModelForProduct(product)
+            }
+        }
+    }
+}
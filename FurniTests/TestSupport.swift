@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2015 Twitter, Inc. and other contributors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//         http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import Furni
+
+// The dictionary the API returns for a product. The name is padded and the image URL is HTTP, as they often are in real responses.
+func makeProductDictionary(index: Int, name: String? = nil, price: Float = 10, retailPrice: Float = 20, percentOff: Int = 50) -> [String : AnyObject] {
+    return [
+        "id": index,
+        "name": " \(name ?? "Product \(index)") ",
+        "description": "A comfortable product.",
+        "price": "\(price)",
+        "retail_price": "\(retailPrice)",
+        "percentoff": percentOff,
+        "url": "https://furni.xyz/products/\(index)",
+        "image_url": "http://images.furni.xyz/products/\(index).jpg"
+    ]
+}
+
+// A product parsed from the dictionary the API returns for it.
+func makeProduct(index: Int, price: Float = 10, retailPrice: Float = 20, percentOff: Int = 50) -> Product {
+    return Product(dictionary: makeProductDictionary(index, price: price, retailPrice: retailPrice, percentOff: percentOff), collectionPermalink: "collection")
+}
+
+extension XCTestCase {
+    // A location in the temporary directory with no file at it yet.
+    func temporaryFileURL(name: String) -> NSURL {
+        let URL = NSURL(fileURLWithPath: NSTemporaryDirectory()).URLByAppendingPathComponent(name)
+        _ = try? NSFileManager.defaultManager().removeItemAtURL(URL)
+        return URL
+    }
+
+    // Run the main run loop until the property list array at the URL has the given number of entries, e.g. once a write behind finished.
+    func waitForPropertyListAtURL(URL: NSURL, entryCount: Int, timeout: NSTimeInterval = 1) {
+        let deadline = NSDate(timeIntervalSinceNow: timeout)
+        while NSArray(contentsOfURL: URL)?.count != entryCount && deadline.timeIntervalSinceNow > 0 {
+            NSRunLoop.currentRunLoop().runUntilDate(NSDate(timeIntervalSinceNow: 0.01))
+        }
+        XCTAssertEqual(NSArray(contentsOfURL: URL)?.count ?? 0, entryCount, "Property list at \(URL.lastPathComponent ?? "") was not written in time")
+    }
+}
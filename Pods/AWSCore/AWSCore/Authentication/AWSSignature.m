@@ -26,6 +26,74 @@ NSString *const AWSSigV4Marker = @"AWS4";
 NSString *const AWSSignatureV4Algorithm = @"AWS4-HMAC-SHA256";
 NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
+static const char AWSSignatureHexDigits[] = "0123456789abcdef";
+
+// Writes two lowercase hex digits per input byte into `hex`, which must hold at least 2 * length bytes.
+static inline void AWSSignatureHexEncodeBytes(const uint8_t *bytes, size_t length, char *hex) {
+    for (size_t i = 0; i < length; i++) {
+        hex[2 * i] = AWSSignatureHexDigits[bytes[i] >> 4];
+        hex[2 * i + 1] = AWSSignatureHexDigits[bytes[i] & 0x0F];
+    }
+}
+
+static inline NSString *AWSSignatureHexStringFromDigest(const uint8_t digest[CC_SHA256_DIGEST_LENGTH]) {
+    char hex[CC_SHA256_DIGEST_LENGTH * 2];
+    AWSSignatureHexEncodeBytes(digest, CC_SHA256_DIGEST_LENGTH, hex);
+    return [[NSString alloc] initWithBytes:hex length:sizeof(hex) encoding:NSASCIIStringEncoding];
+}
+
+// Appends characters to a string through a fixed stack buffer, collapsing every run of whitespace into
+// a single space and dropping whitespace at the start and end of the output. This is what SigV4 expects
+// of the canonical header block, and matches splitting on whitespace and re-joining with spaces.
+typedef struct {
+    CFMutableStringRef string;
+    unichar buffer[256];
+    NSUInteger length;
+    BOOL hasOutput;
+    BOOL pendingSpace;
+} AWSSignatureCanonicalWriter;
+
+static inline void AWSSignatureCanonicalWriterFlush(AWSSignatureCanonicalWriter *writer) {
+    if (writer->length > 0) {
+        CFStringAppendCharacters(writer->string, writer->buffer, writer->length);
+        writer->length = 0;
+    }
+}
+
+static inline void AWSSignatureCanonicalWriterPut(AWSSignatureCanonicalWriter *writer, unichar character) {
+    if (writer->length == sizeof(writer->buffer) / sizeof(unichar)) {
+        AWSSignatureCanonicalWriterFlush(writer);
+    }
+    writer->buffer[writer->length++] = character;
+}
+
+static void AWSSignatureCanonicalWriterAppend(AWSSignatureCanonicalWriter *writer, NSString *string) {
+    static NSCharacterSet *whitespaceCharacters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        whitespaceCharacters = [NSCharacterSet whitespaceCharacterSet];
+    });
+
+    unichar characters[64];
+    NSUInteger length = [string length];
+    for (NSUInteger location = 0; location < length; location += 64) {
+        NSRange range = NSMakeRange(location, MIN((NSUInteger)64, length - location));
+        [string getCharacters:characters range:range];
+        for (NSUInteger i = 0; i < range.length; i++) {
+            if ([whitespaceCharacters characterIsMember:characters[i]]) {
+                writer->pendingSpace = writer->hasOutput;
+                continue;
+            }
+            if (writer->pendingSpace) {
+                AWSSignatureCanonicalWriterPut(writer, ' ');
+                writer->pendingSpace = NO;
+            }
+            AWSSignatureCanonicalWriterPut(writer, characters[i]);
+            writer->hasOutput = YES;
+        }
+    }
+}
+
 @implementation AWSSignatureSignerUtility
 
 + (NSData *)sha256HMacWithData:(NSData *)data withKey:(NSData *)key {
@@ -66,18 +134,62 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 
     [string getCharacters:chars];
 
-    NSMutableString *hexString = [NSMutableString new];
+    NSMutableString *hexString = [NSMutableString stringWithCapacity:len * 2];
     for (NSUInteger i = 0; i < len; i++) {
-        if ((int)chars[i] < 16) {
-            [hexString appendString:@"0"];
+        if (chars[i] <= 0xFF) {
+            unichar hex[2] = {AWSSignatureHexDigits[chars[i] >> 4], AWSSignatureHexDigits[chars[i] & 0x0F]};
+            CFStringAppendCharacters((__bridge CFMutableStringRef)hexString, hex, 2);
+        } else {
+            [hexString appendFormat:@"%x", chars[i]];
         }
-        [hexString appendString:[NSString stringWithFormat:@"%x", chars[i]]];
     }
     free(chars);
 
     return hexString;
 }
 
++ (NSString *)hexEncodeData:(NSData *)data {
+    NSUInteger length = [data length];
+    char stackHex[CC_SHA256_DIGEST_LENGTH * 2];
+    char *hex = length <= CC_SHA256_DIGEST_LENGTH ? stackHex : malloc(length * 2);
+
+    AWSSignatureHexEncodeBytes([data bytes], length, hex);
+    NSString *hexString = [[NSString alloc] initWithBytes:hex length:length * 2 encoding:NSASCIIStringEncoding];
+
+    if (hex != stackHex) {
+        free(hex);
+    }
+    return hexString;
+}
+
++ (NSString *)hexSha256OfData:(NSData *)data {
+    if ([data length] > UINT32_MAX) {
+        return nil;
+    }
+
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256([data bytes], (CC_LONG)[data length], digest);
+    return AWSSignatureHexStringFromDigest(digest);
+}
+
++ (NSString *)hexSha256OfString:(NSString *)string {
+    const char *UTF8String = [string UTF8String];
+    NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    if (length > UINT32_MAX) {
+        return nil;
+    }
+
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(UTF8String, (CC_LONG)length, digest);
+    return AWSSignatureHexStringFromDigest(digest);
+}
+
++ (NSString *)hexSha256HMacWithData:(NSData *)data withKey:(NSData *)key {
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    CCHmac(kCCHmacAlgSHA256, [key bytes], [key length], [data bytes], [data length], digest);
+    return AWSSignatureHexStringFromDigest(digest);
+}
+
 + (NSString *)HMACSign:(NSData *)data withKey:(NSString *)key usingAlgorithm:(CCHmacAlgorithm)algorithm {
     CCHmacContext context;
     const char    *keyCString = [key cStringUsingEncoding:NSASCIIStringEncoding];
@@ -219,7 +331,7 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         [urlRequest addValue:@"aws-chunked" forHTTPHeaderField:@"Content-Encoding"]; //add aws-chunked keyword for s3 chunk upload
         [urlRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)contentLength] forHTTPHeaderField:@"x-amz-decoded-content-length"];
     } else {
-        contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:[urlRequest HTTPBody]] encoding:NSASCIIStringEncoding]];
+        contentSha256 = [AWSSignatureSignerUtility hexSha256OfData:[urlRequest HTTPBody]];
         //using Content-Length with value of '0' cause auth issue, remove it.
         if (contentLength == 0) {
             [urlRequest setValue:nil forHTTPHeaderField:@"Content-Length"];
@@ -245,18 +357,20 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     
     NSMutableDictionary *headers = [[urlRequest allHTTPHeaderFields] mutableCopy];
 
+    NSString *signedHeaders = nil;
     NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:httpMethod
                                                                           path:path
                                                                          query:query
                                                                        headers:headers
-                                                                 contentSha256:contentSha256];
+                                                                 contentSha256:contentSha256
+                                                                 signedHeaders:&signedHeaders];
     AWSLogDebug(@"Canonical request: [%@]", canonicalRequest);
 
     NSString *stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@",
                               AWSSignatureV4Algorithm,
                               [urlRequest valueForHTTPHeaderField:@"X-Amz-Date"],
                               scope,
-                              [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
+                              [AWSSignatureSignerUtility hexSha256OfString:canonicalRequest]];
     AWSLogDebug(@"AWS4 String to Sign: [%@]", stringToSign);
 
     NSData *kSigning  = [AWSSignatureV4Signer getV4DerivedKey:self.credentialsProvider.secretKey
@@ -264,15 +378,13 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
                                                        region:self.endpoint.regionName
                                                       service:self.endpoint.serviceName];
 
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:kSigning];
-    NSString *signatureString = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature
-                                                                                           encoding:NSASCIIStringEncoding]];
+    NSString *signatureString = [AWSSignatureSignerUtility hexSha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
+                                                                         withKey:kSigning];
 
     NSString *authorization = [NSString stringWithFormat:@"%@ Credential=%@, SignedHeaders=%@, Signature=%@",
                                AWSSignatureV4Algorithm,
                                signingCredentials,
-                               [AWSSignatureV4Signer getSignedHeadersString:headers],
+                               signedHeaders,
                                signatureString];
 
     if (nil != stream) {
@@ -310,13 +422,15 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
         query = [NSString stringWithFormat:@""];
     }
 
-    NSString *contentSha256 = [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:[AWSSignatureSignerUtility hash:request.HTTPBody] encoding:NSASCIIStringEncoding]];
+    NSString *contentSha256 = [AWSSignatureSignerUtility hexSha256OfData:request.HTTPBody];
 
+    NSString *signedHeaders = nil;
     NSString *canonicalRequest = [AWSSignatureV4Signer getCanonicalizedRequest:request.HTTPMethod
                                                                           path:path
                                                                          query:query
                                                                        headers:request.allHTTPHeaderFields
-                                                                 contentSha256:contentSha256];
+                                                                 contentSha256:contentSha256
+                                                                 signedHeaders:&signedHeaders];
 
     AWSLogDebug(@"AWS4 Canonical Request: [%@]", canonicalRequest);
     AWSLogDebug(@"payload %@",[[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding]);
@@ -333,7 +447,7 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
                               AWSSignatureV4Algorithm,
                               [request valueForHTTPHeaderField:@"X-Amz-Date"],
                               scope,
-                              [AWSSignatureSignerUtility hexEncode:[AWSSignatureSignerUtility hashString:canonicalRequest]]];
+                              [AWSSignatureSignerUtility hexSha256OfString:canonicalRequest]];
 
     AWSLogDebug(@"AWS4 String to Sign: [%@]", stringToSign);
 
@@ -341,12 +455,12 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
                                                          date:dateStamp
                                                        region:self.endpoint.regionName
                                                       service:self.endpoint.serviceName];
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:kSigning];
+    NSString *signatureString = [AWSSignatureSignerUtility hexSha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
+                                                                         withKey:kSigning];
 
     NSString *credentialsAuthorizationHeader = [NSString stringWithFormat:@"Credential=%@", signingCredentials];
-    NSString *signedHeadersAuthorizationHeader = [NSString stringWithFormat:@"SignedHeaders=%@", [AWSSignatureV4Signer getSignedHeadersString:request.allHTTPHeaderFields]];
-    NSString *signatureAuthorizationHeader = [NSString stringWithFormat:@"Signature=%@", [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:signature encoding:NSASCIIStringEncoding]]];
+    NSString *signedHeadersAuthorizationHeader = [NSString stringWithFormat:@"SignedHeaders=%@", signedHeaders];
+    NSString *signatureAuthorizationHeader = [NSString stringWithFormat:@"Signature=%@", signatureString];
 
     NSString *authorization = [NSString stringWithFormat:@"%@ %@, %@, %@",
                                AWSSignatureV4Algorithm,
@@ -358,8 +472,12 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
 }
 
 
-+ (NSString *)getCanonicalizedRequest:(NSString *)method path:(NSString *)path query:(NSString *)query headers:(NSDictionary *)headers contentSha256:(NSString *)contentSha256 {
-    NSMutableString *canonicalRequest = [NSMutableString new];
++ (NSString *)getCanonicalizedRequest:(NSString *)method path:(NSString *)path query:(NSString *)query headers:(NSDictionary *)headers contentSha256:(NSString *)contentSha256 signedHeaders:(NSString *__autoreleasing *)signedHeaders {
+    NSString *signedHeadersString = nil;
+    NSString *canonicalHeaderString = [AWSSignatureV4Signer getCanonicalizedHeaderString:headers
+                                                                           signedHeaders:&signedHeadersString];
+
+    NSMutableString *canonicalRequest = [NSMutableString stringWithCapacity:[path length] + [query length] + [canonicalHeaderString length] + [signedHeadersString length] + 128];
     [canonicalRequest appendString:method];
     [canonicalRequest appendString:@"\n"];
     [canonicalRequest appendString:path]; // Canonicalized resource path
@@ -368,17 +486,29 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     [canonicalRequest appendString:[AWSSignatureV4Signer getCanonicalizedQueryString:query]]; // Canonicalized Query String
     [canonicalRequest appendString:@"\n"];
 
-    [canonicalRequest appendString:[AWSSignatureV4Signer getCanonicalizedHeaderString:headers]];
+    [canonicalRequest appendString:canonicalHeaderString];
     [canonicalRequest appendString:@"\n"];
 
-    [canonicalRequest appendString:[AWSSignatureV4Signer getSignedHeadersString:headers]];
+    [canonicalRequest appendString:signedHeadersString];
     [canonicalRequest appendString:@"\n"];
 
     [canonicalRequest appendString:[NSString stringWithFormat:@"%@", contentSha256]];
 
+    if (signedHeaders) {
+        *signedHeaders = signedHeadersString;
+    }
     return canonicalRequest;
 }
 
++ (NSString *)getCanonicalizedRequest:(NSString *)method path:(NSString *)path query:(NSString *)query headers:(NSDictionary *)headers contentSha256:(NSString *)contentSha256 {
+    return [AWSSignatureV4Signer getCanonicalizedRequest:method
+                                                    path:path
+                                                   query:query
+                                                 headers:headers
+                                           contentSha256:contentSha256
+                                           signedHeaders:NULL];
+}
+
 + (NSString *)getCanonicalizedQueryString:(NSString *)query {
     NSMutableDictionary *queryDictionary = [NSMutableDictionary new];
     [[query componentsSeparatedByString:@"&"] enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
@@ -427,6 +557,36 @@ NSString *const AWSSignatureV4Terminator = @"aws4_request";
     return [nonWhitespace componentsJoinedByString:@" "];
 }
 
+// Sorts the headers once and emits both the canonical header block and the signed headers list.
++ (NSString *)getCanonicalizedHeaderString:(NSDictionary *)headers signedHeaders:(NSString *__autoreleasing *)signedHeaders {
+    NSArray *sortedHeaders = [[headers allKeys] sortedArrayUsingSelector:@selector(caseInsensitiveCompare:)];
+
+    NSMutableString *headerString = [NSMutableString stringWithCapacity:[sortedHeaders count] * 64];
+    NSMutableString *signedHeadersString = [NSMutableString stringWithCapacity:[sortedHeaders count] * 16];
+    AWSSignatureCanonicalWriter writer = {
+        .string = (__bridge CFMutableStringRef)headerString,
+    };
+
+    for (NSString *header in sortedHeaders) {
+        NSString *lowercaseHeader = [header lowercaseString];
+        if ([signedHeadersString length] > 0) {
+            [signedHeadersString appendString:@";"];
+        }
+        [signedHeadersString appendString:lowercaseHeader];
+
+        AWSSignatureCanonicalWriterAppend(&writer, lowercaseHeader);
+        AWSSignatureCanonicalWriterAppend(&writer, @":");
+        AWSSignatureCanonicalWriterAppend(&writer, [headers objectForKey:header]);
+        AWSSignatureCanonicalWriterAppend(&writer, @"\n");
+    }
+    AWSSignatureCanonicalWriterFlush(&writer);
+
+    if (signedHeaders) {
+        *signedHeaders = signedHeadersString;
+    }
+    return headerString;
+}
+
 + (NSString *)getSignedHeadersString:(NSDictionary *)headers {
     NSMutableArray *sortedHeaders = [[NSMutableArray alloc] initWithArray:[headers allKeys]];
 
@@ -659,7 +819,7 @@ NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427ae41e464
 
 // Signs data
 - (NSData *)getSignedChunk:(NSData *)data {
-    NSString *chunkSha256 = [self dataToHexString:[AWSSignatureSignerUtility hash:data]];
+    NSString *chunkSha256 = [AWSSignatureSignerUtility hexSha256OfData:data];
     NSString *stringToSign = [NSString stringWithFormat:
                               @"%@\n%@\n%@\n%@\n%@\n%@",
                               @"AWS4-HMAC-SHA256-PAYLOAD",
@@ -670,9 +830,8 @@ NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427ae41e464
                               chunkSha256];
     AWSLogDebug(@"AWS4 String to Sign: [%@]", stringToSign);
 
-    NSData *signature = [AWSSignatureSignerUtility sha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
-                                                              withKey:self.kSigning];
-    self.priorSha256 = [self dataToHexString:signature];
+    self.priorSha256 = [AWSSignatureSignerUtility hexSha256HMacWithData:[stringToSign dataUsingEncoding:NSUTF8StringEncoding]
+                                                                withKey:self.kSigning];
     NSString *chunkedHeader = [NSString stringWithFormat:@"%06lx;chunk-signature=%@\r\n", (unsigned long)[data length], self.priorSha256];
     AWSLogDebug(@"AWS4 Chunked Header: [%@]", chunkedHeader);
 
@@ -685,11 +844,6 @@ NSString *const emptyStringSha256 = @"e3b0c44298fc1c149afbf4c8996fb92427ae41e464
     return signedChunk;
 }
 
-- (NSString *)dataToHexString:(NSData *) data {
-    return [AWSSignatureSignerUtility hexEncode:[[NSString alloc] initWithData:data
-                                                                      encoding:NSASCIIStringEncoding]];
-}
-
 #pragma mark NSInputStream methods
 
 - (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
@@ -10,6 +10,168 @@
 
 #import "AWSExecutor.h"
 
+#import <pthread.h>
+#import <libkern/OSAtomic.h>
+
+static const intptr_t AWSWorkStealingExecutorMaxDepth = 20;
+
+// Per-thread recursion depth for the work-stealing executor. The value is stored directly in the
+// key's slot, so reading and updating it needs neither the thread dictionary nor boxing.
+static pthread_key_t AWSWorkStealingDepthKey;
+// The worker a pool thread belongs to, so work submitted from a worker goes to its own deque.
+static pthread_key_t AWSWorkStealingWorkerKey;
+
+#pragma mark - AWSWorkStealingWorker
+
+@interface AWSWorkStealingWorker : NSObject {
+@public
+    pthread_mutex_t _lock;
+    NSMutableArray *_deque;
+}
+
+@end
+
+@implementation AWSWorkStealingWorker
+
+- (instancetype)init {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _deque = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)push:(dispatch_block_t)block {
+    pthread_mutex_lock(&_lock);
+    [_deque addObject:block];
+    pthread_mutex_unlock(&_lock);
+}
+
+// The owning thread takes the most recently pushed block, which is the one most likely to still be warm in cache.
+- (dispatch_block_t)pop {
+    dispatch_block_t block = nil;
+    pthread_mutex_lock(&_lock);
+    block = [_deque lastObject];
+    if (block) {
+        [_deque removeLastObject];
+    }
+    pthread_mutex_unlock(&_lock);
+    return block;
+}
+
+// Other threads take the oldest block from the opposite end so they rarely contend with the owner.
+// A thief never waits for the lock; it reports the contention so the caller scans this deque again.
+- (dispatch_block_t)stealWithContention:(BOOL *)contended {
+    dispatch_block_t block = nil;
+    if (pthread_mutex_trylock(&_lock) != 0) {
+        *contended = YES;
+        return nil;
+    }
+    block = [_deque firstObject];
+    if (block) {
+        [_deque removeObjectAtIndex:0];
+    }
+    pthread_mutex_unlock(&_lock);
+    return block;
+}
+
+@end
+
+#pragma mark - AWSWorkStealingPool
+
+@interface AWSWorkStealingPool : NSObject
+
+@property (nonatomic, strong) NSArray *workers;
+@property (nonatomic, strong) dispatch_semaphore_t available;
+
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount;
+- (void)submit:(dispatch_block_t)block;
+
+@end
+
+@implementation AWSWorkStealingPool {
+    volatile int32_t _nextWorker;
+}
+
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount {
+    if (self = [super init]) {
+        NSMutableArray *workers = [NSMutableArray arrayWithCapacity:workerCount];
+        for (NSUInteger i = 0; i < workerCount; i++) {
+            [workers addObject:[AWSWorkStealingWorker new]];
+        }
+        _workers = workers;
+        _available = dispatch_semaphore_create(0);
+
+        for (NSUInteger i = 0; i < workerCount; i++) {
+            NSThread *thread = [[NSThread alloc] initWithTarget:self
+                                                       selector:@selector(runWorkerAtIndex:)
+                                                         object:@(i)];
+            thread.name = [NSString stringWithFormat:@"com.amazonaws.AWSExecutor.worker.%lu", (unsigned long)i];
+            [thread start];
+        }
+    }
+    return self;
+}
+
+- (void)submit:(dispatch_block_t)block {
+    AWSWorkStealingWorker *worker = (__bridge AWSWorkStealingWorker *)pthread_getspecific(AWSWorkStealingWorkerKey);
+    if (!worker) {
+        uint32_t index = (uint32_t)OSAtomicIncrement32(&_nextWorker);
+        worker = self.workers[index % self.workers.count];
+    }
+    [worker push:[block copy]];
+    dispatch_semaphore_signal(self.available);
+}
+
+- (dispatch_block_t)nextBlockForWorkerAtIndex:(NSUInteger)index {
+    AWSWorkStealingWorker *worker = self.workers[index];
+    dispatch_block_t block = [worker pop];
+    if (block) {
+        return block;
+    }
+    // A deque that was locked during the scan may still hold work, so only give up after a scan
+    // that saw every deque and found them all empty.
+    NSUInteger count = self.workers.count;
+    BOOL contended = NO;
+    do {
+        contended = NO;
+        for (NSUInteger offset = 1; offset < count; offset++) {
+            block = [self.workers[(index + offset) % count] stealWithContention:&contended];
+            if (block) {
+                return block;
+            }
+        }
+        if (contended) {
+            sched_yield();
+        }
+    } while (contended);
+    return nil;
+}
+
+- (void)runWorkerAtIndex:(NSNumber *)index {
+    NSUInteger workerIndex = [index unsignedIntegerValue];
+    pthread_setspecific(AWSWorkStealingWorkerKey, (__bridge void *)self.workers[workerIndex]);
+    while (YES) {
+        @autoreleasepool {
+            dispatch_block_t block = [self nextBlockForWorkerAtIndex:workerIndex];
+            if (block) {
+                block();
+            } else {
+                // Every submit signals once, so a worker only sleeps when there is nothing left to steal.
+                dispatch_semaphore_wait(self.available, DISPATCH_TIME_FOREVER);
+            }
+        }
+    }
+}
+
+@end
+
+#pragma mark - AWSExecutor
+
 @interface AWSExecutor ()
 
 @property (nonatomic, copy) void(^block)(void(^block)());
@@ -52,6 +214,32 @@
     return defaultExecutor;
 }
 
++ (instancetype)workStealingExecutor {
+    static AWSExecutor *workStealingExecutor = NULL;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&AWSWorkStealingDepthKey, NULL);
+        pthread_key_create(&AWSWorkStealingWorkerKey, NULL);
+        NSUInteger workerCount = MAX([[NSProcessInfo processInfo] activeProcessorCount], 2);
+        AWSWorkStealingPool *pool = [[AWSWorkStealingPool alloc] initWithWorkerCount:workerCount];
+
+        workStealingExecutor = [self executorWithBlock:^void(void(^block)()) {
+            intptr_t depth = (intptr_t)pthread_getspecific(AWSWorkStealingDepthKey);
+            if (depth > AWSWorkStealingExecutorMaxDepth) {
+                [pool submit:block];
+            } else {
+                pthread_setspecific(AWSWorkStealingDepthKey, (void *)(depth + 1));
+                @try {
+                    block();
+                } @finally {
+                    pthread_setspecific(AWSWorkStealingDepthKey, (void *)depth);
+                }
+            }
+        }];
+    });
+    return workStealingExecutor;
+}
+
 + (instancetype)immediateExecutor {
     static AWSExecutor *immediateExecutor = NULL;
     static dispatch_once_t onceToken;
@@ -22,19 +22,39 @@ __attribute__ ((noinline)) void awsbf_warnBlockingOperationOnMainThread() {
 NSString *const AWSTaskErrorDomain = @"bolts";
 NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsException";
 
+// The completion state of a task lives in a single atomic word. A task moves from pending to
+// completing exactly once (the winner of the compare-and-swap owns the result fields), and then
+// publishes its final state with a barrier so readers never need a lock.
+static const int32_t AWSTaskStatePending = 0;
+static const int32_t AWSTaskStateCompleting = 1 << 0;
+static const int32_t AWSTaskStateCompleted = 1 << 1;
+static const int32_t AWSTaskStateFaulted = 1 << 2;
+static const int32_t AWSTaskStateCancelled = 1 << 3;
+
+// Continuations are kept in an append-only, lock-free singly linked list. Completion swaps the
+// head for a sentinel, after which appends fail and callers run their continuation inline.
+typedef struct AWSTaskContinuation {
+    struct AWSTaskContinuation *next;
+    void *block;
+} AWSTaskContinuation;
+
+static AWSTaskContinuation AWSTaskContinuationsClosed;
+
+static inline int32_t AWSTaskLoadState(volatile int32_t *state) {
+    int32_t value = *state;
+    OSMemoryBarrier();
+    return value;
+}
+
 @interface AWSTask () {
     id _result;
     NSError *_error;
     NSException *_exception;
-}
 
-@property (atomic, assign, readwrite, getter = isCancelled) BOOL cancelled;
-@property (atomic, assign, readwrite, getter = isFaulted) BOOL faulted;
-@property (atomic, assign, readwrite, getter = isCompleted) BOOL completed;
-
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
+    volatile int32_t _state;
+    AWSTaskContinuation * volatile _continuations;
+    void * volatile _condition;
+}
 
 @end
 
@@ -42,13 +62,19 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
 
 #pragma mark - Initializer
 
-- (instancetype)init {
-    if (self = [super init]) {
-        _lock = [[NSObject alloc] init];
-        _condition = [[NSCondition alloc] init];
-        _callbacks = [NSMutableArray array];
+- (void)dealloc {
+    AWSTaskContinuation *continuation = _continuations;
+    if (continuation != &AWSTaskContinuationsClosed) {
+        while (continuation) {
+            AWSTaskContinuation *next = continuation->next;
+            CFRelease(continuation->block);
+            free(continuation);
+            continuation = next;
+        }
+    }
+    if (_condition) {
+        CFRelease(_condition);
     }
-    return self;
 }
 
 #pragma mark - Task Class methods
@@ -158,9 +184,10 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
 #pragma mark - Custom Setters/Getters
 
 - (id)result {
-    @synchronized (self.lock) {
-        return _result;
+    if (!(AWSTaskLoadState(&_state) & AWSTaskStateCompleted)) {
+        return nil;
     }
+    return _result;
 }
 
 - (void)setResult:(id)result {
@@ -171,21 +198,19 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
 }
 
 - (BOOL)trySetResult:(id)result {
-    @synchronized (self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    _result = result;
+    [self finishCompletionWithState:AWSTaskStateCompleted];
+    return YES;
 }
 
 - (NSError *)error {
-    @synchronized (self.lock) {
-        return _error;
+    if (!(AWSTaskLoadState(&_state) & AWSTaskStateCompleted)) {
+        return nil;
     }
+    return _error;
 }
 
 - (void)setError:(NSError *)error {
@@ -196,22 +221,19 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
 }
 
 - (BOOL)trySetError:(NSError *)error {
-    @synchronized (self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    _error = error;
+    [self finishCompletionWithState:AWSTaskStateCompleted | AWSTaskStateFaulted];
+    return YES;
 }
 
 - (NSException *)exception {
-    @synchronized (self.lock) {
-        return _exception;
+    if (!(AWSTaskLoadState(&_state) & AWSTaskStateCompleted)) {
+        return nil;
     }
+    return _exception;
 }
 
 - (void)setException:(NSException *)exception {
@@ -222,72 +244,100 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
 }
 
 - (BOOL)trySetException:(NSException *)exception {
-    @synchronized (self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _exception = exception;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    _exception = exception;
+    [self finishCompletionWithState:AWSTaskStateCompleted | AWSTaskStateFaulted];
+    return YES;
 }
 
 - (BOOL)isCancelled {
-    @synchronized (self.lock) {
-        return _cancelled;
-    }
+    return (AWSTaskLoadState(&_state) & AWSTaskStateCancelled) != 0;
 }
 
 - (BOOL)isFaulted {
-    @synchronized (self.lock) {
-        return _faulted;
-    }
+    return (AWSTaskLoadState(&_state) & AWSTaskStateFaulted) != 0;
 }
 
 - (void)cancel {
-    @synchronized (self.lock) {
-        if (![self trySetCancelled]) {
-            [NSException raise:NSInternalInconsistencyException
-                        format:@"Cannot cancel a completed task."];
-        }
+    if (![self trySetCancelled]) {
+        [NSException raise:NSInternalInconsistencyException
+                    format:@"Cannot cancel a completed task."];
     }
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized (self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompletion]) {
+        return NO;
     }
+    [self finishCompletionWithState:AWSTaskStateCompleted | AWSTaskStateCancelled];
+    return YES;
 }
 
 - (BOOL)isCompleted {
-    @synchronized (self.lock) {
-        return _completed;
+    return (AWSTaskLoadState(&_state) & AWSTaskStateCompleted) != 0;
+}
+
+#pragma mark - Completion
+
+- (BOOL)beginCompletion {
+    return OSAtomicCompareAndSwap32Barrier(AWSTaskStatePending, AWSTaskStateCompleting, &_state);
+}
+
+- (void)finishCompletionWithState:(int32_t)state {
+    // Only the thread that won beginCompletion gets here, so this swap cannot fail. The barrier
+    // orders the result fields before the state, and the state before the condition read below.
+    OSAtomicCompareAndSwap32Barrier(AWSTaskStateCompleting, state, &_state);
+
+    void *condition = _condition;
+    if (condition) {
+        NSCondition *waitCondition = (__bridge NSCondition *)condition;
+        [waitCondition lock];
+        [waitCondition broadcast];
+        [waitCondition unlock];
     }
+
+    [self runContinuations];
 }
 
-- (void)setCompleted {
-    @synchronized (self.lock) {
-        _completed = YES;
+- (BOOL)appendContinuation:(void(^)())block {
+    AWSTaskContinuation *continuation = malloc(sizeof(AWSTaskContinuation));
+    continuation->block = (__bridge_retained void *)[block copy];
+    while (YES) {
+        AWSTaskContinuation *head = _continuations;
+        if (head == &AWSTaskContinuationsClosed) {
+            CFRelease(continuation->block);
+            free(continuation);
+            return NO;
+        }
+        continuation->next = head;
+        if (OSAtomicCompareAndSwapPtrBarrier(head, continuation, (void * volatile *)&_continuations)) {
+            return YES;
+        }
     }
 }
 
 - (void)runContinuations {
-    @synchronized (self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)() in self.callbacks) {
-            callback();
-        }
-        [self.callbacks removeAllObjects];
+    AWSTaskContinuation *head;
+    do {
+        head = _continuations;
+    } while (!OSAtomicCompareAndSwapPtrBarrier(head, &AWSTaskContinuationsClosed, (void * volatile *)&_continuations));
+
+    // The list was built by prepending, so reverse it to run continuations in the order they were added.
+    AWSTaskContinuation *ordered = NULL;
+    while (head) {
+        AWSTaskContinuation *next = head->next;
+        head->next = ordered;
+        ordered = head;
+        head = next;
+    }
+    while (ordered) {
+        AWSTaskContinuation *next = ordered->next;
+        void (^callback)() = (__bridge_transfer void(^)())ordered->block;
+        free(ordered);
+        callback();
+        ordered = next;
     }
 }
 
@@ -326,14 +376,7 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
         }];
     };
 
-    BOOL completed;
-    @synchronized (self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[wrappedBlock copy]];
-        }
-    }
-    if (completed) {
+    if (self.completed || ![self appendContinuation:wrappedBlock]) {
         wrappedBlock();
     }
 
@@ -365,34 +408,43 @@ NSString *const AWSTaskMultipleExceptionsException = @"BFMultipleExceptionsExcep
     awsbf_warnBlockingOperationOnMainThread();
 }
 
+- (NSCondition *)waitCondition {
+    // Almost no task is ever waited on, so the condition is only created the first time it is needed.
+    void *condition = _condition;
+    if (!condition) {
+        void *newCondition = (__bridge_retained void *)[[NSCondition alloc] init];
+        if (!OSAtomicCompareAndSwapPtrBarrier(NULL, newCondition, &_condition)) {
+            CFRelease(newCondition);
+        }
+        condition = _condition;
+    }
+    return (__bridge NSCondition *)condition;
+}
+
 - (void)waitUntilFinished {
     if ([NSThread isMainThread]) {
         [self warnOperationOnMainThread];
     }
 
-    @synchronized (self.lock) {
-        if (self.completed) {
-            return;
-        }
-        [self.condition lock];
+    if (self.completed) {
+        return;
     }
-    [self.condition wait];
-    [self.condition unlock];
+    NSCondition *condition = [self waitCondition];
+    [condition lock];
+    while (!self.completed) {
+        [condition wait];
+    }
+    [condition unlock];
 }
 
 #pragma mark - NSObject
 
 - (NSString *)description {
-    // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-
-    @synchronized (self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-    }
+    // Snapshot the state word once so the flags are consistent with each other
+    int32_t state = AWSTaskLoadState(&_state);
+    BOOL completed = (state & AWSTaskStateCompleted) != 0;
+    BOOL cancelled = (state & AWSTaskStateCancelled) != 0;
+    BOOL faulted = (state & AWSTaskStateFaulted) != 0;
 
     // Description string includes status information and, if available, the
     // result sisnce in some ways this is what a promise actually "is".
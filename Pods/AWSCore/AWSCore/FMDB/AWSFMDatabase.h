@@ -86,6 +86,9 @@ typedef int(^AWSFMDBExecuteStatementsCallbackBlock)(NSDictionary *resultsDiction
     NSTimeInterval      _startBusyRetryTime;
     
     NSMutableDictionary *_cachedStatements;
+    NSUInteger          _maximumCachedStatementCount;
+    NSUInteger          _cachedStatementHitCount;
+    NSUInteger          _cachedStatementMissCount;
     NSMutableSet        *_openResultSets;
     NSMutableSet        *_openFunctions;
 
@@ -112,10 +115,28 @@ typedef int(^AWSFMDBExecuteStatementsCallbackBlock)(NSDictionary *resultsDiction
 
 @property (atomic, assign) BOOL logsErrors;
 
-/** Dictionary of cached statements */
+/** Dictionary of cached statements, keyed by SQL string
+ 
+ Each value is an opaque cache entry holding the free statements prepared for that query. Use `<clearCachedStatements>` rather than mutating this dictionary directly.
+ */
 
 @property (atomic, retain) NSMutableDictionary *cachedStatements;
 
+/** The maximum number of prepared statements kept by the statement cache
+ 
+ When the cache grows past this count, the statements of the least recently used query are finalized. `0` means unbounded. Defaults to `64`.
+ */
+
+@property (atomic, assign) NSUInteger maximumCachedStatementCount;
+
+/** Number of queries that reused a free cached statement */
+
+@property (atomic, readonly) NSUInteger cachedStatementHitCount;
+
+/** Number of queries that had to prepare a new statement while caching was enabled */
+
+@property (atomic, readonly) NSUInteger cachedStatementMissCount;
+
 ///---------------------
 /// @name Initialization
 ///---------------------
@@ -622,7 +643,10 @@ typedef int(^AWSFMDBExecuteStatementsCallbackBlock)(NSDictionary *resultsDiction
 /// @name Cached statements and result sets
 ///----------------------------------------
 
-/** Clear cached statements */
+/** Clear cached statements
+ 
+ Free statements are finalized immediately; statements still held by open result sets are finalized when those result sets close.
+ */
 
 - (void)clearCachedStatements;
 
@@ -2,7 +2,47 @@
 #import "unistd.h"
 #import <objc/runtime.h>
 
-@interface AWSFMDatabase ()
+static NSUInteger const AWSFMDatabaseDefaultMaximumCachedStatementCount = 64;
+
+@class AWSFMStatementCacheEntry;
+
+@interface AWSFMStatement ()
+
+@property (atomic, retain) AWSFMStatementCacheEntry *cacheEntry;
+
+- (void)returnToCache;
+
+@end
+
+// One query's slot in the statement cache. Free statements sit on a stack so
+// checkout and checkin are O(1). A checked-out statement retains its entry and
+// comes back through -[AWSFMStatement reset]. Entries are linked in recency
+// order by the owning database, which evicts from the tail. _statements holds
+// every statement, free or not, so closing the database can finalize them all.
+@interface AWSFMStatementCacheEntry : NSObject {
+@public
+    NSString *_query;
+    NSMutableArray *_statements;
+    NSMutableArray *_freeStatements;
+    __unsafe_unretained AWSFMDatabase *_database;
+    __unsafe_unretained AWSFMStatementCacheEntry *_previous;
+    __unsafe_unretained AWSFMStatementCacheEntry *_next;
+}
+
+- (instancetype)initWithQuery:(NSString *)query database:(AWSFMDatabase *)database;
+- (void)checkInStatement:(AWSFMStatement *)statement;
+- (void)invalidate;
+
+@end
+
+@interface AWSFMDatabase () {
+    // Unretained; _cachedStatements owns the entries.
+    __unsafe_unretained AWSFMStatementCacheEntry *_mostRecentStatementEntry;
+    __unsafe_unretained AWSFMStatementCacheEntry *_leastRecentStatementEntry;
+    NSUInteger _cachedStatementCount;
+}
+
+- (void)statementCacheEntryDidDiscardStatement:(AWSFMStatementCacheEntry *)entry;
 
 - (AWSFMResultSet *)executeQuery:(NSString *)sql withArgumentsInArray:(NSArray*)arrayArgs orDictionary:(NSDictionary *)dictionaryArgs orVAList:(va_list)args;
 - (BOOL)executeUpdate:(NSString*)sql error:(NSError**)outErr withArgumentsInArray:(NSArray*)arrayArgs orDictionary:(NSDictionary *)dictionaryArgs orVAList:(va_list)args;
@@ -11,6 +51,8 @@
 
 @implementation AWSFMDatabase
 @synthesize cachedStatements=_cachedStatements;
+@synthesize cachedStatementHitCount=_cachedStatementHitCount;
+@synthesize cachedStatementMissCount=_cachedStatementMissCount;
 @synthesize logsErrors=_logsErrors;
 @synthesize crashOnErrors=_crashOnErrors;
 @synthesize checkedOut=_checkedOut;
@@ -39,6 +81,7 @@
         _logsErrors                 = YES;
         _crashOnErrors              = NO;
         _maxBusyRetryTimeInterval   = 2;
+        _maximumCachedStatementCount = AWSFMDatabaseDefaultMaximumCachedStatementCount;
     }
     
     return self;
@@ -306,43 +349,139 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
 
 #pragma mark Cached statements
 
+- (NSUInteger)maximumCachedStatementCount {
+    return _maximumCachedStatementCount;
+}
+
+- (void)setMaximumCachedStatementCount:(NSUInteger)count {
+    _maximumCachedStatementCount = count;
+    [self trimCachedStatementsToCount:count];
+}
+
 - (void)clearCachedStatements {
     
-    for (NSMutableSet *statements in [_cachedStatements objectEnumerator]) {
-        [statements makeObjectsPerformSelector:@selector(close)];
+    // Statements held by open result sets keep working; they are finalized when they come back.
+    for (AWSFMStatementCacheEntry *entry in [_cachedStatements objectEnumerator]) {
+        [entry invalidate];
     }
     
     [_cachedStatements removeAllObjects];
+    
+    _mostRecentStatementEntry = nil;
+    _leastRecentStatementEntry = nil;
+    _cachedStatementCount = 0;
 }
 
-- (AWSFMStatement*)cachedStatementForQuery:(NSString*)query {
+- (AWSFMStatementCacheEntry *)statementCacheEntryForQuery:(NSString *)query {
+    
+    // The entry copied its key, so pointer equality only happens for an immutable
+    // string we have already seen. SQL literals hit this and skip hashing.
+    AWSFMStatementCacheEntry *entry = _mostRecentStatementEntry;
+    if (entry && entry->_query == query) {
+        return entry;
+    }
+    
+    return [_cachedStatements objectForKey:query];
+}
+
+- (void)moveStatementEntryToFront:(AWSFMStatementCacheEntry *)entry {
     
-    NSMutableSet* statements = [_cachedStatements objectForKey:query];
+    if (_mostRecentStatementEntry == entry) {
+        return;
+    }
     
-    return [[statements objectsPassingTest:^BOOL(AWSFMStatement* statement, BOOL *stop) {
+    if (entry->_previous) {
+        entry->_previous->_next = entry->_next;
+    }
+    if (entry->_next) {
+        entry->_next->_previous = entry->_previous;
+    }
+    if (_leastRecentStatementEntry == entry) {
+        _leastRecentStatementEntry = entry->_previous;
+    }
+    
+    entry->_previous = nil;
+    entry->_next = _mostRecentStatementEntry;
+    if (_mostRecentStatementEntry) {
+        _mostRecentStatementEntry->_previous = entry;
+    }
+    _mostRecentStatementEntry = entry;
+    
+    if (!_leastRecentStatementEntry) {
+        _leastRecentStatementEntry = entry;
+    }
+}
+
+- (void)trimCachedStatementsToCount:(NSUInteger)count {
+    
+    if (count == 0) {
+        return;
+    }
+    
+    // Never evict the most recent entry; it belongs to the statement being executed.
+    while (_cachedStatementCount > count && _leastRecentStatementEntry && _leastRecentStatementEntry != _mostRecentStatementEntry) {
+        AWSFMStatementCacheEntry *entry = _leastRecentStatementEntry;
+        
+        AWSFMDBRetain(entry);
         
-        *stop = ![statement inUse];
-        return *stop;
+        _leastRecentStatementEntry = entry->_previous;
+        _leastRecentStatementEntry->_next = nil;
+        _cachedStatementCount -= [entry->_statements count];
         
-    }] anyObject];
+        // Statements still held by open result sets are left alone and dropped when they reset.
+        [entry invalidate];
+        [_cachedStatements removeObjectForKey:entry->_query];
+        
+        AWSFMDBRelease(entry);
+    }
 }
 
+- (AWSFMStatement*)cachedStatementForQuery:(NSString*)query {
+    
+    AWSFMStatementCacheEntry *entry = [self statementCacheEntryForQuery:query];
+    AWSFMStatement *statement = entry ? [entry->_freeStatements lastObject] : nil;
+    
+    if (!statement) {
+        _cachedStatementMissCount++;
+        return nil;
+    }
+    
+    AWSFMDBRetain(statement);
+    [entry->_freeStatements removeLastObject];
+    [self moveStatementEntryToFront:entry];
+    
+    sqlite3_reset([statement statement]);
+    [statement setCacheEntry:entry];
+    
+    _cachedStatementHitCount++;
+    
+    return AWSFMDBReturnAutoreleased(statement);
+}
 
 - (void)setCachedStatement:(AWSFMStatement*)statement forQuery:(NSString*)query {
     
-    query = [query copy]; // in case we got handed in a mutable string...
-    [statement setQuery:query];
+    AWSFMStatementCacheEntry *entry = [self statementCacheEntryForQuery:query];
     
-    NSMutableSet* statements = [_cachedStatements objectForKey:query];
-    if (!statements) {
-        statements = [NSMutableSet set];
+    if (!entry) {
+        entry = [[AWSFMStatementCacheEntry alloc] initWithQuery:query database:self];
+        [_cachedStatements setObject:entry forKey:entry->_query];
+        AWSFMDBRelease(entry);
     }
     
-    [statements addObject:statement];
+    [self moveStatementEntryToFront:entry];
     
-    [_cachedStatements setObject:statements forKey:query];
+    // The statement is checked out until it is reset, at which point it joins the free list.
+    [statement setQuery:entry->_query];
+    [statement setCacheEntry:entry];
     
-    AWSFMDBRelease(query);
+    [entry->_statements addObject:statement];
+    _cachedStatementCount++;
+    
+    [self trimCachedStatementsToCount:_maximumCachedStatementCount];
+}
+
+- (void)statementCacheEntryDidDiscardStatement:(AWSFMStatementCacheEntry *)entry {
+    _cachedStatementCount--;
 }
 
 #pragma mark Key routines
@@ -753,7 +892,6 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     if (_shouldCacheStatements) {
         statement = [self cachedStatementForQuery:sql];
         pStmt = statement ? [statement statement] : 0x00;
-        [statement reset];
     }
     
     if (!pStmt) {
@@ -842,7 +980,12 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     
     if (idx != queryCount) {
         NSLog(@"Error: the bind count is not correct for the # of variables (executeQuery)");
-        sqlite3_finalize(pStmt);
+        if (statement) {
+            [statement close];
+        }
+        else {
+            sqlite3_finalize(pStmt);
+        }
         _isExecutingStatement = NO;
         return nil;
     }
@@ -931,7 +1074,6 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     if (_shouldCacheStatements) {
         cachedStmt = [self cachedStatementForQuery:sql];
         pStmt = cachedStmt ? [cachedStmt statement] : 0x00;
-        [cachedStmt reset];
     }
     
     if (!pStmt) {
@@ -1025,7 +1167,12 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     
     if (idx != queryCount) {
         NSLog(@"Error: the bind count (%d) is not correct for the # of variables in the query (%d) (%@) (executeUpdate)", idx, queryCount, sql);
-        sqlite3_finalize(pStmt);
+        if (cachedStmt) {
+            [cachedStmt close];
+        }
+        else {
+            sqlite3_finalize(pStmt);
+        }
         _isExecutingStatement = NO;
         return NO;
     }
@@ -1071,7 +1218,7 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
         
         [self setCachedStatement:cachedStmt forQuery:sql];
         
-        AWSFMDBRelease(cachedStmt);
+        AWSFMDBAutorelease(cachedStmt);
     }
     
     int closeErrorCode;
@@ -1079,6 +1226,7 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     if (cachedStmt) {
         [cachedStmt setUseCount:[cachedStmt useCount] + 1];
         closeErrorCode = sqlite3_reset(pStmt);
+        [cachedStmt returnToCache];
     }
     else {
         /* Finalize the virtual machine. This releases all memory and other
@@ -1340,6 +1488,7 @@ static NSString *AWSFMDBEscapeSavePointName(NSString *savepointName) {
     }
     
     if (!_shouldCacheStatements) {
+        [self clearCachedStatements];
         [self setCachedStatements:nil];
     }
 }
@@ -1379,11 +1528,66 @@ void AWSFMDBBlockSQLiteCallBackFunction(sqlite3_context *context, int argc, sqli
 
 
 
+@implementation AWSFMStatementCacheEntry
+
+- (instancetype)initWithQuery:(NSString *)query database:(AWSFMDatabase *)database {
+    self = [super init];
+    if (self) {
+        _query = [query copy]; // in case we got handed in a mutable string...
+        _statements = [[NSMutableArray alloc] init];
+        _freeStatements = [[NSMutableArray alloc] init];
+        _database = database;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    AWSFMDBRelease(_query);
+    AWSFMDBRelease(_statements);
+    AWSFMDBRelease(_freeStatements);
+#if ! __has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+- (void)checkInStatement:(AWSFMStatement *)statement {
+    
+    if (_database && [statement statement]) {
+        [_freeStatements addObject:statement];
+        return;
+    }
+    
+    // Either the entry was evicted or cleared, or the statement was closed while
+    // checked out, e.g. after a bind error. Either way it cannot be reused.
+    [_statements removeObjectIdenticalTo:statement];
+    [_database statementCacheEntryDidDiscardStatement:self];
+    [statement close];
+}
+
+// Closes the free statements. Checked-out ones are closed when they are checked back in.
+- (void)invalidate {
+    _database = nil;
+    _previous = nil;
+    _next = nil;
+    
+    NSArray *statements = [_freeStatements copy];
+    
+    [_statements removeObjectsInArray:statements];
+    [_freeStatements removeAllObjects];
+    [statements makeObjectsPerformSelector:@selector(close)];
+    
+    AWSFMDBRelease(statements);
+}
+
+@end
+
+
 @implementation AWSFMStatement
 @synthesize statement=_statement;
 @synthesize query=_query;
 @synthesize useCount=_useCount;
 @synthesize inUse=_inUse;
+@synthesize cacheEntry=_cacheEntry;
 
 - (void)finalize {
     [self close];
@@ -1393,6 +1597,7 @@ void AWSFMDBBlockSQLiteCallBackFunction(sqlite3_context *context, int argc, sqli
 - (void)dealloc {
     [self close];
     AWSFMDBRelease(_query);
+    AWSFMDBRelease(_cacheEntry);
 #if ! __has_feature(objc_arc)
     [super dealloc];
 #endif
@@ -1405,6 +1610,7 @@ void AWSFMDBBlockSQLiteCallBackFunction(sqlite3_context *context, int argc, sqli
     }
     
     _inUse = NO;
+    [self returnToCache];
 }
 
 - (void)reset {
@@ -1413,6 +1619,20 @@ void AWSFMDBBlockSQLiteCallBackFunction(sqlite3_context *context, int argc, sqli
     }
     
     _inUse = NO;
+    [self returnToCache];
+}
+
+- (void)returnToCache {
+    AWSFMStatementCacheEntry *entry = _cacheEntry;
+    
+    if (!entry) {
+        return;
+    }
+    
+    AWSFMDBRetain(entry);
+    [self setCacheEntry:nil];
+    [entry checkInStatement:self];
+    AWSFMDBRelease(entry);
 }
 
 - (NSString*)description {
@@ -41,6 +41,8 @@
     
     NSUInteger          _maximumNumberOfDatabasesToCreate;
     int                 _openFlags;
+    
+    NSTimeInterval      _maximumIdleInterval;
 }
 
 /** Database path */
@@ -51,10 +53,20 @@
 
 @property (atomic, assign) id delegate;
 
-/** Maximum number of databases to create */
+/** Maximum number of databases to create
+ 
+ Once this many databases are checked out, `<inDatabase:>` and the other non-waiting methods get a `nil` database, while checkouts given a timeout wait in FIFO order for one to be returned. `0` means unbounded. Raising the limit, or calling `<releaseAllDatabases>`, hands new databases to waiting checkouts right away.
+ */
 
 @property (atomic, assign) NSUInteger maximumNumberOfDatabasesToCreate;
 
+/** How long a checked-in database may sit unused before the pool closes it
+ 
+ `0` keeps idle databases open until `<releaseAllDatabases>`. Defaults to 60 seconds.
+ */
+
+@property (atomic, assign) NSTimeInterval maximumIdleInterval;
+
 /** Open flags */
 
 @property (atomic, readonly) int openFlags;
@@ -131,17 +143,82 @@
 
 - (void)releaseAllDatabases;
 
+/** Close checked-in databases that have been idle longer than `<maximumIdleInterval>`.
+ 
+ The pool does this on its own; call it to trim immediately, e.g. on a memory warning.
+ */
+
+- (void)closeIdleDatabases;
+
+///---------------------------------------------
+/// @name Checking databases out and back in
+///---------------------------------------------
+
+/** Asynchronously check out a database.
+ 
+ Checked-in databases are reused without being reopened. When the pool is at `<maximumNumberOfDatabasesToCreate>`, the request waits behind earlier ones until a database is checked back in.
+ 
+ @param timeout Seconds to wait. A negative value waits indefinitely; `0` fails immediately when none is free.
+ @param handler Called on a global queue with the database, or with `nil` and an error on timeout or open failure. Pass the database to `<checkInDatabase:>` when done.
+ */
+
+- (void)checkOutDatabaseWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(AWSFMDatabase *db, NSError *error))handler;
+
+/** Synchronously check out a database, waiting up to `timeout`.
+ 
+ @param timeout Seconds to wait. A negative value waits indefinitely; `0` fails immediately when none is free.
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return The database, or `nil` on timeout or open failure. Pass it to `<checkInDatabase:>` when done.
+ 
+ @warning Do not call this while holding a database from the same pool if the pool is bounded; you can wait on yourself.
+ */
+
+- (AWSFMDatabase *)checkOutDatabaseWithTimeout:(NSTimeInterval)timeout error:(NSError **)outErr;
+
+/** Return a database obtained from one of the checkout methods.
+ 
+ If callers are waiting, the database goes straight to the one that has waited longest.
+ 
+ @param db The database to return. `nil` is ignored.
+ */
+
+- (void)checkInDatabase:(AWSFMDatabase *)db;
+
+/** Histogram of how long checkouts waited for a database
+ 
+ @return Eight `NSNumber` counts for waits under 1 ms, 5 ms, 10 ms, 50 ms, 100 ms, 500 ms and 1 s, and 1 s or more. Timed-out checkouts are included.
+ */
+
+- (NSArray *)waitTimeHistogram;
+
+/** Reset the counts returned by `<waitTimeHistogram>` */
+
+- (void)resetWaitTimeHistogram;
+
 ///------------------------------------------
 /// @name Perform database operations in pool
 ///------------------------------------------
 
 /** Synchronously perform database operations in pool.
 
+ Never waits: when the pool is at `<maximumNumberOfDatabasesToCreate>` the block is called with a `nil` database.
+
  @param block The code to be run on the `FMDatabasePool` pool.
  */
 
 - (void)inDatabase:(void (^)(AWSFMDatabase *db))block;
 
+/** Synchronously perform database operations in pool, waiting for a database if none is free.
+
+ @param timeout Seconds to wait. A negative value waits indefinitely; `0` behaves like `<inDatabase:>`.
+ @param block The code to be run on the `FMDatabasePool` pool. Called with a `nil` database if the wait times out.
+
+ @warning Do not call this while holding a database from the same pool if the pool is bounded; you can wait on yourself.
+ */
+
+- (void)inDatabaseWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db))block;
+
 /** Synchronously perform database operations in pool using transaction.
 
  @param block The code to be run on the `FMDatabasePool` pool.
@@ -156,6 +233,22 @@
 
 - (void)inDeferredTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block;
 
+/** Synchronously perform database operations in pool using transaction, waiting for a database if none is free.
+
+ @param timeout Seconds to wait. A negative value waits indefinitely; `0` behaves like `<inTransaction:>`.
+ @param block The code to be run on the `FMDatabasePool` pool. Called with a `nil` database if the wait times out.
+ */
+
+- (void)inTransactionWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db, BOOL *rollback))block;
+
+/** Synchronously perform database operations in pool using deferred transaction, waiting for a database if none is free.
+
+ @param timeout Seconds to wait. A negative value waits indefinitely; `0` behaves like `<inDeferredTransaction:>`.
+ @param block The code to be run on the `FMDatabasePool` pool. Called with a `nil` database if the wait times out.
+ */
+
+- (void)inDeferredTransactionWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db, BOOL *rollback))block;
+
 #if SQLITE_VERSION_NUMBER >= 3007000
 
 /** Synchronously perform database operations in pool using save point.
@@ -182,6 +275,8 @@
 
 /** Asks the delegate whether database should be added to the pool. 
  
+ Asked once per database, right after the pool creates and opens it. Databases checked back in are reused without asking again. Returning `NO` closes the database and fails that checkout.
+ 
  @param pool     The `FMDatabasePool` object.
  @param database The `FMDatabase` object.
  
@@ -9,10 +9,39 @@
 #import "AWSFMDatabasePool.h"
 #import "AWSFMDatabase.h"
 
-@interface AWSFMDatabasePool()
+#define AWSFMDatabasePoolWaitBucketCount 8
+
+static const NSTimeInterval AWSFMDatabasePoolWaitBucketBounds[AWSFMDatabasePoolWaitBucketCount - 1] = {0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0};
+
+// A caller queued for a database while the pool is at its limit.
+@interface AWSFMDatabasePoolWaiter : NSObject
+
+@property (nonatomic, copy) void (^handler)(AWSFMDatabase *db, NSError *error);
+@property (nonatomic, assign) NSTimeInterval enqueueTime;
+
+@end
+
+@implementation AWSFMDatabasePoolWaiter
+
+- (void)dealloc {
+    AWSFMDBRelease(_handler);
+#if ! __has_feature(objc_arc)
+    [super dealloc];
+#endif
+}
+
+@end
+
+@interface AWSFMDatabasePool() {
+    NSMutableArray      *_checkInTimes; // parallel to _databaseInPool, oldest first
+    NSMutableArray      *_waiters;
+    NSUInteger          _waitTimeHistogram[AWSFMDatabasePoolWaitBucketCount];
+    BOOL                _idleReapScheduled;
+}
 
 - (void)pushDatabaseBackInPool:(AWSFMDatabase*)db;
 - (AWSFMDatabase*)db;
+- (AWSFMDatabase*)dbWithTimeout:(NSTimeInterval)timeout;
 
 @end
 
@@ -20,8 +49,8 @@
 @implementation AWSFMDatabasePool
 @synthesize path=_path;
 @synthesize delegate=_delegate;
-@synthesize maximumNumberOfDatabasesToCreate=_maximumNumberOfDatabasesToCreate;
 @synthesize openFlags=_openFlags;
+@synthesize maximumIdleInterval=_maximumIdleInterval;
 
 
 + (instancetype)databasePoolWithPath:(NSString*)aPath {
@@ -41,7 +70,10 @@
         _lockQueue          = dispatch_queue_create([[NSString stringWithFormat:@"fmdb.%@", self] UTF8String], NULL);
         _databaseInPool     = AWSFMDBReturnRetained([NSMutableArray array]);
         _databaseOutPool    = AWSFMDBReturnRetained([NSMutableArray array]);
+        _checkInTimes       = AWSFMDBReturnRetained([NSMutableArray array]);
+        _waiters            = AWSFMDBReturnRetained([NSMutableArray array]);
         _openFlags          = openFlags;
+        _maximumIdleInterval = 60;
     }
     
     return self;
@@ -64,6 +96,8 @@
     AWSFMDBRelease(_path);
     AWSFMDBRelease(_databaseInPool);
     AWSFMDBRelease(_databaseOutPool);
+    AWSFMDBRelease(_checkInTimes);
+    AWSFMDBRelease(_waiters);
     
     if (_lockQueue) {
         AWSFMDBDispatchQueueRelease(_lockQueue);
@@ -79,6 +113,251 @@
     dispatch_sync(_lockQueue, aBlock);
 }
 
+- (NSUInteger)maximumNumberOfDatabasesToCreate {
+    
+    __block NSUInteger maximum;
+    
+    [self executeLocked:^() {
+        maximum = self->_maximumNumberOfDatabasesToCreate;
+    }];
+    
+    return maximum;
+}
+
+- (void)setMaximumNumberOfDatabasesToCreate:(NSUInteger)maximum {
+    [self executeLocked:^() {
+        self->_maximumNumberOfDatabasesToCreate = maximum;
+        [self serviceWaiters];
+    }];
+}
+
+#pragma mark Checkout
+
+static NSError *AWSFMDatabasePoolError(int code, NSString *message) {
+    return [NSError errorWithDomain:@"FMDatabase" code:code userInfo:[NSDictionary dictionaryWithObject:message forKey:NSLocalizedDescriptionKey]];
+}
+
+// Must run on _lockQueue.
+- (void)recordWaitTime:(NSTimeInterval)waitTime {
+    
+    NSUInteger bucket = 0;
+    
+    while (bucket < AWSFMDatabasePoolWaitBucketCount - 1 && waitTime >= AWSFMDatabasePoolWaitBucketBounds[bucket]) {
+        bucket++;
+    }
+    
+    _waitTimeHistogram[bucket]++;
+}
+
+// Must run on _lockQueue. Returns nil with *outErr left nil when the pool is at its limit.
+- (AWSFMDatabase *)takeDatabase:(NSError **)outErr {
+    
+    // Reuse the most recently returned handle; it is already open, so skip openWithFlags:.
+    AWSFMDatabase *db = [_databaseInPool lastObject];
+    
+    if (db) {
+        [_databaseOutPool addObject:db];
+        [_databaseInPool removeLastObject];
+        [_checkInTimes removeLastObject];
+        
+        if ([db sqliteHandle]) {
+            return db;
+        }
+        
+        // Someone closed it while it sat in the pool.
+#if SQLITE_VERSION_NUMBER >= 3005000
+        BOOL success = [db openWithFlags:_openFlags];
+#else
+        BOOL success = [db open];
+#endif
+        if (success) {
+            return db;
+        }
+        
+        [_databaseOutPool removeObject:db];
+        *outErr = AWSFMDatabasePoolError(SQLITE_CANTOPEN, [NSString stringWithFormat:@"Could not reopen the database at path %@", _path]);
+        return nil;
+    }
+    
+    if (_maximumNumberOfDatabasesToCreate) {
+        NSUInteger currentCount = [_databaseOutPool count] + [_databaseInPool count];
+        
+        if (currentCount >= _maximumNumberOfDatabasesToCreate) {
+            return nil;
+        }
+    }
+    
+    db = [AWSFMDatabase databaseWithPath:_path];
+    
+#if SQLITE_VERSION_NUMBER >= 3005000
+    BOOL success = [db openWithFlags:_openFlags];
+#else
+    BOOL success = [db open];
+#endif
+    if (!success) {
+        NSLog(@"Could not open up the database at path %@", _path);
+        *outErr = AWSFMDatabasePoolError(SQLITE_CANTOPEN, [NSString stringWithFormat:@"Could not open up the database at path %@", _path]);
+        return nil;
+    }
+    
+    if ([_delegate respondsToSelector:@selector(databasePool:shouldAddDatabaseToPool:)] && ![_delegate databasePool:self shouldAddDatabaseToPool:db]) {
+        [db close];
+        *outErr = AWSFMDatabasePoolError(SQLITE_CANTOPEN, @"The pool delegate declined to add the database");
+        return nil;
+    }
+    
+    [_databaseOutPool addObject:db];
+    
+    if ([_delegate respondsToSelector:@selector(databasePool:didAddDatabase:)]) {
+        [_delegate databasePool:self didAddDatabase:db];
+    }
+    
+    return db;
+}
+
+// Must run on _lockQueue.
+- (void)expireWaiter:(AWSFMDatabasePoolWaiter *)waiter {
+    
+    NSUInteger idx = [_waiters indexOfObjectIdenticalTo:waiter];
+    
+    if (idx == NSNotFound) { // already handed a database
+        return;
+    }
+    
+    [self recordWaitTime:[NSDate timeIntervalSinceReferenceDate] - [waiter enqueueTime]];
+    
+    AWSFMDBRetain(waiter);
+    [_waiters removeObjectAtIndex:idx];
+    
+    NSError *error = AWSFMDatabasePoolError(SQLITE_BUSY, @"Timed out waiting for a database from the pool");
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [waiter handler](nil, error);
+    });
+    
+    AWSFMDBRelease(waiter);
+}
+
+// Must run on _lockQueue. Hands databases to waiting callers, oldest first, for as long as the pool can
+// supply one. Call it after anything that frees capacity.
+- (void)serviceWaiters {
+    
+    while ([_waiters count]) {
+        NSError *error = nil;
+        AWSFMDatabase *db = [self takeDatabase:&error];
+        
+        if (!db && !error) { // still at the limit
+            return;
+        }
+        
+        AWSFMDatabasePoolWaiter *waiter = AWSFMDBReturnRetained([_waiters objectAtIndex:0]);
+        [_waiters removeObjectAtIndex:0];
+        
+        [self recordWaitTime:[NSDate timeIntervalSinceReferenceDate] - [waiter enqueueTime]];
+        
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [waiter handler](db, error);
+        });
+        
+        AWSFMDBRelease(waiter);
+    }
+}
+
+// Hands the database to a waiting caller, or queues the handler if none is free.
+// With a nil callbackQueue an immediate result is delivered on the calling thread.
+- (void)checkOutDatabaseWithTimeout:(NSTimeInterval)timeout callbackQueue:(dispatch_queue_t)callbackQueue completionHandler:(void (^)(AWSFMDatabase *db, NSError *error))handler {
+    
+    __block AWSFMDatabase *immediateDB = nil;
+    __block NSError *immediateError = nil;
+    __block BOOL queued = NO;
+    
+    [self executeLocked:^() {
+        
+        // Waiting callers go first, so a newcomer cannot grab a database ahead of them.
+        if (![self->_waiters count]) {
+            NSError *error = nil;
+            AWSFMDatabase *db = [self takeDatabase:&error];
+            
+            if (db || error) {
+                immediateDB = AWSFMDBReturnRetained(db);
+                immediateError = AWSFMDBReturnRetained(error);
+                [self recordWaitTime:0];
+                return;
+            }
+        }
+        
+        if (timeout == 0) {
+            [self recordWaitTime:0];
+            immediateError = AWSFMDBReturnRetained(AWSFMDatabasePoolError(SQLITE_BUSY, @"No database is available in the pool"));
+            return;
+        }
+        
+        AWSFMDatabasePoolWaiter *waiter = [[AWSFMDatabasePoolWaiter alloc] init];
+        [waiter setHandler:handler];
+        [waiter setEnqueueTime:[NSDate timeIntervalSinceReferenceDate]];
+        [self->_waiters addObject:waiter];
+        queued = YES;
+        
+        if (timeout > 0) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), self->_lockQueue, ^{
+                [self expireWaiter:waiter];
+            });
+        }
+        
+        AWSFMDBRelease(waiter);
+    }];
+    
+    if (queued) {
+        return;
+    }
+    
+    if (callbackQueue) {
+        dispatch_async(callbackQueue, ^{
+            handler(immediateDB, immediateError);
+            AWSFMDBRelease(immediateDB);
+            AWSFMDBRelease(immediateError);
+        });
+    }
+    else {
+        handler(immediateDB, immediateError);
+        AWSFMDBRelease(immediateDB);
+        AWSFMDBRelease(immediateError);
+    }
+}
+
+- (void)checkOutDatabaseWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(AWSFMDatabase *db, NSError *error))handler {
+    [self checkOutDatabaseWithTimeout:timeout callbackQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0) completionHandler:handler];
+}
+
+- (AWSFMDatabase *)checkOutDatabaseWithTimeout:(NSTimeInterval)timeout error:(NSError **)outErr {
+    
+    __block AWSFMDatabase *db = nil;
+    __block NSError *err = nil;
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    
+    // Timeouts are enforced by the pool, which always calls back exactly once.
+    [self checkOutDatabaseWithTimeout:timeout callbackQueue:nil completionHandler:^(AWSFMDatabase *aDB, NSError *error) {
+        db = AWSFMDBReturnRetained(aDB);
+        err = AWSFMDBReturnRetained(error);
+        dispatch_semaphore_signal(semaphore);
+    }];
+    
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    AWSFMDBDispatchQueueRelease(semaphore);
+    
+    if (err && outErr) {
+        *outErr = err;
+    }
+    
+    AWSFMDBAutorelease(db);
+    AWSFMDBAutorelease(err);
+    
+    return db;
+}
+
+- (void)checkInDatabase:(AWSFMDatabase *)db {
+    [self pushDatabaseBackInPool:db];
+}
+
 - (void)pushDatabaseBackInPool:(AWSFMDatabase*)db {
     
     if (!db) { // db can be null if we set an upper bound on the # of databases to create.
@@ -92,71 +371,82 @@
         }
         
         [self->_databaseInPool addObject:db];
+        [self->_checkInTimes addObject:[NSNumber numberWithDouble:[NSDate timeIntervalSinceReferenceDate]]];
         [self->_databaseOutPool removeObject:db];
         
+        // A waiter takes the database straight back out, since checkouts reuse the most recent one.
+        [self serviceWaiters];
+        [self scheduleIdleReap];
     }];
 }
 
 - (AWSFMDatabase*)db {
+    return [self dbWithTimeout:0];
+}
+
+- (AWSFMDatabase*)dbWithTimeout:(NSTimeInterval)timeout {
     
-    __block AWSFMDatabase *db;
+    NSError *err = nil;
+    AWSFMDatabase *db = [self checkOutDatabaseWithTimeout:timeout error:&err];
     
+    if (!db) {
+        NSLog(@"Could not check out a database from the pool: %@", [err localizedDescription]);
+    }
     
-    [self executeLocked:^() {
-        db = [self->_databaseInPool lastObject];
-        
-        BOOL shouldNotifyDelegate = NO;
-        
-        if (db) {
-            [self->_databaseOutPool addObject:db];
-            [self->_databaseInPool removeLastObject];
-        }
-        else {
-            
-            if (self->_maximumNumberOfDatabasesToCreate) {
-                NSUInteger currentCount = [self->_databaseOutPool count] + [self->_databaseInPool count];
-                
-                if (currentCount >= self->_maximumNumberOfDatabasesToCreate) {
-                    NSLog(@"Maximum number of databases (%ld) has already been reached!", (long)currentCount);
-                    return;
-                }
-            }
-            
-            db = [AWSFMDatabase databaseWithPath:self->_path];
-            shouldNotifyDelegate = YES;
-        }
-        
-        //This ensures that the db is opened before returning
-#if SQLITE_VERSION_NUMBER >= 3005000
-        BOOL success = [db openWithFlags:self->_openFlags];
-#else
-        BOOL success = [db open];
-#endif
-        if (success) {
-            if ([self->_delegate respondsToSelector:@selector(databasePool:shouldAddDatabaseToPool:)] && ![self->_delegate databasePool:self shouldAddDatabaseToPool:db]) {
-                [db close];
-                db = 0x00;
-            }
-            else {
-                //It should not get added in the pool twice if lastObject was found
-                if (![self->_databaseOutPool containsObject:db]) {
-                    [self->_databaseOutPool addObject:db];
-                    
-                    if (shouldNotifyDelegate && [self->_delegate respondsToSelector:@selector(databasePool:didAddDatabase:)]) {
-                        [self->_delegate databasePool:self didAddDatabase:db];
-                    }
-                }
-            }
-        }
-        else {
-            NSLog(@"Could not open up the database at path %@", self->_path);
-            db = 0x00;
+    return db;
+}
+
+#pragma mark Idle databases
+
+// Must run on _lockQueue.
+- (void)reapIdleDatabases {
+    
+    if (_maximumIdleInterval <= 0) {
+        return;
+    }
+    
+    NSTimeInterval cutoff = [NSDate timeIntervalSinceReferenceDate] - _maximumIdleInterval;
+    
+    // Checkouts take from the end, so the longest-idle databases are at the front.
+    while ([_checkInTimes count] && [[_checkInTimes objectAtIndex:0] doubleValue] <= cutoff) {
+        [[_databaseInPool objectAtIndex:0] close];
+        [_databaseInPool removeObjectAtIndex:0];
+        [_checkInTimes removeObjectAtIndex:0];
+    }
+}
+
+// Must run on _lockQueue.
+- (void)scheduleIdleReap {
+    
+    if (_idleReapScheduled || _maximumIdleInterval <= 0 || ![_checkInTimes count]) {
+        return;
+    }
+    
+    _idleReapScheduled = YES;
+    
+    NSTimeInterval delay = [[_checkInTimes objectAtIndex:0] doubleValue] + _maximumIdleInterval - [NSDate timeIntervalSinceReferenceDate];
+    
+    // The reap must not keep an otherwise unused pool alive for another idle interval.
+    __weak AWSFMDatabasePool *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX(delay, 0) * NSEC_PER_SEC)), _lockQueue, ^{
+        AWSFMDatabasePool *strongSelf = weakSelf;
+        if (!strongSelf) {
+            return;
         }
+        strongSelf->_idleReapScheduled = NO;
+        [strongSelf reapIdleDatabases];
+        [strongSelf scheduleIdleReap];
+    });
+}
+
+- (void)closeIdleDatabases {
+    [self executeLocked:^() {
+        [self reapIdleDatabases];
     }];
-    
-    return db;
 }
 
+#pragma mark Statistics
+
 - (NSUInteger)countOfCheckedInDatabases {
     
     __block NSUInteger count;
@@ -189,27 +479,52 @@
     return count;
 }
 
+- (NSArray *)waitTimeHistogram {
+    
+    NSMutableArray *histogram = [NSMutableArray arrayWithCapacity:AWSFMDatabasePoolWaitBucketCount];
+    
+    [self executeLocked:^() {
+        for (NSUInteger bucket = 0; bucket < AWSFMDatabasePoolWaitBucketCount; bucket++) {
+            [histogram addObject:[NSNumber numberWithUnsignedInteger:self->_waitTimeHistogram[bucket]]];
+        }
+    }];
+    
+    return histogram;
+}
+
+- (void)resetWaitTimeHistogram {
+    [self executeLocked:^() {
+        memset(self->_waitTimeHistogram, 0, sizeof(self->_waitTimeHistogram));
+    }];
+}
+
 - (void)releaseAllDatabases {
     [self executeLocked:^() {
         [self->_databaseOutPool removeAllObjects];
         [self->_databaseInPool removeAllObjects];
+        [self->_checkInTimes removeAllObjects];
+        [self serviceWaiters];
     }];
 }
 
 - (void)inDatabase:(void (^)(AWSFMDatabase *db))block {
+    [self inDatabaseWithTimeout:0 block:block];
+}
+
+- (void)inDatabaseWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db))block {
     
-    AWSFMDatabase *db = [self db];
+    AWSFMDatabase *db = [self dbWithTimeout:timeout];
     
     block(db);
     
     [self pushDatabaseBackInPool:db];
 }
 
-- (void)beginTransaction:(BOOL)useDeferred withBlock:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+- (void)beginTransaction:(BOOL)useDeferred timeout:(NSTimeInterval)timeout withBlock:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
     
     BOOL shouldRollback = NO;
     
-    AWSFMDatabase *db = [self db];
+    AWSFMDatabase *db = [self dbWithTimeout:timeout];
     
     if (useDeferred) {
         [db beginDeferredTransaction];
@@ -232,11 +547,19 @@
 }
 
 - (void)inDeferredTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
-    [self beginTransaction:YES withBlock:block];
+    [self beginTransaction:YES timeout:0 withBlock:block];
 }
 
 - (void)inTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
-    [self beginTransaction:NO withBlock:block];
+    [self beginTransaction:NO timeout:0 withBlock:block];
+}
+
+- (void)inDeferredTransactionWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+    [self beginTransaction:YES timeout:timeout withBlock:block];
+}
+
+- (void)inTransactionWithTimeout:(NSTimeInterval)timeout block:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
+    [self beginTransaction:NO timeout:timeout withBlock:block];
 }
 #if SQLITE_VERSION_NUMBER >= 3007000
 - (NSError*)inSavePoint:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
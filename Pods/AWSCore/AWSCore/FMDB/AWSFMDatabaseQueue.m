@@ -9,6 +9,10 @@
 #import "AWSFMDatabaseQueue.h"
 #import "AWSFMDatabase.h"
 
+@interface AWSFMDatabase ()
+- (void)bindObject:(id)obj toColumn:(int)idx inStatement:(sqlite3_stmt*)pStmt;
+@end
+
 /*
  
  Note: we call [self retain]; before using dispatch_sync, just incase 
@@ -200,6 +204,187 @@ static const void * const kDispatchQueueSpecificKey = &kDispatchQueueSpecificKey
     [self beginTransaction:NO withBlock:block];
 }
 
+#pragma mark Bulk import and export
+
+- (BOOL)importRowsWithStatement:(NSString *)sql batchSize:(NSUInteger)batchSize synchronous:(AWSFMDatabaseSynchronous)synchronous bindingBlock:(AWSFMDatabaseBulkBindingBlock)block rowCount:(NSUInteger *)outRowCount error:(NSError **)outErr {
+    
+    AWSFMDatabaseQueue *currentSyncQueue = (__bridge id)dispatch_get_specific(kDispatchQueueSpecificKey);
+    assert(currentSyncQueue != self && "importRowsWithStatement: was called reentrantly on the same queue, which would lead to a deadlock");
+    
+    __block BOOL success = NO;
+    __block NSUInteger committedRowCount = 0;
+    __block NSError *err = 0x00;
+    
+    AWSFMDBRetain(self);
+    dispatch_sync(_queue, ^() {
+        
+        AWSFMDatabase *db = [self database];
+        if (!db) {
+            return;
+        }
+        
+        int previousSynchronous = -1;
+        if (synchronous != AWSFMDatabaseSynchronousDefault) {
+            AWSFMResultSet *rs = [db executeQuery:@"PRAGMA synchronous"];
+            if ([rs next]) {
+                previousSynchronous = [rs intForColumnIndex:0];
+            }
+            [rs close];
+            [db executeUpdate:[NSString stringWithFormat:@"PRAGMA synchronous = %ld", (long)synchronous]];
+        }
+        
+        // Prepared once here rather than per row through executeUpdate's argument parsing.
+        sqlite3_stmt *pStmt = 0x00;
+        if (sqlite3_prepare_v2([db sqliteHandle], [sql UTF8String], -1, &pStmt, 0) != SQLITE_OK) {
+            err = [db lastError];
+        }
+        else if (![db beginTransaction]) {
+            err = [db lastError];
+        }
+        else {
+            NSUInteger rowIndex = 0;
+            NSUInteger batchRowCount = 0;
+            success = YES;
+            
+            while (success) {
+                BOOL hasRow;
+                
+                sqlite3_reset(pStmt);
+                sqlite3_clear_bindings(pStmt);
+                
+                @autoreleasepool {
+                    hasRow = block(pStmt, rowIndex);
+                }
+                
+                if (!hasRow) {
+                    break;
+                }
+                
+                if (sqlite3_step(pStmt) != SQLITE_DONE) {
+                    err = [db lastError];
+                    success = NO;
+                    break;
+                }
+                
+                rowIndex++;
+                batchRowCount++;
+                
+                if (batchSize > 0 && batchRowCount == batchSize) {
+                    if (![db commit]) {
+                        err = [db lastError];
+                        success = NO;
+                        break;
+                    }
+                    
+                    committedRowCount += batchRowCount;
+                    batchRowCount = 0;
+                    
+                    if (![db beginTransaction]) {
+                        err = [db lastError];
+                        success = NO;
+                        break;
+                    }
+                }
+            }
+            
+            if ([db inTransaction]) {
+                if (success && [db commit]) {
+                    committedRowCount += batchRowCount;
+                }
+                else {
+                    if (success) {
+                        err = [db lastError];
+                        success = NO;
+                    }
+                    [db rollback];
+                }
+            }
+        }
+        
+        if (!success && [db logsErrors]) {
+            NSLog(@"DB Error: bulk import failed after %lu rows: %@", (unsigned long)committedRowCount, [err localizedDescription]);
+            NSLog(@"DB Query: %@", sql);
+        }
+        
+        sqlite3_finalize(pStmt);
+        
+        if (previousSynchronous >= 0) {
+            [db executeUpdate:[NSString stringWithFormat:@"PRAGMA synchronous = %d", previousSynchronous]];
+        }
+    });
+    AWSFMDBRelease(self);
+    
+    if (outRowCount) {
+        *outRowCount = committedRowCount;
+    }
+    if (!success && outErr) {
+        *outErr = err;
+    }
+    
+    return success;
+}
+
+- (BOOL)importRowsWithStatement:(NSString *)sql argumentRows:(NSEnumerator *)rows batchSize:(NSUInteger)batchSize synchronous:(AWSFMDatabaseSynchronous)synchronous rowCount:(NSUInteger *)outRowCount error:(NSError **)outErr {
+    
+    return [self importRowsWithStatement:sql batchSize:batchSize synchronous:synchronous bindingBlock:^BOOL(sqlite3_stmt *statement, NSUInteger rowIndex) {
+        
+        NSArray *arguments = [rows nextObject];
+        if (!arguments) {
+            return NO;
+        }
+        
+        int queryCount = sqlite3_bind_parameter_count(statement);
+        int argumentCount = (int)[arguments count];
+        
+        for (int idx = 0; idx < queryCount && idx < argumentCount; idx++) {
+            [self->_db bindObject:[arguments objectAtIndex:(NSUInteger)idx] toColumn:idx + 1 inStatement:statement];
+        }
+        
+        return YES;
+    } rowCount:outRowCount error:outErr];
+}
+
+- (BOOL)exportRowsWithQuery:(NSString *)sql arguments:(NSArray *)arguments usingBlock:(void (^)(AWSFMResultSet *rs, BOOL *stop))block error:(NSError **)outErr {
+    
+    AWSFMDatabaseQueue *currentSyncQueue = (__bridge id)dispatch_get_specific(kDispatchQueueSpecificKey);
+    assert(currentSyncQueue != self && "exportRowsWithQuery: was called reentrantly on the same queue, which would lead to a deadlock");
+    
+    __block BOOL success = NO;
+    __block NSError *err = 0x00;
+    
+    AWSFMDBRetain(self);
+    dispatch_sync(_queue, ^() {
+        
+        AWSFMDatabase *db = [self database];
+        AWSFMResultSet *rs = [db executeQuery:sql withArgumentsInArray:arguments];
+        if (!rs) {
+            err = [db lastError];
+            return;
+        }
+        
+        NSError *stepError = nil;
+        BOOL stop = NO;
+        
+        while (!stop && [rs nextWithError:&stepError]) {
+            @autoreleasepool {
+                block(rs, &stop);
+            }
+        }
+        
+        [rs close];
+        
+        err = stepError;
+        success = (stepError == nil);
+    });
+    AWSFMDBRelease(self);
+    
+    if (!success && outErr) {
+        *outErr = err;
+    }
+    
+    return success;
+}
+
 #if SQLITE_VERSION_NUMBER >= 3007000
 - (NSError*)inSavePoint:(void (^)(AWSFMDatabase *db, BOOL *rollback))block {
     
@@ -16,6 +16,41 @@
 @class AWSFMDatabase;
 @class AWSFMStatement;
 
+/** Storage type a mapped column is decoded into. See `AWSFMColumnMapping`. */
+
+typedef NS_ENUM(NSInteger, AWSFMColumnType) {
+    /** `int` */
+    AWSFMColumnTypeInt,
+    /** `long long` */
+    AWSFMColumnTypeLongLong,
+    /** `double` */
+    AWSFMColumnTypeDouble,
+    /** `BOOL` */
+    AWSFMColumnTypeBool,
+    /** `const char *`, `NULL` for SQL `NULL`. Only valid until the next row is fetched. */
+    AWSFMColumnTypeUTF8String,
+    /** `AWSFMBlob`. Only valid until the next row is fetched. */
+    AWSFMColumnTypeBlob,
+};
+
+/** A borrowed view of a blob column. */
+
+typedef struct {
+    const void *bytes;
+    int length;
+} AWSFMBlob;
+
+/** Maps one result column onto a field of a caller-defined struct.
+ 
+ Use `offsetof` for `offset`, for example `{ "age", AWSFMColumnTypeInt, offsetof(MyRow, age) }`. Column names match case-insensitively.
+ */
+
+typedef struct {
+    const char *columnName;
+    AWSFMColumnType type;
+    size_t offset;
+} AWSFMColumnMapping;
+
 /** Represents the results of executing a query on an `<FMDatabase>`.
  
  ### See also
@@ -29,6 +64,10 @@
     
     NSString            *_query;
     NSMutableDictionary *_columnNameToIndexMap;
+    
+    AWSFMColumnMapping  *_rowMappings;
+    int                 *_rowMappingColumnIndexes;
+    NSUInteger          _rowMappingCount;
 }
 
 ///-----------------
@@ -452,6 +491,62 @@ If you don't, you're going to be in a world of hurt when you try and use the dat
 
 - (NSDictionary*)resultDict  __attribute__ ((deprecated));
 
+///-------------------------
+/// @name Typed row mapping
+///-------------------------
+
+/** Resolve column mappings against this result set.
+ 
+ Column indices are looked up once here, so decoding a row afterwards is a straight read from the statement with no string lookups or boxing. The mappings are copied.
+ 
+ @param mappings Array of `AWSFMColumnMapping` describing where each column goes.
+ 
+ @param count Number of entries in `mappings`.
+ 
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if every mapped column exists in the result set; `NO` if not.
+ */
+
+- (BOOL)setRowMappings:(const AWSFMColumnMapping *)mappings count:(NSUInteger)count error:(NSError **)outErr;
+
+/** Decode the current row into a struct using the mappings set with `<setRowMappings:count:error:>`.
+ 
+ @param row Pointer to the caller's struct.
+ 
+ @warning Call `<next>` before decoding, as with the other accessors.
+ */
+
+- (void)decodeRowIntoStruct:(void *)row;
+
+/** Step through the remaining rows, decoding each into the same struct.
+ 
+ @param row Pointer to the caller's struct, rewritten before every call of `block`.
+ 
+ @param block Called once per row. Set `*stop` to `YES` to end early; the result set is left open in that case.
+ 
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if the rows were read without error; `NO` if stepping failed.
+ */
+
+- (BOOL)enumerateRowsIntoStruct:(void *)row usingBlock:(void (^)(const void *row, BOOL *stop))block error:(NSError **)outErr;
+
+/** Step through the remaining rows with column indices resolved up front.
+ 
+ Use the index-based accessors such as `<intForColumnIndex:>` inside the block to avoid the name lookup each name-based accessor performs.
+ 
+ @param columnNames Names of the columns the block reads. Matched case-insensitively.
+ 
+ @param block Called once per row with the index of each name in `columnNames`, in the same order. Set `*stop` to `YES` to end early.
+ 
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if the rows were read without error; `NO` if a column was missing or stepping failed.
+ */
+
+- (BOOL)enumerateRowsWithColumnNames:(NSArray *)columnNames usingBlock:(void (^)(AWSFMResultSet *rs, const int *columnIndexes, BOOL *stop))block error:(NSError **)outErr;
+
 ///-----------------------------
 /// @name Key value coding magic
 ///-----------------------------
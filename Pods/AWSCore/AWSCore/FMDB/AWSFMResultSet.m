@@ -1,6 +1,7 @@
 #import "AWSFMResultSet.h"
 #import "AWSFMDatabase.h"
 #import "unistd.h"
+#import <strings.h>
 
 @interface AWSFMDatabase ()
 - (void)resultSetDidClose:(AWSFMResultSet *)resultSet;
@@ -38,6 +39,9 @@
     AWSFMDBRelease(_columnNameToIndexMap);
     _columnNameToIndexMap = nil;
     
+    free(_rowMappings);
+    free(_rowMappingColumnIndexes);
+    
 #if ! __has_feature(objc_arc)
     [super dealloc];
 #endif
@@ -207,9 +211,15 @@
 }
 
 - (int)columnIndexForName:(NSString*)columnName {
-    columnName = [columnName lowercaseString];
+    NSMutableDictionary *columnNameToIndexMap = [self columnNameToIndexMap];
+    
+    // Most callers already pass lowercase names; only fold case when that misses.
+    NSNumber *n = [columnNameToIndexMap objectForKey:columnName];
     
-    NSNumber *n = [[self columnNameToIndexMap] objectForKey:columnName];
+    if (!n) {
+        columnName = [columnName lowercaseString];
+        n = [columnNameToIndexMap objectForKey:columnName];
+    }
     
     if (n) {
         return [n intValue];
@@ -400,6 +410,150 @@
     return [NSString stringWithUTF8String: sqlite3_column_name([_statement statement], columnIdx)];
 }
 
+#pragma mark Typed row mapping
+
+static int AWSFMResultSetColumnIndexForName(sqlite3_stmt *pStmt, const char *columnName) {
+    int columnCount = sqlite3_column_count(pStmt);
+    
+    for (int columnIdx = 0; columnIdx < columnCount; columnIdx++) {
+        const char *name = sqlite3_column_name(pStmt, columnIdx);
+        if (name && strcasecmp(name, columnName) == 0) {
+            return columnIdx;
+        }
+    }
+    
+    return -1;
+}
+
+static NSError *AWSFMResultSetMissingColumnError(const char *columnName) {
+    NSString *message = [NSString stringWithFormat:@"Could not find the column named '%s'.", columnName];
+    return [NSError errorWithDomain:@"FMDatabase" code:SQLITE_ERROR userInfo:[NSDictionary dictionaryWithObject:message forKey:NSLocalizedDescriptionKey]];
+}
+
+- (BOOL)setRowMappings:(const AWSFMColumnMapping *)mappings count:(NSUInteger)count error:(NSError **)outErr {
+    
+    sqlite3_stmt *pStmt = [_statement statement];
+    int *columnIndexes = malloc(sizeof(int) * (count ? count : 1));
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        columnIndexes[i] = AWSFMResultSetColumnIndexForName(pStmt, mappings[i].columnName);
+        
+        if (columnIndexes[i] < 0) {
+            NSLog(@"Warning: I could not find the column named '%s'.", mappings[i].columnName);
+            if (outErr) {
+                *outErr = AWSFMResultSetMissingColumnError(mappings[i].columnName);
+            }
+            free(columnIndexes);
+            return NO;
+        }
+    }
+    
+    free(_rowMappings);
+    free(_rowMappingColumnIndexes);
+    
+    _rowMappings = malloc(sizeof(AWSFMColumnMapping) * (count ? count : 1));
+    memcpy(_rowMappings, mappings, sizeof(AWSFMColumnMapping) * count);
+    _rowMappingColumnIndexes = columnIndexes;
+    _rowMappingCount = count;
+    
+    return YES;
+}
+
+static void AWSFMResultSetDecodeRow(sqlite3_stmt *pStmt, const AWSFMColumnMapping *mappings, const int *columnIndexes, NSUInteger count, void *row) {
+    
+    char *base = (char *)row;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        int columnIdx = columnIndexes[i];
+        void *field = base + mappings[i].offset;
+        
+        switch (mappings[i].type) {
+            case AWSFMColumnTypeInt:
+                *(int *)field = sqlite3_column_int(pStmt, columnIdx);
+                break;
+            case AWSFMColumnTypeLongLong:
+                *(long long *)field = sqlite3_column_int64(pStmt, columnIdx);
+                break;
+            case AWSFMColumnTypeDouble:
+                *(double *)field = sqlite3_column_double(pStmt, columnIdx);
+                break;
+            case AWSFMColumnTypeBool:
+                *(BOOL *)field = sqlite3_column_int(pStmt, columnIdx) != 0;
+                break;
+            case AWSFMColumnTypeUTF8String:
+                *(const char **)field = (const char *)sqlite3_column_text(pStmt, columnIdx);
+                break;
+            case AWSFMColumnTypeBlob: {
+                AWSFMBlob *blob = (AWSFMBlob *)field;
+                // sqlite3_column_bytes must come after sqlite3_column_blob.
+                blob->bytes = sqlite3_column_blob(pStmt, columnIdx);
+                blob->length = sqlite3_column_bytes(pStmt, columnIdx);
+                break;
+            }
+        }
+    }
+}
+
+- (void)decodeRowIntoStruct:(void *)row {
+    AWSFMResultSetDecodeRow([_statement statement], _rowMappings, _rowMappingColumnIndexes, _rowMappingCount, row);
+}
+
+- (BOOL)enumerateRowsIntoStruct:(void *)row usingBlock:(void (^)(const void *row, BOOL *stop))block error:(NSError **)outErr {
+    
+    NSError *error = nil;
+    BOOL stop = NO;
+    
+    // Read the handle once instead of through the atomic accessor on every row.
+    sqlite3_stmt *pStmt = [_statement statement];
+    
+    while (!stop && [self nextWithError:&error]) {
+        AWSFMResultSetDecodeRow(pStmt, _rowMappings, _rowMappingColumnIndexes, _rowMappingCount, row);
+        block(row, &stop);
+    }
+    
+    if (error && outErr) {
+        *outErr = error;
+    }
+    
+    return error == nil;
+}
+
+- (BOOL)enumerateRowsWithColumnNames:(NSArray *)columnNames usingBlock:(void (^)(AWSFMResultSet *rs, const int *columnIndexes, BOOL *stop))block error:(NSError **)outErr {
+    
+    sqlite3_stmt *pStmt = [_statement statement];
+    NSUInteger count = [columnNames count];
+    int *columnIndexes = malloc(sizeof(int) * (count ? count : 1));
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        const char *columnName = [[columnNames objectAtIndex:i] UTF8String];
+        columnIndexes[i] = AWSFMResultSetColumnIndexForName(pStmt, columnName);
+        
+        if (columnIndexes[i] < 0) {
+            NSLog(@"Warning: I could not find the column named '%s'.", columnName);
+            if (outErr) {
+                *outErr = AWSFMResultSetMissingColumnError(columnName);
+            }
+            free(columnIndexes);
+            return NO;
+        }
+    }
+    
+    NSError *error = nil;
+    BOOL stop = NO;
+    
+    while (!stop && [self nextWithError:&error]) {
+        block(self, columnIndexes, &stop);
+    }
+    
+    free(columnIndexes);
+    
+    if (error && outErr) {
+        *outErr = error;
+    }
+    
+    return error == nil;
+}
+
 - (void)setParentDB:(AWSFMDatabase *)newDb {
     _parentDB = newDb;
 }
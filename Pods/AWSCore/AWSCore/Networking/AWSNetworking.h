@@ -33,6 +33,8 @@ typedef NS_ENUM(NSInteger, AWSNetworkingRetryType) {
 @class AWSNetworkingConfiguration;
 @class AWSNetworkingRequest;
 @class AWSTask;
+@class AWSExecutor;
+@class AWSURLRequestRetryBudget;
 
 typedef void (^AWSNetworkingUploadProgressBlock) (int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend);
 typedef void (^AWSNetworkingDownloadProgressBlock) (int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite);
@@ -111,6 +113,36 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @end
 
+/**
+ Receives the body of one successful response while it is being downloaded. A stream is created for each task and is only used from that task's delegate callbacks, so implementations do not need to be thread-safe. The bytes passed to `consumeResponseBytes:length:error:` are only valid for the duration of the call.
+ */
+@protocol AWSHTTPURLResponseStream <NSObject>
+
+@required
+
+- (BOOL)consumeResponseBytes:(const void *)bytes
+                      length:(NSUInteger)length
+                       error:(NSError *__autoreleasing *)error;
+- (id)finishWithOriginalRequest:(NSURLRequest *)originalRequest
+                 currentRequest:(NSURLRequest *)currentRequest
+                          error:(NSError *__autoreleasing *)error;
+
+@end
+
+/**
+ A response serializer that can consume the body of a successful response incrementally. Error responses and file downloads are still buffered and passed to `responseObjectForResponse:originalRequest:currentRequest:data:error:`.
+ */
+@protocol AWSHTTPURLResponseStreamingSerializer <AWSHTTPURLResponseSerializer>
+
+@required
+
+/**
+ Returns a new stream for the body of `response`, or `nil` to have the body buffered instead.
+ */
+- (id<AWSHTTPURLResponseStream>)responseStreamForResponse:(NSHTTPURLResponse *)response;
+
+@end
+
 @protocol AWSURLRequestRetryHandler <NSObject>
 
 @required
@@ -161,6 +193,16 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
  */
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
 
+/**
+ The executor used to run the internal continuations of requests sent with this configuration. When `nil`, `+[AWSExecutor defaultExecutor]` is used. Set it to `+[AWSExecutor workStealingExecutor]` to avoid the thread dictionary lookups of the default executor.
+ */
+@property (nonatomic, strong) AWSExecutor *executor;
+
+/**
+ An optional retry budget shared by the requests sent with this configuration. When set, a failed request is only retried if the budget can pay for it.
+ */
+@property (nonatomic, strong) AWSURLRequestRetryBudget *retryBudget;
+
 @end
 
 #pragma mark - AWSNetworkingRequest
@@ -199,3 +241,29 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 @interface AWSNetworkingRequestInterceptor : NSObject <AWSNetworkingRequestInterceptor>
 
 @end
+
+#pragma mark - AWSNetworkingBufferPool
+
+/**
+ A process-wide pool of response body buffers in fixed size classes from 16 KB to 16 MB. A buffer's `length` is its capacity; callers track how much of it is in use. Requests larger than the biggest class get an unpooled buffer, and recycling one simply releases it. The pool is drained on memory warnings.
+ */
+@interface AWSNetworkingBufferPool : NSObject
+
++ (instancetype)sharedPool;
+
+/**
+ Returns a buffer whose length is the smallest size class that holds `length` bytes.
+ */
+- (NSMutableData *)bufferWithMinimumLength:(NSUInteger)length;
+
+/**
+ Returns a buffer obtained from `bufferWithMinimumLength:` to the pool. The caller must not use it afterwards.
+ */
+- (void)recycleBuffer:(NSMutableData *)buffer;
+
+/**
+ Releases every buffer the pool is holding.
+ */
+- (void)drain;
+
+@end
@@ -15,6 +15,7 @@
 
 #import "AWSNetworking.h"
 #import <UIKit/UIKit.h>
+#import <pthread.h>
 #import "AWSBolts.h"
 #import "AWSCategory.h"
 #import "AWSModel.h"
@@ -164,6 +165,8 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     configuration.responseSerializer = self.responseSerializer;
     configuration.responseInterceptors = [self.responseInterceptors copy];
     configuration.retryHandler = self.retryHandler;
+    configuration.executor = self.executor;
+    configuration.retryBudget = self.retryBudget;
 
     return configuration;
 }
@@ -326,3 +329,95 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
 }
 
 @end
+
+#pragma mark - AWSNetworkingBufferPool
+
+#define AWSNetworkingBufferPoolClassCount 6
+static const NSUInteger AWSNetworkingBufferPoolClassLengths[AWSNetworkingBufferPoolClassCount] = {16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024};
+// Fewer large buffers are kept, so an idle pool holds at most about 23 MB.
+static const NSUInteger AWSNetworkingBufferPoolMaximumFreeBuffers[AWSNetworkingBufferPoolClassCount] = {8, 4, 4, 2, 1, 1};
+
+@implementation AWSNetworkingBufferPool {
+    pthread_mutex_t _lock;
+    NSMutableArray *_freeBuffers[AWSNetworkingBufferPoolClassCount];
+}
+
++ (instancetype)sharedPool {
+    static AWSNetworkingBufferPool *_sharedPool = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedPool = [AWSNetworkingBufferPool new];
+    });
+
+    return _sharedPool;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        for (NSUInteger i = 0; i < AWSNetworkingBufferPoolClassCount; i++) {
+            _freeBuffers[i] = [NSMutableArray new];
+        }
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(drain)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    pthread_mutex_destroy(&_lock);
+}
+
+- (NSUInteger)sizeClassForLength:(NSUInteger)length {
+    for (NSUInteger i = 0; i < AWSNetworkingBufferPoolClassCount; i++) {
+        if (length <= AWSNetworkingBufferPoolClassLengths[i]) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+- (NSMutableData *)bufferWithMinimumLength:(NSUInteger)length {
+    NSUInteger sizeClass = [self sizeClassForLength:length];
+    if (sizeClass == NSNotFound) {
+        return [NSMutableData dataWithLength:length];
+    }
+
+    NSMutableData *buffer = nil;
+    pthread_mutex_lock(&_lock);
+    buffer = [_freeBuffers[sizeClass] lastObject];
+    if (buffer) {
+        [_freeBuffers[sizeClass] removeLastObject];
+    }
+    pthread_mutex_unlock(&_lock);
+
+    return buffer ? buffer : [NSMutableData dataWithLength:AWSNetworkingBufferPoolClassLengths[sizeClass]];
+}
+
+- (void)recycleBuffer:(NSMutableData *)buffer {
+    NSUInteger sizeClass = [self sizeClassForLength:[buffer length]];
+    if (sizeClass == NSNotFound || [buffer length] != AWSNetworkingBufferPoolClassLengths[sizeClass]) {
+        return;
+    }
+
+    pthread_mutex_lock(&_lock);
+    if ([_freeBuffers[sizeClass] count] < AWSNetworkingBufferPoolMaximumFreeBuffers[sizeClass]) {
+        [_freeBuffers[sizeClass] addObject:buffer];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)drain {
+    pthread_mutex_lock(&_lock);
+    for (NSUInteger i = 0; i < AWSNetworkingBufferPoolClassCount; i++) {
+        [_freeBuffers[i] removeAllObjects];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+@end
@@ -15,11 +15,15 @@
 
 #import "AWSURLSessionManager.h"
 
-#import "AWSSynchronizedMutableDictionary.h"
+#import <pthread.h>
 #import "AWSLogging.h"
 #import "AWSCategory.h"
 #import "AWSSignature.h"
 #import "AWSBolts.h"
+#import "AWSURLRequestRetryHandler.h"
+
+// Upper bound on the up-front allocation for a buffered response body; larger bodies grow as they arrive.
+static const int64_t AWSMaximumPreallocatedResponseLength = 8 * 1024 * 1024;
 
 #pragma mark - AWSURLSessionManagerDelegate
 
@@ -44,6 +48,8 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (nonatomic, strong) NSError *error;
 @property (nonatomic, strong) id responseObject;
 @property (nonatomic, strong) NSMutableData *responseData;
+// Set when the response serializer consumes this task's successful body as it arrives instead of from responseData.
+@property (nonatomic, strong) id<AWSHTTPURLResponseStream> responseStream;
 @property (nonatomic, strong) NSFileHandle *responseFilehandle;
 @property (nonatomic, strong) NSURL *tempDownloadedFileURL;
 @property (nonatomic, assign) BOOL shouldWriteDirectly;
@@ -52,6 +58,10 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (atomic, assign) int64_t lastTotalLengthOfChunkSignatureSent;
 @property (atomic, assign) int64_t payloadTotalBytesWritten;
 
+// Parsed once from the response headers so download progress does not re-read Content-Range per chunk.
+@property (nonatomic, assign) int64_t byteRangeStartPosition;
+@property (nonatomic, assign) int64_t totalBytesExpectedToWrite;
+
 @end
 
 @implementation AWSURLSessionManagerDelegate
@@ -81,11 +91,21 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @interface AWSURLSessionManager()
 
 @property (nonatomic, strong) NSURLSession *session;
-@property (nonatomic, strong) AWSSynchronizedMutableDictionary *sessionManagerDelegates;
 
 @end
 
-@implementation AWSURLSessionManager
+@implementation AWSURLSessionManager {
+    // Delegates keyed by the raw task identifier, so the per-chunk lookup neither boxes the key nor hops queues.
+    pthread_mutex_t _sessionManagerDelegatesLock;
+    CFMutableDictionaryRef _sessionManagerDelegates;
+}
+
+- (void)dealloc {
+    if (_sessionManagerDelegates) {
+        CFRelease(_sessionManagerDelegates);
+    }
+    pthread_mutex_destroy(&_sessionManagerDelegatesLock);
+}
 
 - (instancetype)init {
     @throw [NSException exceptionWithName:NSInternalInconsistencyException
@@ -111,12 +131,38 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         _session = [NSURLSession sessionWithConfiguration:sessionConfiguration
                                                  delegate:self
                                             delegateQueue:nil];
-        _sessionManagerDelegates = [AWSSynchronizedMutableDictionary new];
+        pthread_mutex_init(&_sessionManagerDelegatesLock, NULL);
+        _sessionManagerDelegates = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
     }
 
     return self;
 }
 
+- (AWSURLSessionManagerDelegate *)delegateForTaskIdentifier:(NSUInteger)taskIdentifier {
+    AWSURLSessionManagerDelegate *delegate = nil;
+    pthread_mutex_lock(&_sessionManagerDelegatesLock);
+    delegate = (__bridge AWSURLSessionManagerDelegate *)CFDictionaryGetValue(_sessionManagerDelegates, (const void *)taskIdentifier);
+    pthread_mutex_unlock(&_sessionManagerDelegatesLock);
+    return delegate;
+}
+
+- (void)setDelegate:(AWSURLSessionManagerDelegate *)delegate forTaskIdentifier:(NSUInteger)taskIdentifier {
+    pthread_mutex_lock(&_sessionManagerDelegatesLock);
+    CFDictionarySetValue(_sessionManagerDelegates, (const void *)taskIdentifier, (__bridge const void *)delegate);
+    pthread_mutex_unlock(&_sessionManagerDelegatesLock);
+}
+
+- (void)removeDelegateForTaskIdentifier:(NSUInteger)taskIdentifier {
+    pthread_mutex_lock(&_sessionManagerDelegatesLock);
+    CFDictionaryRemoveValue(_sessionManagerDelegates, (const void *)taskIdentifier);
+    pthread_mutex_unlock(&_sessionManagerDelegatesLock);
+}
+
+- (AWSExecutor *)executor {
+    AWSExecutor *executor = self.configuration.executor;
+    return executor ? executor : [AWSExecutor defaultExecutor];
+}
+
 - (void)dataTaskWithRequest:(AWSNetworkingRequest *)request
           completionHandler:(AWSNetworkingCompletionHandlerBlock)completionHandler {
     [request assignProperties:self.configuration];
@@ -135,12 +181,14 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 - (void)taskWithDelegate:(AWSURLSessionManagerDelegate *)delegate {
     if (delegate.downloadingFileURL) delegate.shouldWriteToFile = YES;
     delegate.responseData = nil;
+    delegate.responseStream = nil;
     delegate.responseObject = nil;
     delegate.error = nil;
     NSMutableURLRequest *mutableRequest = [NSMutableURLRequest requestWithURL:delegate.request.URL];
     mutableRequest.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
     
-    [[[[[[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
+    AWSExecutor *executor = [self executor];
+    [[[[[[AWSTask taskWithResult:nil] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
         id signer = [delegate.request.requestInterceptors lastObject];
         if (signer) {
 #pragma clang diagnostic push
@@ -179,7 +227,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         }
         
         return nil;
-    }] continueWithSuccessBlock:^id(AWSTask *task) {
+    }] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
         AWSNetworkingRequest *request = delegate.request;
         if (request.isCancelled) {
             if (delegate.dataTaskCompletionHandler) {
@@ -213,14 +261,14 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         }
         
         return task;
-    }] continueWithSuccessBlock:^id(AWSTask *task) {
+    }] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
         AWSNetworkingRequest *request = delegate.request;
         if ([request.requestSerializer respondsToSelector:@selector(validateRequest:)]) {
             return [request.requestSerializer validateRequest:mutableRequest];
         } else {
             return [AWSTask taskWithResult:nil];
         }
-    }] continueWithSuccessBlock:^id(AWSTask *task) {
+    }] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
         switch (delegate.taskType) {
             case AWSURLSessionTaskTypeData:
                 delegate.request.task = [self.session dataTaskWithRequest:mutableRequest];
@@ -231,8 +279,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         }
         
         if (delegate.request.task) {
-            [self.sessionManagerDelegates setObject:delegate
-                                             forKey:@(((NSURLSessionTask *)delegate.request.task).taskIdentifier)];
+            [self setDelegate:delegate forTaskIdentifier:((NSURLSessionTask *)delegate.request.task).taskIdentifier];
             [delegate.request.task resume];
         } else {
             AWSLogError(@"Invalid AWSURLSessionTaskType.");
@@ -242,7 +289,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         }
         
         return nil;
-    }] continueWithBlock:^id(AWSTask *task) {
+    }] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
         if (task.error) {
             if (delegate.dataTaskCompletionHandler) {
                 AWSNetworkingCompletionHandlerBlock completionHandler = delegate.dataTaskCompletionHandler;
@@ -260,12 +307,17 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         AWSLogError(@"Session task failed with error: %@", error);
     }
     
-    [[[AWSTask taskWithResult:nil] continueWithSuccessBlock:^id(AWSTask *task) {
-        AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(sessionTask.taskIdentifier)];
+    AWSExecutor *executor = [self executor];
+    [[[AWSTask taskWithResult:nil] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
+        AWSURLSessionManagerDelegate *delegate = [self delegateForTaskIdentifier:sessionTask.taskIdentifier];
         
         if (delegate.responseFilehandle) {
             [delegate.responseFilehandle closeFile];
         }
+
+        // Taken off the delegate before anything else so its buffer goes back to the pool even when the task failed or is retried.
+        id<AWSHTTPURLResponseStream> responseStream = delegate.responseStream;
+        delegate.responseStream = nil;
         
         if (!delegate.error) {
             delegate.error = error;
@@ -318,7 +370,16 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 }
             } else if (!delegate.error) {
                 // need to call responseSerializer if there is no client-side error.
-                if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
+                if (responseStream) {
+                    NSError *error = nil;
+                    delegate.responseObject = [responseStream finishWithOriginalRequest:sessionTask.originalRequest
+                                                                         currentRequest:sessionTask.currentRequest
+                                                                                  error:&error];
+                    if (error) {
+                        delegate.error = error;
+                    }
+                }
+                else if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                     NSError *error = nil;
                     delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                              originalRequest:sessionTask.originalRequest
@@ -342,6 +403,16 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                                                                                  response:(NSHTTPURLResponse *)sessionTask.response
                                                                                      data:delegate.responseData
                                                                                     error:delegate.error];
+            AWSURLRequestRetryBudget *retryBudget = self.configuration.retryBudget;
+            if (retryType != AWSNetworkingRetryTypeShouldNotRetry
+                && retryBudget
+                && ![retryBudget acquireRetry]) {
+                AWSLogWarn(@"The retry budget is exhausted. The request will not be retried.");
+                retryType = AWSNetworkingRetryTypeShouldNotRetry;
+            }
+
+            // Work that must finish before the request is re-issued, such as a credentials refresh.
+            AWSTask *retryPrerequisite = nil;
             switch (retryType) {
                 case AWSNetworkingRetryTypeShouldCorrectClockSkewAndRetry: {
                     //Correct Clock Skew
@@ -368,20 +439,21 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                     if ([signer respondsToSelector:@selector(credentialsProvider)]) {
                         id credentialsProvider = [signer performSelector:@selector(credentialsProvider)];
                         if ([credentialsProvider respondsToSelector:@selector(refresh)]) {
-                            [[credentialsProvider performSelector:@selector(refresh)] waitUntilFinished];
+                            retryPrerequisite = [credentialsProvider performSelector:@selector(refresh)];
                         }
                     }
 #pragma clang diagnostic pop
                 }
                     
                 case AWSNetworkingRetryTypeShouldRetry: {
-                    NSTimeInterval timeIntervalToSleep = [delegate.request.retryHandler timeIntervalForRetry:delegate.currentRetryCount
-                                                                                                    response:(NSHTTPURLResponse *)sessionTask.response
-                                                                                                        data:delegate.responseData
-                                                                                                       error:delegate.error];
-                    [NSThread sleepForTimeInterval:timeIntervalToSleep];
+                    NSTimeInterval timeIntervalToWait = [delegate.request.retryHandler timeIntervalForRetry:delegate.currentRetryCount
+                                                                                                   response:(NSHTTPURLResponse *)sessionTask.response
+                                                                                                       data:delegate.responseData
+                                                                                                      error:delegate.error];
                     delegate.currentRetryCount++;
-                    [self taskWithDelegate:delegate];
+                    [self scheduleRetryWithDelegate:delegate
+                                   afterPrerequisite:retryPrerequisite
+                                        timeInterval:timeIntervalToWait];
                 }
                     break;
                     
@@ -404,6 +476,9 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             if ([[retryHandler valueForKey:@"isClockSkewRetried"] boolValue]) {
                 [retryHandler setValue:@NO forKey:@"isClockSkewRetried"];
             }
+            if (!delegate.error) {
+                [self.configuration.retryBudget recordSuccess];
+            }
             
             if (delegate.dataTaskCompletionHandler) {
                 AWSNetworkingCompletionHandlerBlock completionHandler = delegate.dataTaskCompletionHandler;
@@ -411,14 +486,29 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             }
         }
         return nil;
-    }] continueWithBlock:^id(AWSTask *task) {
-        [self.sessionManagerDelegates removeObjectForKey:@(sessionTask.taskIdentifier)];
+    }] continueWithExecutor:executor withBlock:^id(AWSTask *task) {
+        [self removeDelegateForTaskIdentifier:sessionTask.taskIdentifier];
+        return nil;
+    }];
+}
+
+// Re-issues a request once its prerequisite has finished and the backoff interval has elapsed. Nothing
+// here blocks, so the session delegate queue keeps serving other requests while this one waits.
+- (void)scheduleRetryWithDelegate:(AWSURLSessionManagerDelegate *)delegate
+                afterPrerequisite:(AWSTask *)prerequisite
+                     timeInterval:(NSTimeInterval)timeInterval {
+    AWSTask *prerequisiteTask = prerequisite ? prerequisite : [AWSTask taskWithResult:nil];
+    [prerequisiteTask continueWithExecutor:[self executor] withBlock:^id(AWSTask *task) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeInterval * NSEC_PER_SEC)),
+                       dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                           [self taskWithDelegate:delegate];
+                       });
         return nil;
     }];
 }
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(task.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self delegateForTaskIdentifier:task.taskIdentifier];
     AWSNetworkingUploadProgressBlock uploadProgress = delegate.request.uploadProgress;
     if (uploadProgress) {
         
@@ -444,13 +534,33 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(dataTask.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self delegateForTaskIdentifier:dataTask.taskIdentifier];
     
+    delegate.byteRangeStartPosition = 0;
+    delegate.totalBytesExpectedToWrite = response.expectedContentLength;
+
     //If the response code is not 2xx, avoid write data to disk
     if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
         NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
+
+        NSString *contentRangeString = [[httpResponse allHeaderFields] objectForKey:@"Content-Range"];
+        if (contentRangeString) {
+            NSRange separatorRange = [contentRangeString rangeOfString:@"/" options:NSBackwardsSearch];
+            NSString *totalLengthString = separatorRange.location == NSNotFound ? contentRangeString : [contentRangeString substringFromIndex:NSMaxRange(separatorRange)];
+            int64_t trueContentLength = [totalLengthString longLongValue];
+            if (trueContentLength) {
+                delegate.byteRangeStartPosition = trueContentLength - response.expectedContentLength;
+                delegate.totalBytesExpectedToWrite = trueContentLength;
+            }
+        }
+
         if (httpResponse.statusCode >= 200 && httpResponse.statusCode < 300 ) {
             // status is good, we can keep value of shouldWriteToFile
+            id responseSerializer = delegate.request.responseSerializer;
+            if (!delegate.shouldWriteToFile
+                && [responseSerializer conformsToProtocol:@protocol(AWSHTTPURLResponseStreamingSerializer)]) {
+                delegate.responseStream = [responseSerializer responseStreamForResponse:httpResponse];
+            }
         } else {
             // got error status code, avoid write data to disk
             delegate.shouldWriteToFile = NO;
@@ -529,13 +639,38 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 }
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
-    AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(dataTask.taskIdentifier)];
+    AWSURLSessionManagerDelegate *delegate = [self delegateForTaskIdentifier:dataTask.taskIdentifier];
     
     if (delegate.responseFilehandle) {
         [delegate.responseFilehandle writeData:data];
+    } else if (delegate.responseStream) {
+        id<AWSHTTPURLResponseStream> responseStream = delegate.responseStream;
+        __block BOOL consumed = YES;
+        __block NSError *consumeError = nil;
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+            NSError *error = nil;
+            if (![responseStream consumeResponseBytes:bytes length:byteRange.length error:&error]) {
+                consumed = NO;
+                consumeError = error;
+                *stop = YES;
+            }
+        }];
+        if (!consumed) {
+            AWSLogError(@"Failed to consume the response body: %@", consumeError);
+            delegate.error = consumeError ? consumeError : [NSError errorWithDomain:AWSNetworkingErrorDomain
+                                                                              code:AWSNetworkingErrorUnknown
+                                                                          userInfo:@{NSLocalizedDescriptionKey: @"Failed to consume the response body."}];
+            delegate.responseStream = nil;
+            [dataTask cancel];
+        }
     } else {
         if (!delegate.responseData) {
-            delegate.responseData = [NSMutableData dataWithData:data];
+            // Size the body once from Content-Length so later chunks append without regrowing it.
+            int64_t expectedLength = dataTask.countOfBytesExpectedToReceive;
+            NSUInteger capacity = expectedLength > 0 ? (NSUInteger)MIN(expectedLength, AWSMaximumPreallocatedResponseLength) : 0;
+            NSMutableData *responseData = [NSMutableData dataWithCapacity:MAX(capacity, [data length])];
+            [responseData appendData:data];
+            delegate.responseData = responseData;
         } else if ([delegate.responseData isKindOfClass:[NSMutableData class]]) {
             [delegate.responseData appendData:data];
         }
@@ -546,19 +681,9 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         
         int64_t bytesWritten = [data length];
         delegate.payloadTotalBytesWritten += bytesWritten;
-        int64_t byteRangeStartPosition = 0;
-        int64_t totalBytesExpectedToWrite = dataTask.response.expectedContentLength;
-        if ([dataTask.response isKindOfClass:[NSHTTPURLResponse class]]) {
-            NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)dataTask.response;
-            NSString *contentRangeString = [[httpResponse allHeaderFields] objectForKey:@"Content-Range"];
-            int64_t trueContentLength = [[[contentRangeString componentsSeparatedByString:@"/"] lastObject] longLongValue];
-            if (trueContentLength) {
-                byteRangeStartPosition = trueContentLength - dataTask.response.expectedContentLength;
-                totalBytesExpectedToWrite = trueContentLength;
-            }
-        }
-        downloadProgress(bytesWritten,delegate.payloadTotalBytesWritten + byteRangeStartPosition,totalBytesExpectedToWrite);
+        downloadProgress(bytesWritten,delegate.payloadTotalBytesWritten + delegate.byteRangeStartPosition,delegate.totalBytesExpectedToWrite);
     }
     
 }
+
 @end
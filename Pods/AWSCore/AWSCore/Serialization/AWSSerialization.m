@@ -363,6 +363,19 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
 @property (nonatomic, strong) AWSXMLDictionaryParser *xmlDictionaryParser;
 
++ (id)parseMember:(id)values rules:(AWSJSONDictionary *)rules error:(NSError *__autoreleasing *)error;
+
+@end
+
+/**
+ Decodes query protocol responses straight from NSXMLParser events into the output shape, without the intermediate AWSXMLDictionaryParser tree. Returns nil from parseData:error: when the document is an error response or cannot be parsed, so the caller can fall back to the dictionary path.
+ */
+@interface AWSXMLStreamingParser : NSObject <NSXMLParserDelegate>
+
+- (instancetype)initWithOutputRules:(AWSJSONDictionary *)rules resultWrappers:(NSSet *)resultWrappers;
+
+- (NSMutableDictionary *)parseData:(NSData *)data error:(NSError *__autoreleasing *)error;
+
 @end
 
 @implementation AWSXMLParser
@@ -459,6 +472,30 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return nil;
     }
 
+    NSString *protocolType = serviceDefinitionRule[@"metadata"][@"type"]?serviceDefinitionRule[@"metadata"][@"type"]:serviceDefinitionRule[@"metadata"][@"protocol"];
+    if ([protocolType isEqualToString:@"query"] && [data isKindOfClass:[NSData class]]) {
+        AWSJSONDictionary *outputRules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+
+        if (!outputRules[@"payload"]) {
+            NSMutableSet *resultWrappers = [NSMutableSet set];
+            NSNumber *isResultWrapped = serviceDefinitionRule[@"metadata"][@"resultWrapped"];
+            if (!isResultWrapped || [isResultWrapped boolValue]) {
+                if (actionRule[@"resultWrapper"]) {
+                    [resultWrappers addObject:actionRule[@"resultWrapper"]];
+                }
+                [resultWrappers addObject:[actionName stringByAppendingString:@"Result"]];
+            }
+
+            AWSXMLStreamingParser *streamingParser = [[AWSXMLStreamingParser alloc] initWithOutputRules:outputRules[@"members"]?outputRules[@"members"]:@{}
+                                                                                          resultWrappers:resultWrappers];
+            NSMutableDictionary *parsedData = [streamingParser parseData:data error:error];
+            if (parsedData) {
+                return parsedData;
+            }
+            //error responses and malformed documents go through the dictionary parser below.
+        }
+    }
+
     NSMutableDictionary *rootXmlDictionary = nil;
     if ([data isKindOfClass:[NSData class]]) {
         @synchronized (self) {
@@ -840,6 +877,417 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 @end
 
 
+typedef NS_ENUM(NSInteger, AWSXMLStreamingFrameType) {
+    AWSXMLStreamingFrameTypeStructure,
+    AWSXMLStreamingFrameTypeList,
+    AWSXMLStreamingFrameTypeMap,
+    AWSXMLStreamingFrameTypeMapEntry,
+    AWSXMLStreamingFrameTypeScalar,
+};
+
+typedef NS_ENUM(NSInteger, AWSXMLStreamingFrameRole) {
+    AWSXMLStreamingFrameRoleMember,
+    AWSXMLStreamingFrameRoleFlattenedMember, //appended to a flattened list or map in the parent structure
+    AWSXMLStreamingFrameRoleMapKey,
+    AWSXMLStreamingFrameRoleMapValue,
+    AWSXMLStreamingFrameRoleDocument, //the root element and result wrapper; write straight into the result
+};
+
+//An open element and the value being decoded for it.
+@interface AWSXMLStreamingFrame : NSObject
+
+@property (nonatomic, assign) AWSXMLStreamingFrameType type;
+@property (nonatomic, assign) AWSXMLStreamingFrameRole role;
+@property (nonatomic, strong) AWSJSONDictionary *rules;
+@property (nonatomic, strong) id value;
+@property (nonatomic, strong) NSString *keyName;
+
+//structure
+@property (nonatomic, strong) AWSJSONDictionary *memberRules;
+@property (nonatomic, strong) NSDictionary *keyNamesByXMLName;
+
+//list, map and map entry
+@property (nonatomic, strong) AWSJSONDictionary *elementRules;
+@property (nonatomic, strong) NSString *elementXMLName;
+@property (nonatomic, strong) NSString *entryKeyXMLName;
+@property (nonatomic, strong) NSString *entryValueXMLName;
+@property (nonatomic, strong) NSString *entryKey;
+@property (nonatomic, strong) id entryValue;
+
+@end
+
+@implementation AWSXMLStreamingFrame
+
+@end
+
+@interface AWSXMLStreamingParser()
+
+@property (nonatomic, strong) AWSJSONDictionary *outputRules;
+@property (nonatomic, strong) NSSet *resultWrappers;
+@property (nonatomic, strong) NSMutableDictionary *result;
+@property (nonatomic, strong) NSMutableArray *frames;
+@property (nonatomic, strong) NSMutableDictionary *structureCache;
+@property (nonatomic, strong) NSError *parseError;
+@property (nonatomic, assign) NSUInteger depth;
+@property (nonatomic, assign) NSUInteger skipDepth;
+@property (nonatomic, assign) BOOL needsFallback;
+
+@end
+
+@implementation AWSXMLStreamingParser
+
+- (instancetype)initWithOutputRules:(AWSJSONDictionary *)rules resultWrappers:(NSSet *)resultWrappers {
+    if (self = [super init]) {
+        _outputRules = rules;
+        _resultWrappers = resultWrappers;
+        _structureCache = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSMutableDictionary *)parseData:(NSData *)data error:(NSError *__autoreleasing *)error {
+    self.result = [NSMutableDictionary new];
+    self.frames = [NSMutableArray new];
+    self.parseError = nil;
+    self.depth = 0;
+    self.skipDepth = 0;
+    self.needsFallback = NO;
+
+    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:data];
+    parser.delegate = self;
+
+    if (![parser parse] || self.needsFallback) {
+        return nil;
+    }
+
+    if (error && self.parseError) {
+        *error = self.parseError;
+    }
+
+    return self.result;
+}
+
+#pragma mark - Frames -
+
+//Mirrors +[AWSXMLParser findKeyNameByXMLName:rules:], resolved once per shape instead of once per element.
+- (NSDictionary *)keyNamesByXMLNameForRules:(AWSJSONDictionary *)rules {
+    NSMutableDictionary *keyNames = [NSMutableDictionary new];
+
+    [rules enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
+        NSMutableArray *xmlNames = [NSMutableArray arrayWithObject:key];
+
+        if ([obj isKindOfClass:[NSDictionary class]] && ([obj[@"type"] isEqualToString:@"list"] || [obj[@"type"] isEqualToString:@"map"])) {
+            if ([obj[@"flattened"] boolValue]) {
+                NSString *objXMLName = obj[@"member"][@"locationName"]?obj[@"member"][@"locationName"]:obj[@"locationName"];
+                [xmlNames addObject:objXMLName?objXMLName:@"member"];
+            } else if (obj[@"locationName"]) {
+                [xmlNames addObject:obj[@"locationName"]];
+            }
+        }
+
+        if ([obj isKindOfClass:[NSDictionary class]] && obj[@"locationName"]) {
+            [xmlNames addObject:obj[@"locationName"]];
+        }
+
+        for (NSString *xmlName in xmlNames) {
+            if (!keyNames[xmlName]) {
+                keyNames[xmlName] = key;
+            }
+        }
+    }];
+
+    return keyNames;
+}
+
+- (void)prepareStructureFrame:(AWSXMLStreamingFrame *)frame memberRules:(AWSJSONDictionary *)memberRules shapeName:(NSString *)shapeName {
+    NSArray *cached = shapeName ? self.structureCache[shapeName] : nil;
+
+    if (!cached) {
+        cached = @[memberRules, [self keyNamesByXMLNameForRules:memberRules]];
+        if (shapeName) {
+            self.structureCache[shapeName] = cached;
+        }
+    }
+
+    frame.type = AWSXMLStreamingFrameTypeStructure;
+    frame.memberRules = cached[0];
+    frame.keyNamesByXMLName = cached[1];
+}
+
+- (AWSXMLStreamingFrame *)frameForRules:(AWSJSONDictionary *)rules {
+    AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+    frame.rules = rules;
+
+    NSString *rulesType = rules[@"type"];
+    if ([rulesType isEqualToString:@"structure"]) {
+        NSString *shapeName = rules[@"shape"];
+        [self prepareStructureFrame:frame
+                        memberRules:rules[@"members"]?rules[@"members"]:@{}
+                          shapeName:shapeName];
+        frame.value = [NSMutableDictionary new];
+    } else if ([rulesType isEqualToString:@"list"]) {
+        AWSJSONDictionary *memberRules = rules[@"member"]?rules[@"member"]:@{};
+        frame.type = AWSXMLStreamingFrameTypeList;
+        frame.elementRules = memberRules;
+        frame.elementXMLName = memberRules[@"locationName"]?memberRules[@"locationName"]:@"member";
+        frame.value = [NSMutableArray new];
+    } else if ([rulesType isEqualToString:@"map"]) {
+        frame.type = AWSXMLStreamingFrameTypeMap;
+        [self prepareMapFrame:frame mapRules:rules];
+        frame.value = [NSMutableDictionary new];
+    } else {
+        frame.type = AWSXMLStreamingFrameTypeScalar;
+        frame.value = [NSMutableString new];
+    }
+
+    return frame;
+}
+
+- (void)prepareMapFrame:(AWSXMLStreamingFrame *)frame mapRules:(AWSJSONDictionary *)rules {
+    AWSJSONDictionary *keyRules = rules[@"key"]?rules[@"key"]:@{};
+    AWSJSONDictionary *valueRules = rules[@"value"]?rules[@"value"]:@{};
+    frame.elementRules = valueRules;
+    frame.entryKeyXMLName = keyRules[@"locationName"]?keyRules[@"locationName"]:@"key";
+    frame.entryValueXMLName = valueRules[@"locationName"]?valueRules[@"locationName"]:@"value";
+}
+
+- (void)pushFrame:(AWSXMLStreamingFrame *)frame {
+    [self.frames addObject:frame];
+}
+
+- (void)skipElement {
+    self.skipDepth = 1;
+}
+
+- (void)fallBackWithParser:(NSXMLParser *)parser {
+    self.needsFallback = YES;
+    [parser abortParsing];
+}
+
+- (void)startEntryChild:(NSString *)elementName ofFrame:(AWSXMLStreamingFrame *)parent {
+    if ([elementName isEqualToString:parent.entryKeyXMLName]) {
+        AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+        frame.type = AWSXMLStreamingFrameTypeScalar;
+        frame.role = AWSXMLStreamingFrameRoleMapKey;
+        frame.value = [NSMutableString new];
+        [self pushFrame:frame];
+    } else if ([elementName isEqualToString:parent.entryValueXMLName]) {
+        AWSXMLStreamingFrame *frame = [self frameForRules:parent.elementRules];
+        frame.role = AWSXMLStreamingFrameRoleMapValue;
+        [self pushFrame:frame];
+    } else {
+        [self skipElement];
+    }
+}
+
+- (AWSXMLStreamingFrame *)entryFrameForMapRules:(AWSJSONDictionary *)rules {
+    AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+    frame.type = AWSXMLStreamingFrameTypeMapEntry;
+    frame.rules = rules;
+    [self prepareMapFrame:frame mapRules:rules];
+    return frame;
+}
+
+- (void)startStructureChild:(NSString *)elementName ofFrame:(AWSXMLStreamingFrame *)parent {
+    NSString *keyName = parent.keyNamesByXMLName[elementName];
+    if (!keyName) {
+        if (![elementName isEqualToString:@"_xmlns"] &&
+            ![elementName isEqualToString:@"requestId"] &&
+            ![elementName isEqualToString:@"ResponseMetadata"]) {
+            AWSLogWarn(@"Response element ignored: no rule for %@", elementName);
+        }
+        [self skipElement];
+        return;
+    }
+
+    AWSJSONDictionary *rule = parent.memberRules[keyName];
+    NSString *rulesType = rule[@"type"];
+    AWSXMLStreamingFrame *frame = nil;
+
+    //flattened lists and maps repeat the element in the parent, one per member.
+    if ([rule[@"flattened"] boolValue] && [rulesType isEqualToString:@"list"]) {
+        frame = [self frameForRules:rule[@"member"]?rule[@"member"]:@{}];
+        frame.role = AWSXMLStreamingFrameRoleFlattenedMember;
+    } else if ([rule[@"flattened"] boolValue] && [rulesType isEqualToString:@"map"]) {
+        frame = [self entryFrameForMapRules:rule];
+        frame.role = AWSXMLStreamingFrameRoleFlattenedMember;
+    } else {
+        frame = [self frameForRules:rule];
+    }
+
+    frame.keyName = rule[@"name"]?rule[@"name"]:keyName;
+    [self pushFrame:frame];
+}
+
+- (id)finishFrame:(AWSXMLStreamingFrame *)frame {
+    switch (frame.type) {
+        case AWSXMLStreamingFrameTypeScalar: {
+            if (frame.role == AWSXMLStreamingFrameRoleMapKey) {
+                return frame.value;
+            }
+            NSError *error = nil;
+            id value = [AWSXMLParser parseMember:frame.value rules:frame.rules error:&error];
+            if (error && !self.parseError) {
+                self.parseError = error;
+            }
+            return value;
+        }
+        case AWSXMLStreamingFrameTypeMap:
+            //a non-flattened map may hold a single key and value without an entry element.
+            if (frame.entryKey) {
+                frame.value[frame.entryKey] = frame.entryValue?frame.entryValue:[AWSXMLParser parseMember:nil rules:frame.elementRules error:nil];
+            }
+            return frame.value;
+        default:
+            return frame.value;
+    }
+}
+
+- (void)finishEntry:(AWSXMLStreamingFrame *)entry intoDictionary:(NSMutableDictionary *)dictionary {
+    if (entry.entryKey) {
+        dictionary[entry.entryKey] = entry.entryValue?entry.entryValue:[AWSXMLParser parseMember:nil rules:entry.elementRules error:nil];
+    }
+}
+
+#pragma mark - NSXMLParserDelegate -
+
+- (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict {
+    self.depth++;
+
+    if (self.skipDepth > 0) {
+        self.skipDepth++;
+        return;
+    }
+
+    if (self.depth == 1) {
+        //S3 style error document.
+        if ([elementName isEqualToString:@"Error"]) {
+            [self fallBackWithParser:parser];
+            return;
+        }
+
+        AWSXMLStreamingFrame *frame = [AWSXMLStreamingFrame new];
+        frame.role = AWSXMLStreamingFrameRoleDocument;
+        frame.value = self.result;
+        [self prepareStructureFrame:frame memberRules:self.outputRules shapeName:nil];
+        [self pushFrame:frame];
+        return;
+    }
+
+    if (self.depth == 2) {
+        if ([elementName isEqualToString:@"Error"] || [elementName isEqualToString:@"Errors"]) {
+            [self fallBackWithParser:parser];
+            return;
+        }
+
+        if ([self.resultWrappers containsObject:elementName]) {
+            [self pushFrame:[self.frames lastObject]];
+            return;
+        }
+    }
+
+    AWSXMLStreamingFrame *parent = [self.frames lastObject];
+
+    switch (parent.type) {
+        case AWSXMLStreamingFrameTypeStructure:
+            [self startStructureChild:elementName ofFrame:parent];
+            break;
+        case AWSXMLStreamingFrameTypeList:
+            if ([elementName isEqualToString:parent.elementXMLName]) {
+                [self pushFrame:[self frameForRules:parent.elementRules]];
+            } else {
+                [self skipElement];
+            }
+            break;
+        case AWSXMLStreamingFrameTypeMap:
+            if ([elementName isEqualToString:@"entry"]) {
+                [self pushFrame:[self entryFrameForMapRules:parent.rules]];
+            } else {
+                [self startEntryChild:elementName ofFrame:parent];
+            }
+            break;
+        case AWSXMLStreamingFrameTypeMapEntry:
+            [self startEntryChild:elementName ofFrame:parent];
+            break;
+        case AWSXMLStreamingFrameTypeScalar:
+            [self skipElement];
+            break;
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName {
+    self.depth--;
+
+    if (self.skipDepth > 0) {
+        self.skipDepth--;
+        return;
+    }
+
+    AWSXMLStreamingFrame *frame = [self.frames lastObject];
+    [self.frames removeLastObject];
+
+    if (frame.role == AWSXMLStreamingFrameRoleDocument) {
+        return;
+    }
+
+    AWSXMLStreamingFrame *parent = [self.frames lastObject];
+
+    switch (frame.role) {
+        case AWSXMLStreamingFrameRoleMapKey:
+            parent.entryKey = [self finishFrame:frame];
+            break;
+        case AWSXMLStreamingFrameRoleMapValue:
+            parent.entryValue = [self finishFrame:frame];
+            break;
+        case AWSXMLStreamingFrameRoleFlattenedMember:
+            if (frame.type == AWSXMLStreamingFrameTypeMapEntry) {
+                NSMutableDictionary *map = parent.value[frame.keyName];
+                if (![map isKindOfClass:[NSMutableDictionary class]]) {
+                    map = [NSMutableDictionary new];
+                    parent.value[frame.keyName] = map;
+                }
+                [self finishEntry:frame intoDictionary:map];
+            } else {
+                NSMutableArray *list = parent.value[frame.keyName];
+                if (![list isKindOfClass:[NSMutableArray class]]) {
+                    list = [NSMutableArray new];
+                    parent.value[frame.keyName] = list;
+                }
+                [list addObject:[self finishFrame:frame]];
+            }
+            break;
+        default:
+            if (frame.type == AWSXMLStreamingFrameTypeMapEntry) {
+                [self finishEntry:frame intoDictionary:parent.value];
+            } else if (parent.type == AWSXMLStreamingFrameTypeList) {
+                [parent.value addObject:[self finishFrame:frame]];
+            } else {
+                parent.value[frame.keyName] = [self finishFrame:frame];
+            }
+            break;
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string {
+    if (self.skipDepth > 0) {
+        return;
+    }
+
+    AWSXMLStreamingFrame *frame = [self.frames lastObject];
+    if (frame.type == AWSXMLStreamingFrameTypeScalar) {
+        [frame.value appendString:string];
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser foundCDATA:(NSData *)CDATABlock {
+    NSString *string = [[NSString alloc] initWithData:CDATABlock encoding:NSUTF8StringEncoding];
+    if (string) {
+        [self parser:parser foundCharacters:string];
+    }
+}
+
+@end
+
 @implementation AWSQueryParamBuilder
 
 + (BOOL)failWithCode:(NSInteger)code description:(NSString *)description error:(NSError *__autoreleasing *)error {
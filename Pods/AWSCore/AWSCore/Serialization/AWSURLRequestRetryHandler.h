@@ -24,3 +24,31 @@
 - (instancetype)initWithMaximumRetryCount:(uint32_t)maxRetryCount;
 
 @end
+
+/**
+ A token bucket that limits how many retries the requests sharing it may issue. Each retry spends `retryCost` tokens and each successful request returns `successRefill` tokens, up to `capacity`. When the bucket runs dry, failed requests are no longer retried, so a service brownout does not multiply the traffic sent to it.
+ */
+@interface AWSURLRequestRetryBudget : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger capacity;
+@property (nonatomic, assign, readonly) NSUInteger retryCost;
+@property (nonatomic, assign, readonly) NSUInteger successRefill;
+@property (nonatomic, assign, readonly) NSUInteger availableTokens;
+
+/**
+ Returns a budget with a capacity of 500 tokens, a retry cost of 5 tokens and a refill of 1 token per success.
+ */
+- (instancetype)init;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                       retryCost:(NSUInteger)retryCost
+                   successRefill:(NSUInteger)successRefill;
+
+/**
+ Spends the cost of one retry. Returns `NO`, and spends nothing, if the bucket does not hold enough tokens.
+ */
+- (BOOL)acquireRetry;
+
+- (void)recordSuccess;
+
+@end
@@ -100,7 +100,57 @@
                               response:(NSHTTPURLResponse *)response
                                   data:(NSData *)data
                                  error:(NSError *)error {
-    return pow(2, currentRetryCount) * 100 / 1000;
+    // Exponential backoff with equal jitter: half of the delay is fixed and half is random, so
+    // requests that failed together do not all come back at the same instant.
+    NSTimeInterval backoff = pow(2, currentRetryCount) * 100 / 1000;
+    return backoff / 2 + backoff / 2 * ((double)arc4random_uniform(UINT32_MAX) / UINT32_MAX);
+}
+
+@end
+
+#pragma mark - AWSURLRequestRetryBudget
+
+@implementation AWSURLRequestRetryBudget
+
+- (instancetype)init {
+    return [self initWithCapacity:500
+                        retryCost:5
+                    successRefill:1];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                       retryCost:(NSUInteger)retryCost
+                   successRefill:(NSUInteger)successRefill {
+    if (self = [super init]) {
+        _capacity = capacity;
+        _retryCost = retryCost;
+        _successRefill = successRefill;
+        _availableTokens = capacity;
+    }
+
+    return self;
+}
+
+- (NSUInteger)availableTokens {
+    @synchronized(self) {
+        return _availableTokens;
+    }
+}
+
+- (BOOL)acquireRetry {
+    @synchronized(self) {
+        if (_availableTokens < _retryCost) {
+            return NO;
+        }
+        _availableTokens -= _retryCost;
+        return YES;
+    }
+}
+
+- (void)recordSuccess {
+    @synchronized(self) {
+        _availableTokens = MIN(_capacity, _availableTokens + _successRefill);
+    }
 }
 
 @end
@@ -29,7 +29,7 @@ typedef NS_ENUM(NSInteger, AWSGeneralErrorType) {
     AWSGeneralErrorAuthFailure
 };
 
-@interface AWSJSONResponseSerializer : NSObject <AWSHTTPURLResponseSerializer>
+@interface AWSJSONResponseSerializer : NSObject <AWSHTTPURLResponseStreamingSerializer>
 
 @property (nonatomic, strong, readonly) NSDictionary *serviceDefinitionJSON;
 @property (nonatomic, strong, readonly) NSString *actionName;
@@ -41,7 +41,7 @@ typedef NS_ENUM(NSInteger, AWSGeneralErrorType) {
 
 @end
 
-@interface AWSXMLResponseSerializer : NSObject <AWSHTTPURLResponseSerializer>
+@interface AWSXMLResponseSerializer : NSObject <AWSHTTPURLResponseStreamingSerializer>
 
 @property (nonatomic, assign) Class outputClass;
 
@@ -27,6 +27,94 @@ NSString *const AWSGeneralErrorDomain = @"com.amazonaws.AWSGeneralErrorDomain";
 
 static NSDictionary *errorCodeDictionary = nil;
 
+#pragma mark - Streaming response bodies
+
+// Collects a successful response body in pooled buffers and parses it with the serializer's buffered path once the task completes.
+@interface AWSResponseBodyStream : NSObject <AWSHTTPURLResponseStream>
+
++ (instancetype)streamWithSerializer:(id<AWSHTTPURLResponseSerializer>)serializer
+                            response:(NSHTTPURLResponse *)response
+               serviceDefinitionJSON:(NSDictionary *)serviceDefinitionJSON
+                          actionName:(NSString *)actionName;
+
+@end
+
+@implementation AWSResponseBodyStream {
+    id<AWSHTTPURLResponseSerializer> _serializer;
+    NSHTTPURLResponse *_response;
+    NSMutableData *_buffer;
+    NSUInteger _length;
+}
+
++ (instancetype)streamWithSerializer:(id<AWSHTTPURLResponseSerializer>)serializer
+                            response:(NSHTTPURLResponse *)response
+               serviceDefinitionJSON:(NSDictionary *)serviceDefinitionJSON
+                          actionName:(NSString *)actionName {
+    // A payload member may hand the body data itself to the caller, so it has to outlive the pooled buffer.
+    NSDictionary *shapeRules = [serviceDefinitionJSON objectForKey:@"shapes"];
+    NSDictionary *actionRules = [[serviceDefinitionJSON objectForKey:@"operations"] objectForKey:actionName];
+    AWSJSONDictionary *outputRules = [[AWSJSONDictionary alloc] initWithDictionary:[actionRules objectForKey:@"output"] JSONDefinitionRule:shapeRules];
+    if (outputRules[@"payload"]) {
+        return nil;
+    }
+
+    AWSResponseBodyStream *stream = [self new];
+    stream->_serializer = serializer;
+    stream->_response = response;
+    int64_t expectedLength = response.expectedContentLength;
+    stream->_buffer = [[AWSNetworkingBufferPool sharedPool] bufferWithMinimumLength:expectedLength > 0 ? (NSUInteger)expectedLength : 0];
+
+    return stream;
+}
+
+- (void)dealloc {
+    [self recycleBuffer];
+}
+
+- (void)recycleBuffer {
+    if (_buffer) {
+        [[AWSNetworkingBufferPool sharedPool] recycleBuffer:_buffer];
+        _buffer = nil;
+    }
+}
+
+- (BOOL)consumeResponseBytes:(const void *)bytes
+                      length:(NSUInteger)length
+                       error:(NSError *__autoreleasing *)error {
+    NSUInteger requiredLength = _length + length;
+    if (requiredLength > [_buffer length]) {
+        // Grow geometrically so bodies beyond the largest size class are not copied on every chunk.
+        NSMutableData *buffer = [[AWSNetworkingBufferPool sharedPool] bufferWithMinimumLength:MAX(requiredLength, [_buffer length] * 2)];
+        memcpy([buffer mutableBytes], [_buffer bytes], _length);
+        [self recycleBuffer];
+        _buffer = buffer;
+    }
+
+    memcpy((uint8_t *)[_buffer mutableBytes] + _length, bytes, length);
+    _length = requiredLength;
+
+    return YES;
+}
+
+- (id)finishWithOriginalRequest:(NSURLRequest *)originalRequest
+                 currentRequest:(NSURLRequest *)currentRequest
+                          error:(NSError *__autoreleasing *)error {
+    NSData *data = nil;
+    if (_length > 0) {
+        data = [NSData dataWithBytesNoCopy:[_buffer mutableBytes] length:_length freeWhenDone:NO];
+    }
+    id responseObject = [_serializer responseObjectForResponse:_response
+                                               originalRequest:originalRequest
+                                                currentRequest:currentRequest
+                                                          data:data
+                                                         error:error];
+    [self recycleBuffer];
+
+    return responseObject;
+}
+
+@end
+
 @interface AWSJSONResponseSerializer()
 
 @property (nonatomic, strong) NSDictionary *serviceDefinitionJSON;
@@ -126,6 +214,13 @@ static NSDictionary *errorCodeDictionary = nil;
     return result;
 }
 
+- (id<AWSHTTPURLResponseStream>)responseStreamForResponse:(NSHTTPURLResponse *)response {
+    return [AWSResponseBodyStream streamWithSerializer:self
+                                              response:response
+                                 serviceDefinitionJSON:self.serviceDefinitionJSON
+                                            actionName:self.actionName];
+}
+
 - (BOOL)validateResponse:(NSHTTPURLResponse *)response
              fromRequest:(NSURLRequest *)request
                     data:(id)data
@@ -180,6 +275,13 @@ static NSDictionary *errorCodeDictionary = nil;
     return YES;
 }
 
+- (id<AWSHTTPURLResponseStream>)responseStreamForResponse:(NSHTTPURLResponse *)response {
+    return [AWSResponseBodyStream streamWithSerializer:self
+                                              response:response
+                                 serviceDefinitionJSON:self.serviceDefinitionJSON
+                                            actionName:self.actionName];
+}
+
 + (NSMutableDictionary *)parseResponse:(NSHTTPURLResponse *)response
                                  rules:(AWSJSONDictionary *)rules
                         bodyDictionary:(NSMutableDictionary *)bodyDictionary
@@ -73,6 +73,18 @@ typedef void (^AWSTMCacheObjectBlock)(AWSTMCache *cache, NSString *key, id objec
  */
 - (instancetype)initWithName:(NSString *)name;
 
+/**
+ Multiple instances with the same name are allowed and can safely access
+ the same data on disk thanks to the magic of seriality. Also used to create the <diskCache>, which stores
+ objects one file per key.
+ 
+ @see name
+ @param name The name of the cache.
+ @param rootPath The path of the cache on disk.
+ @result A new cache with the specified name.
+ */
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath;
+
 /**
  The designated initializer. Multiple instances with the same name are allowed and can safely access
  the same data on disk thanks to the magic of seriality. Also used to create the <diskCache>.
@@ -80,9 +92,10 @@ typedef void (^AWSTMCacheObjectBlock)(AWSTMCache *cache, NSString *key, id objec
  @see name
  @param name The name of the cache.
  @param rootPath The path of the cache on disk.
+ @param diskStorage The layout of objects on disk, see `AWSTMDiskCacheStorage`.
  @result A new cache with the specified name.
  */
-- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath;
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath diskStorage:(AWSTMDiskCacheStorage)diskStorage;
 
 #pragma mark -
 /// @name Asynchronous Methods
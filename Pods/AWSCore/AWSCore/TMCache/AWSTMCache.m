@@ -29,6 +29,11 @@ NSString * const AWSTMCacheSharedName = @"TMCacheShared";
 }
 
 - (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath
+{
+    return [self initWithName:name rootPath:rootPath diskStorage:AWSTMDiskCacheStorageFilePerKey];
+}
+
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath diskStorage:(AWSTMDiskCacheStorage)diskStorage
 {
     if (!name)
         return nil;
@@ -39,7 +44,7 @@ NSString * const AWSTMCacheSharedName = @"TMCacheShared";
         NSString *queueName = [[NSString alloc] initWithFormat:@"%@.%p", AWSTMCachePrefix, self];
         _queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_CONCURRENT);
 
-        _diskCache = [[AWSTMDiskCache alloc] initWithName:_name rootPath:rootPath];
+        _diskCache = [[AWSTMDiskCache alloc] initWithName:_name rootPath:rootPath storage:diskStorage];
         _memoryCache = [[AWSTMMemoryCache alloc] init];
     }
     return self;
@@ -1,19 +1,20 @@
 /**
  `TMDiskCache` is a thread safe key/value store backed by the file system. It accepts any object conforming
  to the `NSCoding` protocol, which includes the basic Foundation data types and collection classes and also
- many UIKit classes, notably `UIImage`. All work is performed on a serial queue shared by all instances in
+ many UIKit classes, notably `UIImage`. All work is performed on a concurrent queue shared by all instances in
  the app, and archiving is handled by `NSKeyedArchiver`. This is a particular advantage for `UIImage` because
  it skips `UIImagePNGRepresentation()` and retains information like scale and orientation.
  
  The designated initializer for `TMDiskCache` is <initWithName:>. The <name> string is used to create a directory
  under Library/Caches that scopes disk access for any instance sharing this name. Multiple instances with the
- same name are allowed because all disk access is serialized on the <sharedQueue>. The <name> also appears in
+ same name are allowed because all changes to the disk are serialized on the <sharedQueue>. The <name> also appears in
  stack traces and return value for `description:`.
  
- Unless otherwise noted, all properties and methods are safe to access from any thread at any time. All blocks
- will cause the queue to wait, making it safe to access and manipulate the actual cache files on disk for the
- duration of the block. In addition, the <sharedQueue> can be set to target an existing serial I/O queue, should
- your app already have one.
+ Unless otherwise noted, all properties and methods are safe to access from any thread at any time. Lookups run
+ concurrently with each other, so one slow decode does not hold up other reads. Everything that changes the cache
+ runs as a barrier: no other block runs alongside it, which makes it safe to access and manipulate the actual cache
+ files on disk for the duration of the block. In addition, the <sharedQueue> can be set to target an existing I/O
+ queue, should your app already have one.
  
  Because this cache is bound by disk I/O it can be much slower than <TMMemoryCache>, although values stored in
  `TMDiskCache` persist after application relaunch. Using <TMCache> is recommended over using `TMDiskCache`
@@ -21,6 +22,9 @@
 
  All access to the cache is dated so the that the least-used objects can be trimmed first. Setting an optional
  <ageLimit> will trigger a GCD timer to periodically to trim the cache with <trimToDate:>.
+
+ The size and last access date of every object are kept in an index journal inside the cache directory. It is
+ read once when the cache starts, so neither lookups nor trimming need to touch the file system metadata.
  */
 
 #import <Foundation/Foundation.h>
@@ -28,6 +32,19 @@
 @class AWSTMDiskCache;
 
 typedef void (^AWSTMDiskCacheBlock)(AWSTMDiskCache *cache);
+/**
+ How a disk cache lays out its objects on disk.
+ */
+typedef NS_ENUM(NSInteger, AWSTMDiskCacheStorage) {
+    /** One archive file per key, named after the key. Blocks receive the URL of that file. */
+    AWSTMDiskCacheStorageFilePerKey,
+    /**
+     Archives packed into append-only segment files that are read through memory maps. This is much cheaper for
+     many small objects. There are no per-key files, so the `fileURL` passed to blocks is always `nil`.
+     */
+    AWSTMDiskCacheStorageSegments,
+};
+
 typedef void (^AWSTMDiskCacheObjectBlock)(AWSTMDiskCache *cache, NSString *key, id <NSCoding> object, NSURL *fileURL);
 
 @interface AWSTMDiskCache : NSObject
@@ -47,6 +64,12 @@ typedef void (^AWSTMDiskCacheObjectBlock)(AWSTMDiskCache *cache, NSString *key,
  */
 @property (readonly) NSURL *cacheURL;
 
+/**
+ The layout of objects on disk, chosen when the cache is created. Caches that share a <name> must use the same
+ storage.
+ */
+@property (readonly) AWSTMDiskCacheStorage storage;
+
 /**
  The total number of bytes used on disk, as reported by `NSURLTotalFileAllocatedSizeKey`.
  
@@ -127,8 +150,9 @@ typedef void (^AWSTMDiskCacheObjectBlock)(AWSTMDiskCache *cache, NSString *key,
 + (instancetype)sharedCache;
 
 /**
- A shared serial queue, used by all instances of this class. Use `dispatch_set_target_queue` to integrate
- this queue with an exisiting serial I/O queue.
+ A shared concurrent queue, used by all instances of this class. Lookups run on it concurrently and every
+ change to the cache runs as a barrier block. Use `dispatch_set_target_queue` to integrate this queue with an
+ exisiting I/O queue; targeting a serial queue serializes lookups again.
  
  @result The shared singleton queue instance.
  */
@@ -150,41 +174,54 @@ typedef void (^AWSTMDiskCacheObjectBlock)(AWSTMDiskCache *cache, NSString *key,
  */
 - (instancetype)initWithName:(NSString *)name;
 
+/**
+ Multiple instances with the same name are allowed and can safely access
+ the same data on disk thanks to the magic of seriality. Objects are stored one file per key.
+ 
+ @see name
+ @param name The name of the cache.
+ @param rootPath The path of the cache.
+ @result A new cache with the specified name.
+ */
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath;
+
 /**
  The designated initializer. Multiple instances with the same name are allowed and can safely access
  the same data on disk thanks to the magic of seriality.
  
  @see name
+ @see storage
  @param name The name of the cache.
  @param rootPath The path of the cache.
+ @param storage The layout of objects on disk.
  @result A new cache with the specified name.
  */
-- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath;
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath storage:(AWSTMDiskCacheStorage)storage;
 
 #pragma mark -
 /// @name Asynchronous Methods
 
 /**
  Retrieves the object for the specified key. This method returns immediately and executes the passed
- block as soon as the object is available on the serial <sharedQueue>.
+ block as soon as the object is available on the <sharedQueue>, possibly alongside other lookups.
  
  @warning The fileURL is only valid for the duration of this block, do not use it after the block ends.
  
  @param key The key associated with the requested object.
- @param block A block to be executed serially when the object is available.
+ @param block A block to be executed when the object is available.
  */
 - (void)objectForKey:(NSString *)key block:(AWSTMDiskCacheObjectBlock)block;
 
 /**
  Retrieves the fileURL for the specified key without actually reading the data from disk. This method
- returns immediately and executes the passed block as soon as the object is available on the serial
- <sharedQueue>.
+ returns immediately and executes the passed block as soon as the object is available on the
+ <sharedQueue>, possibly alongside other lookups.
  
  @warning Access is protected for the duration of the block, but to maintain safe disk access do not
  access this fileURL after the block has ended. Do all work on the <sharedQueue>.
  
  @param key The key associated with the requested object.
- @param block A block to be executed serially when the file URL is available.
+ @param block A block to be executed when the file URL is available.
  */
 - (void)fileURLForKey:(NSString *)key block:(AWSTMDiskCacheObjectBlock)block;
 
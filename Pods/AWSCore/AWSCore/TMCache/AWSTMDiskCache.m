@@ -4,29 +4,917 @@
 #import <UIKit/UIKit.h>
 #endif
 
+#import <fcntl.h>
+#import <pthread.h>
+#import <libkern/OSAtomic.h>
+
 #define TMDiskCacheError(error) if (error) { NSLog(@"%@ (%d) ERROR: %@", \
                                     [[NSString stringWithUTF8String:__FILE__] lastPathComponent], \
                                     __LINE__, [error localizedDescription]); }
 
-#if __IPHONE_OS_VERSION_MIN_REQUIRED >= __IPHONE_4_0 && defined(__clang) && defined(__has_feature) && !__has_feature(attribute_availability_app_extension)
-    #define TMCacheStartBackgroundTask() UIBackgroundTaskIdentifier taskID = UIBackgroundTaskInvalid; \
-            taskID = [[UIApplication sharedApplication] beginBackgroundTaskWithExpirationHandler:^{ \
-            [[UIApplication sharedApplication] endBackgroundTask:taskID]; }];
-    #define TMCacheEndBackgroundTask() [[UIApplication sharedApplication] endBackgroundTask:taskID];
-#else
-    #define TMCacheStartBackgroundTask()
-    #define TMCacheEndBackgroundTask()
-#endif
+#if __IPHONE_OS_VERSION_MIN_REQUIRED >= __IPHONE_4_0 && defined(__clang) && defined(__has_feature) && !__has_feature(attribute_availability_app_extension)
+    #define TMCacheStartBackgroundTask() UIBackgroundTaskIdentifier taskID = UIBackgroundTaskInvalid; \
+            taskID = [[UIApplication sharedApplication] beginBackgroundTaskWithExpirationHandler:^{ \
+            [[UIApplication sharedApplication] endBackgroundTask:taskID]; }];
+    #define TMCacheEndBackgroundTask() [[UIApplication sharedApplication] endBackgroundTask:taskID];
+#else
+    #define TMCacheStartBackgroundTask()
+    #define TMCacheEndBackgroundTask()
+#endif
+
+NSString * const AWSTMDiskCachePrefix = @"com.tumblr.TMDiskCache";
+NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
+
+#pragma mark - Index -
+
+// On-disk layout of the index journal. The journal is a header followed by fixed-size record headers, each
+// immediately followed by its UTF-8 key. It is only ever read back by the device that wrote it, so values are
+// stored in host byte order.
+static const uint32_t AWSTMDiskCacheJournalMagic = 0x4a4d5441; // "ATMJ"
+static const uint32_t AWSTMDiskCacheJournalVersion = 2;
+static const size_t AWSTMDiskCacheJournalHeaderLength = 8;
+static const size_t AWSTMDiskCacheJournalRecordLength = 33; // op (1) + key length (4) + byte count (8) + access time (8) + segment (4) + offset (8)
+static const NSUInteger AWSTMDiskCacheJournalFlushThreshold = 16 * 1024;
+static const NSTimeInterval AWSTMDiskCacheJournalFlushDelay = 5.0;
+static const NSUInteger AWSTMDiskCacheJournalMinimumCompactionCount = 1024;
+static NSString * const AWSTMDiskCacheJournalFileName = @".index"; // never collides with a key, dots are escaped
+static NSString * const AWSTMDiskCacheSegmentFilePrefix = @".segment-";
+static const uint64_t AWSTMDiskCacheSegmentMaximumLength = 4 * 1024 * 1024;
+static const uint64_t AWSTMDiskCacheSegmentMinimumCompactionLength = 1024 * 1024;
+
+typedef NS_ENUM(uint8_t, AWSTMDiskCacheJournalOperation) {
+    AWSTMDiskCacheJournalOperationSet = 1,
+    AWSTMDiskCacheJournalOperationTouch = 2,
+    AWSTMDiskCacheJournalOperationRemove = 3,
+};
+
+typedef NS_ENUM(NSInteger, AWSTMDiskCacheHeapOrder) {
+    AWSTMDiskCacheHeapOrderOldestFirst,
+    AWSTMDiskCacheHeapOrderLargestFirst,
+};
+
+@interface AWSTMDiskCacheIndexEntry : NSObject
+@property (copy, nonatomic) NSString *key;
+@property (assign, nonatomic) NSUInteger byteCount;
+@property (assign, nonatomic) NSTimeInterval accessTime;
+@property (assign, nonatomic) uint32_t segment; // segment storage only
+@property (assign, nonatomic) uint64_t offset; // segment storage only
+@property (assign, nonatomic) NSUInteger dateHeapIndex;
+@property (assign, nonatomic) NSUInteger sizeHeapIndex;
+@end
+
+@implementation AWSTMDiskCacheIndexEntry
+@end
+
+// A binary heap of index entries. Every entry records its own position in each heap, so an entry can be
+// re-prioritized or removed in O(log n) without searching.
+@interface AWSTMDiskCacheHeap : NSObject
+@property (assign, nonatomic, readonly) AWSTMDiskCacheHeapOrder order;
+@property (strong, nonatomic) NSMutableArray *entries;
+@end
+
+@implementation AWSTMDiskCacheHeap
+
+- (instancetype)initWithOrder:(AWSTMDiskCacheHeapOrder)order
+{
+    if (self = [super init]) {
+        _order = order;
+        _entries = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSUInteger)count
+{
+    return [_entries count];
+}
+
+- (AWSTMDiskCacheIndexEntry *)top
+{
+    return [_entries firstObject];
+}
+
+- (BOOL)entry:(AWSTMDiskCacheIndexEntry *)entry precedes:(AWSTMDiskCacheIndexEntry *)other
+{
+    if (_order == AWSTMDiskCacheHeapOrderOldestFirst)
+        return entry.accessTime < other.accessTime;
+
+    return entry.byteCount > other.byteCount;
+}
+
+- (void)setPosition:(NSUInteger)position ofEntry:(AWSTMDiskCacheIndexEntry *)entry
+{
+    if (_order == AWSTMDiskCacheHeapOrderOldestFirst)
+        entry.dateHeapIndex = position;
+    else
+        entry.sizeHeapIndex = position;
+}
+
+- (NSUInteger)positionOfEntry:(AWSTMDiskCacheIndexEntry *)entry
+{
+    return _order == AWSTMDiskCacheHeapOrderOldestFirst ? entry.dateHeapIndex : entry.sizeHeapIndex;
+}
+
+- (void)swapPosition:(NSUInteger)position withPosition:(NSUInteger)otherPosition
+{
+    [_entries exchangeObjectAtIndex:position withObjectAtIndex:otherPosition];
+    [self setPosition:position ofEntry:[_entries objectAtIndex:position]];
+    [self setPosition:otherPosition ofEntry:[_entries objectAtIndex:otherPosition]];
+}
+
+- (NSUInteger)siftUp:(NSUInteger)position
+{
+    while (position > 0) {
+        NSUInteger parent = (position - 1) / 2;
+        if (![self entry:[_entries objectAtIndex:position] precedes:[_entries objectAtIndex:parent]])
+            break;
+
+        [self swapPosition:position withPosition:parent];
+        position = parent;
+    }
+    return position;
+}
+
+- (void)siftDown:(NSUInteger)position
+{
+    NSUInteger count = [_entries count];
+
+    while (YES) {
+        NSUInteger first = position;
+        NSUInteger left = 2 * position + 1;
+        NSUInteger right = left + 1;
+
+        if (left < count && [self entry:[_entries objectAtIndex:left] precedes:[_entries objectAtIndex:first]])
+            first = left;
+        if (right < count && [self entry:[_entries objectAtIndex:right] precedes:[_entries objectAtIndex:first]])
+            first = right;
+        if (first == position)
+            break;
+
+        [self swapPosition:position withPosition:first];
+        position = first;
+    }
+}
+
+- (void)insertEntry:(AWSTMDiskCacheIndexEntry *)entry
+{
+    [self setPosition:[_entries count] ofEntry:entry];
+    [_entries addObject:entry];
+    [self siftUp:[_entries count] - 1];
+}
+
+- (void)updateEntry:(AWSTMDiskCacheIndexEntry *)entry
+{
+    NSUInteger position = [self positionOfEntry:entry];
+    if ([self siftUp:position] == position)
+        [self siftDown:position];
+}
+
+- (void)removeEntry:(AWSTMDiskCacheIndexEntry *)entry
+{
+    NSUInteger position = [self positionOfEntry:entry];
+    NSUInteger last = [_entries count] - 1;
+
+    if (position != last)
+        [self swapPosition:position withPosition:last];
+
+    [_entries removeLastObject];
+
+    if (position < last)
+        [self updateEntry:[_entries objectAtIndex:position]];
+}
+
+- (void)removeAllEntries
+{
+    [_entries removeAllObjects];
+}
+
+@end
+
+// The metadata of every object in one cache directory: its size and when it was last accessed. Instances are
+// shared by all caches with the same directory and must only be used on the disk cache queue. Writers run as
+// barriers there, but readers run concurrently and still update access times or drop stale entries, so the
+// methods readers use, and the journal writes they can trigger, are guarded by a lock.
+//
+// The index is persisted as an append-only journal that is read back in one pass when the cache starts, so
+// neither the directory nor the files in it need to be examined. Sets and removals are written through right
+// away; access-time updates are buffered and written in batches, because losing a few of them to a crash only
+// affects eviction order. The journal is rewritten as a snapshot once it holds mostly superseded records.
+@class AWSTMDiskCacheSegmentStore;
+
+@interface AWSTMDiskCacheIndex : NSObject
+@property (strong, nonatomic, readonly) NSURL *journalURL;
+@property (assign, nonatomic, readonly) NSUInteger byteCount;
+@property (assign, nonatomic, getter=isLoaded) BOOL loaded;
+@property (strong, nonatomic) AWSTMDiskCacheSegmentStore *segmentStore; // segment storage only
++ (instancetype)indexForCacheURL:(NSURL *)cacheURL queue:(dispatch_queue_t)queue;
+- (BOOL)load;
+- (void)loadEntryForKey:(NSString *)key byteCount:(NSUInteger)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessTime:(NSTimeInterval)accessTime;
+- (void)compact;
+- (void)flush;
+- (NSUInteger)count;
+- (BOOL)containsKey:(NSString *)key;
+- (AWSTMDiskCacheIndexEntry *)entryForKey:(NSString *)key;
+- (NSArray *)allEntries;
+- (NSString *)oldestKey;
+- (NSDate *)oldestAccessDate;
+- (NSString *)largestKey;
+- (NSArray *)keysSortedByAccessDate;
+- (void)setByteCount:(NSUInteger)byteCount accessDate:(NSDate *)date forKey:(NSString *)key;
+- (void)setByteCount:(NSUInteger)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessDate:(NSDate *)date forKey:(NSString *)key;
+- (void)touchKey:(NSString *)key accessDate:(NSDate *)date;
+- (NSUInteger)removeKey:(NSString *)key;
+- (void)removeAllKeys;
+@end
+
+@implementation AWSTMDiskCacheIndex {
+    dispatch_queue_t _queue;
+    NSMutableDictionary *_entries;
+    AWSTMDiskCacheHeap *_dateHeap;
+    AWSTMDiskCacheHeap *_sizeHeap;
+    NSMutableData *_pendingJournal;
+    NSUInteger _journalRecordCount;
+    int _journalDescriptor;
+    BOOL _flushScheduled;
+    pthread_mutex_t _lock;
+}
+
++ (instancetype)indexForCacheURL:(NSURL *)cacheURL queue:(dispatch_queue_t)queue
+{
+    static NSMapTable *indexes;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        indexes = [NSMapTable strongToWeakObjectsMapTable];
+    });
+
+    NSString *path = [cacheURL path];
+    AWSTMDiskCacheIndex *index = [indexes objectForKey:path];
+    if (!index) {
+        index = [[self alloc] initWithCacheURL:cacheURL queue:queue];
+        [indexes setObject:index forKey:path];
+    }
+    return index;
+}
+
+- (instancetype)initWithCacheURL:(NSURL *)cacheURL queue:(dispatch_queue_t)queue
+{
+    if (self = [super init]) {
+        _queue = queue;
+        _journalURL = [cacheURL URLByAppendingPathComponent:AWSTMDiskCacheJournalFileName];
+        _entries = [[NSMutableDictionary alloc] init];
+        _dateHeap = [[AWSTMDiskCacheHeap alloc] initWithOrder:AWSTMDiskCacheHeapOrderOldestFirst];
+        _sizeHeap = [[AWSTMDiskCacheHeap alloc] initWithOrder:AWSTMDiskCacheHeapOrderLargestFirst];
+        _pendingJournal = [[NSMutableData alloc] init];
+        _journalDescriptor = -1;
+
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE); // removeKey: -> flush -> compact
+        pthread_mutex_init(&_lock, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self flush];
+
+    if (_journalDescriptor >= 0)
+        close(_journalDescriptor);
+
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark Loading
+
+- (BOOL)load
+{
+    NSError *error = nil;
+    NSData *journal = [NSData dataWithContentsOfURL:_journalURL options:NSDataReadingMappedIfSafe error:&error];
+    if (!journal)
+        return NO;
+
+    const uint8_t *bytes = [journal bytes];
+    size_t length = [journal length];
+    uint32_t magic = 0;
+    uint32_t version = 0;
+
+    if (length < AWSTMDiskCacheJournalHeaderLength)
+        return NO;
+
+    memcpy(&magic, bytes, sizeof(magic));
+    memcpy(&version, bytes + sizeof(magic), sizeof(version));
+    if (magic != AWSTMDiskCacheJournalMagic || version != AWSTMDiskCacheJournalVersion)
+        return NO;
+
+    size_t offset = AWSTMDiskCacheJournalHeaderLength;
+    BOOL truncated = NO;
+
+    while (offset < length) {
+        if (length - offset < AWSTMDiskCacheJournalRecordLength) {
+            truncated = YES;
+            break;
+        }
+
+        uint8_t operation = bytes[offset];
+        uint32_t keyLength = 0;
+        uint64_t byteCount = 0;
+        NSTimeInterval accessTime = 0.0;
+        uint32_t segment = 0;
+        uint64_t segmentOffset = 0;
+        memcpy(&keyLength, bytes + offset + 1, sizeof(keyLength));
+        memcpy(&byteCount, bytes + offset + 5, sizeof(byteCount));
+        memcpy(&accessTime, bytes + offset + 13, sizeof(accessTime));
+        memcpy(&segment, bytes + offset + 21, sizeof(segment));
+        memcpy(&segmentOffset, bytes + offset + 25, sizeof(segmentOffset));
+        offset += AWSTMDiskCacheJournalRecordLength;
+
+        if (length - offset < keyLength) {
+            truncated = YES;
+            break;
+        }
+
+        NSString *key = [[NSString alloc] initWithBytes:bytes + offset length:keyLength encoding:NSUTF8StringEncoding];
+        offset += keyLength;
+        _journalRecordCount++;
+
+        if (!key)
+            continue;
+
+        switch (operation) {
+            case AWSTMDiskCacheJournalOperationSet:
+                [self loadEntryForKey:key byteCount:(NSUInteger)byteCount segment:segment offset:segmentOffset accessTime:accessTime];
+                break;
+            case AWSTMDiskCacheJournalOperationTouch: {
+                AWSTMDiskCacheIndexEntry *entry = [_entries objectForKey:key];
+                if (entry) {
+                    entry.accessTime = accessTime;
+                    [_dateHeap updateEntry:entry];
+                }
+                break;
+            }
+            case AWSTMDiskCacheJournalOperationRemove:
+                [self removeEntryForKey:key];
+                break;
+            default:
+                break;
+        }
+    }
+
+    self.loaded = YES;
+
+    // A torn record is the tail of a write that was interrupted; the snapshot drops it.
+    if (truncated || [self journalNeedsCompaction])
+        [self compact];
+
+    return YES;
+}
+
+- (void)loadEntryForKey:(NSString *)key byteCount:(NSUInteger)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessTime:(NSTimeInterval)accessTime
+{
+    AWSTMDiskCacheIndexEntry *entry = [_entries objectForKey:key];
+
+    if (entry) {
+        _byteCount -= entry.byteCount;
+        entry.byteCount = byteCount;
+        entry.segment = segment;
+        entry.offset = offset;
+        entry.accessTime = accessTime;
+        [_dateHeap updateEntry:entry];
+        [_sizeHeap updateEntry:entry];
+    } else {
+        entry = [[AWSTMDiskCacheIndexEntry alloc] init];
+        entry.key = key;
+        entry.byteCount = byteCount;
+        entry.segment = segment;
+        entry.offset = offset;
+        entry.accessTime = accessTime;
+        [_entries setObject:entry forKey:key];
+        [_dateHeap insertEntry:entry];
+        [_sizeHeap insertEntry:entry];
+    }
+
+    _byteCount += byteCount;
+}
+
+- (BOOL)removeEntryForKey:(NSString *)key
+{
+    AWSTMDiskCacheIndexEntry *entry = [_entries objectForKey:key];
+    if (!entry)
+        return NO;
+
+    [_dateHeap removeEntry:entry];
+    [_sizeHeap removeEntry:entry];
+    [_entries removeObjectForKey:key];
+    _byteCount -= entry.byteCount;
+
+    return YES;
+}
+
+#pragma mark Queries
+
+- (NSUInteger)count
+{
+    return [_entries count];
+}
+
+- (BOOL)containsKey:(NSString *)key
+{
+    return [self entryForKey:key] != nil;
+}
+
+- (AWSTMDiskCacheIndexEntry *)entryForKey:(NSString *)key
+{
+    pthread_mutex_lock(&_lock);
+    AWSTMDiskCacheIndexEntry *entry = [_entries objectForKey:key];
+    pthread_mutex_unlock(&_lock);
+
+    return entry;
+}
+
+- (NSArray *)allEntries
+{
+    return [_entries allValues];
+}
+
+- (NSString *)oldestKey
+{
+    return [_dateHeap top].key;
+}
+
+- (NSDate *)oldestAccessDate
+{
+    AWSTMDiskCacheIndexEntry *entry = [_dateHeap top];
+    return entry ? [NSDate dateWithTimeIntervalSinceReferenceDate:entry.accessTime] : nil;
+}
+
+- (NSString *)largestKey
+{
+    return [_sizeHeap top].key;
+}
+
+- (NSArray *)keysSortedByAccessDate
+{
+    NSArray *entries = [_dateHeap.entries sortedArrayUsingComparator:^NSComparisonResult(AWSTMDiskCacheIndexEntry *entry, AWSTMDiskCacheIndexEntry *other) {
+        if (entry.accessTime < other.accessTime)
+            return NSOrderedAscending;
+        if (entry.accessTime > other.accessTime)
+            return NSOrderedDescending;
+        return NSOrderedSame;
+    }];
+
+    return [entries valueForKey:@"key"];
+}
+
+#pragma mark Mutations
+
+- (void)setByteCount:(NSUInteger)byteCount accessDate:(NSDate *)date forKey:(NSString *)key
+{
+    [self setByteCount:byteCount segment:0 offset:0 accessDate:date forKey:key];
+}
+
+- (void)setByteCount:(NSUInteger)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessDate:(NSDate *)date forKey:(NSString *)key
+{
+    NSTimeInterval accessTime = [date timeIntervalSinceReferenceDate];
+    [self loadEntryForKey:key byteCount:byteCount segment:segment offset:offset accessTime:accessTime];
+    [self appendOperation:AWSTMDiskCacheJournalOperationSet key:key byteCount:byteCount segment:segment offset:offset accessTime:accessTime];
+    [self flush];
+}
+
+- (void)touchKey:(NSString *)key accessDate:(NSDate *)date
+{
+    pthread_mutex_lock(&_lock);
+
+    AWSTMDiskCacheIndexEntry *entry = [_entries objectForKey:key];
+    if (entry) {
+        entry.accessTime = [date timeIntervalSinceReferenceDate];
+        [_dateHeap updateEntry:entry];
+        [self appendOperation:AWSTMDiskCacheJournalOperationTouch key:key byteCount:0 segment:0 offset:0 accessTime:entry.accessTime];
+
+        if ([_pendingJournal length] >= AWSTMDiskCacheJournalFlushThreshold)
+            [self flush];
+        else
+            [self scheduleFlush];
+    }
+
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)removeKey:(NSString *)key
+{
+    pthread_mutex_lock(&_lock);
+
+    NSUInteger byteCount = ((AWSTMDiskCacheIndexEntry *)[_entries objectForKey:key]).byteCount;
+    if ([self removeEntryForKey:key]) {
+        [self appendOperation:AWSTMDiskCacheJournalOperationRemove key:key byteCount:0 segment:0 offset:0 accessTime:0.0];
+        [self flush];
+    } else {
+        byteCount = 0;
+    }
+
+    pthread_mutex_unlock(&_lock);
+
+    return byteCount;
+}
+
+- (void)removeAllKeys
+{
+    [_entries removeAllObjects];
+    [_dateHeap removeAllEntries];
+    [_sizeHeap removeAllEntries];
+    _byteCount = 0;
+
+    [self compact];
+}
+
+#pragma mark Journal
+
+- (void)appendOperation:(AWSTMDiskCacheJournalOperation)operation key:(NSString *)key byteCount:(uint64_t)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessTime:(NSTimeInterval)accessTime
+{
+    [[self class] appendOperation:operation key:key byteCount:byteCount segment:segment offset:offset accessTime:accessTime toData:_pendingJournal];
+    _journalRecordCount++;
+}
+
++ (void)appendOperation:(AWSTMDiskCacheJournalOperation)operation key:(NSString *)key byteCount:(uint64_t)byteCount segment:(uint32_t)segment offset:(uint64_t)offset accessTime:(NSTimeInterval)accessTime toData:(NSMutableData *)data
+{
+    NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t keyLength = (uint32_t)[keyData length];
+    uint8_t record[AWSTMDiskCacheJournalRecordLength];
+
+    record[0] = operation;
+    memcpy(record + 1, &keyLength, sizeof(keyLength));
+    memcpy(record + 5, &byteCount, sizeof(byteCount));
+    memcpy(record + 13, &accessTime, sizeof(accessTime));
+    memcpy(record + 21, &segment, sizeof(segment));
+    memcpy(record + 25, &offset, sizeof(offset));
+
+    [data appendBytes:record length:sizeof(record)];
+    [data appendData:keyData];
+}
+
+- (BOOL)journalNeedsCompaction
+{
+    return _journalRecordCount > MAX(AWSTMDiskCacheJournalMinimumCompactionCount, 2 * [_entries count]);
+}
+
+- (void)scheduleFlush
+{
+    if (_flushScheduled || !_queue)
+        return;
+
+    _flushScheduled = YES;
+
+    __weak AWSTMDiskCacheIndex *weakSelf = self;
+    dispatch_queue_t queue = _queue;
+    dispatch_time_t time = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(AWSTMDiskCacheJournalFlushDelay * NSEC_PER_SEC));
+    dispatch_after(time, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+        dispatch_barrier_async(queue, ^{
+            AWSTMDiskCacheIndex *strongSelf = weakSelf;
+            [strongSelf flush];
+        });
+    });
+}
+
+- (void)flush
+{
+    pthread_mutex_lock(&_lock);
+
+    _flushScheduled = NO;
+
+    if ([_pendingJournal length] && [self journalNeedsCompaction])
+        [self compact];
+    else if ([_pendingJournal length])
+        [self writePendingJournal];
+
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void)writePendingJournal
+{
+    if (_journalDescriptor < 0)
+        _journalDescriptor = open([[_journalURL path] fileSystemRepresentation], O_WRONLY | O_APPEND | O_CREAT, 0644);
+
+    if (_journalDescriptor >= 0) {
+        const uint8_t *bytes = [_pendingJournal bytes];
+        size_t remaining = [_pendingJournal length];
+
+        while (remaining > 0) {
+            ssize_t written = write(_journalDescriptor, bytes, remaining);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                NSLog(@"%@ ERROR: could not write the cache index (%d)", [self class], errno);
+                break;
+            }
+            bytes += written;
+            remaining -= (size_t)written;
+        }
+    }
+
+    [_pendingJournal setLength:0];
+}
+
+// Replaces the journal with a snapshot holding one record per live entry.
+- (void)compact
+{
+    pthread_mutex_lock(&_lock);
+
+    NSMutableData *snapshot = [[NSMutableData alloc] initWithCapacity:AWSTMDiskCacheJournalHeaderLength + [_entries count] * (AWSTMDiskCacheJournalRecordLength + 32)];
+    uint32_t header[2] = { AWSTMDiskCacheJournalMagic, AWSTMDiskCacheJournalVersion };
+    [snapshot appendBytes:header length:sizeof(header)];
+
+    for (AWSTMDiskCacheIndexEntry *entry in _dateHeap.entries) {
+        [[self class] appendOperation:AWSTMDiskCacheJournalOperationSet
+                                  key:entry.key
+                            byteCount:entry.byteCount
+                              segment:entry.segment
+                               offset:entry.offset
+                           accessTime:entry.accessTime
+                               toData:snapshot];
+    }
+
+    if (_journalDescriptor >= 0) {
+        close(_journalDescriptor);
+        _journalDescriptor = -1;
+    }
+
+    NSError *error = nil;
+    [snapshot writeToURL:_journalURL options:NSDataWritingAtomic error:&error];
+    TMDiskCacheError(error);
+
+    [_pendingJournal setLength:0];
+    _journalRecordCount = [_entries count];
+    self.loaded = YES;
+
+    pthread_mutex_unlock(&_lock);
+}
+
+@end
+
+// Packs archived values back to back into append-only segment files, leaving their locations to the index.
+// Segments are read through memory maps, so a lookup costs no system call once its segment is mapped. Values
+// that are overwritten or removed leave dead bytes behind; once they make up most of the segments, the live
+// values are copied into fresh segments and the old ones are deleted. Must only be used on the disk cache queue;
+// reading and releasing bytes may happen concurrently, everything else only from barrier blocks.
+@interface AWSTMDiskCacheSegmentStore : NSObject
+@property (strong, nonatomic, readonly) NSURL *directoryURL;
+@property (weak, nonatomic, readonly) AWSTMDiskCacheIndex *index;
+@end
+
+@implementation AWSTMDiskCacheSegmentStore {
+    NSMutableIndexSet *_segments;
+    NSMutableDictionary *_mappedSegments;
+    uint32_t _activeSegment;
+    uint64_t _activeSegmentLength;
+    uint64_t _segmentByteCount;
+    uint64_t _deadByteCount;
+    int _activeDescriptor;
+    OSSpinLock _lock; // guards _mappedSegments and _deadByteCount
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL index:(AWSTMDiskCacheIndex *)index
+{
+    if (self = [super init]) {
+        _directoryURL = directoryURL;
+        _index = index;
+        _segments = [[NSMutableIndexSet alloc] init];
+        _mappedSegments = [[NSMutableDictionary alloc] init];
+        _activeDescriptor = -1;
+        _lock = OS_SPINLOCK_INIT;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_activeDescriptor >= 0)
+        close(_activeDescriptor);
+}
+
+- (NSURL *)URLForSegment:(uint32_t)segment
+{
+    NSString *fileName = [[NSString alloc] initWithFormat:@"%@%u", AWSTMDiskCacheSegmentFilePrefix, segment];
+    return [_directoryURL URLByAppendingPathComponent:fileName];
+}
+
+- (void)open
+{
+    NSError *error = nil;
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:_directoryURL
+                                                   includingPropertiesForKeys:@[ NSURLFileSizeKey ]
+                                                                      options:0
+                                                                        error:&error];
+    TMDiskCacheError(error);
+
+    // Without index entries nothing in the segments is reachable, e.g. after the journal was lost.
+    BOOL discard = [_index count] == 0;
+
+    for (NSURL *fileURL in files) {
+        NSString *fileName = [fileURL lastPathComponent];
+        if (![fileName hasPrefix:AWSTMDiskCacheSegmentFilePrefix])
+            continue;
+
+        if (discard) {
+            [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+            continue;
+        }
+
+        uint32_t segment = (uint32_t)[[fileName substringFromIndex:[AWSTMDiskCacheSegmentFilePrefix length]] longLongValue];
+        NSNumber *fileSize = nil;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:NULL];
+
+        [_segments addIndex:segment];
+        _segmentByteCount += [fileSize unsignedLongLongValue];
+
+        if (segment >= _activeSegment) {
+            _activeSegment = segment;
+            _activeSegmentLength = [fileSize unsignedLongLongValue];
+        }
+    }
+
+    if (_activeSegment == 0)
+        _activeSegment = 1;
+
+    uint64_t liveByteCount = [_index byteCount];
+    _deadByteCount = _segmentByteCount > liveByteCount ? _segmentByteCount - liveByteCount : 0;
+}
+
+- (void)reset
+{
+    if (_activeDescriptor >= 0) {
+        close(_activeDescriptor);
+        _activeDescriptor = -1;
+    }
+
+    [_segments removeAllIndexes];
+    [_mappedSegments removeAllObjects];
+    _activeSegment = 1;
+    _activeSegmentLength = 0;
+    _segmentByteCount = 0;
+    _deadByteCount = 0;
+}
+
+#pragma mark Reading
+
+- (BOOL)readEntry:(AWSTMDiskCacheIndexEntry *)entry usingBlock:(void (^)(NSData *data))block
+{
+    NSNumber *segment = @(entry.segment);
+    uint64_t end = entry.offset + entry.byteCount;
+
+    OSSpinLockLock(&_lock);
+    NSData *segmentData = [_mappedSegments objectForKey:segment];
+    OSSpinLockUnlock(&_lock);
+
+    // A mapping made before the segment grew doesn't cover values appended since.
+    if ([segmentData length] < end) {
+        NSError *error = nil;
+        segmentData = [NSData dataWithContentsOfURL:[self URLForSegment:entry.segment]
+                                            options:NSDataReadingMappedAlways
+                                              error:&error];
+        TMDiskCacheError(error);
+
+        OSSpinLockLock(&_lock);
+        if (segmentData)
+            [_mappedSegments setObject:segmentData forKey:segment];
+        else
+            [_mappedSegments removeObjectForKey:segment];
+        OSSpinLockUnlock(&_lock);
+    }
+
+    if ([segmentData length] < end)
+        return NO;
+
+    // The slice borrows the mapped bytes and must not outlive this method, which holds the mapping.
+    NSData *value = [[NSData alloc] initWithBytesNoCopy:(uint8_t *)[segmentData bytes] + entry.offset
+                                                 length:entry.byteCount
+                                           freeWhenDone:NO];
+    block(value);
+
+    return YES;
+}
+
+#pragma mark Writing
+
+- (BOOL)appendData:(NSData *)data segment:(uint32_t *)segment offset:(uint64_t *)offset
+{
+    uint64_t length = [data length];
+
+    if (_activeSegmentLength > 0 && _activeSegmentLength + length > AWSTMDiskCacheSegmentMaximumLength) {
+        if (_activeDescriptor >= 0) {
+            close(_activeDescriptor);
+            _activeDescriptor = -1;
+        }
+        _activeSegment++;
+        _activeSegmentLength = 0;
+    }
+
+    if (_activeDescriptor < 0) {
+        _activeDescriptor = open([[[self URLForSegment:_activeSegment] path] fileSystemRepresentation], O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (_activeDescriptor < 0) {
+            NSLog(@"%@ ERROR: could not open cache segment %u (%d)", [self class], _activeSegment, errno);
+            return NO;
+        }
+        [_segments addIndex:_activeSegment];
+    }
+
+    const uint8_t *bytes = [data bytes];
+    size_t remaining = (size_t)length;
+
+    while (remaining > 0) {
+        ssize_t written = write(_activeDescriptor, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            NSLog(@"%@ ERROR: could not write cache segment %u (%d)", [self class], _activeSegment, errno);
+            ftruncate(_activeDescriptor, (off_t)_activeSegmentLength); // drop the partial value
+            return NO;
+        }
+        bytes += written;
+        remaining -= (size_t)written;
+    }
+
+    *segment = _activeSegment;
+    *offset = _activeSegmentLength;
+    _activeSegmentLength += length;
+    _segmentByteCount += length;
+
+    return YES;
+}
+
+- (void)releaseByteCount:(NSUInteger)byteCount
+{
+    OSSpinLockLock(&_lock);
+    _deadByteCount += byteCount;
+    OSSpinLockUnlock(&_lock);
+}
+
+#pragma mark Compaction
+
+- (void)compactIfNeeded
+{
+    if (_deadByteCount < AWSTMDiskCacheSegmentMinimumCompactionLength || _deadByteCount * 2 < _segmentByteCount)
+        return;
+
+    [self compact];
+}
 
-NSString * const AWSTMDiskCachePrefix = @"com.tumblr.TMDiskCache";
-NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
+- (void)compact
+{
+    NSIndexSet *oldSegments = [_segments copy];
+
+    // Start over in a segment that no live entry points into.
+    if (_activeDescriptor >= 0) {
+        close(_activeDescriptor);
+        _activeDescriptor = -1;
+    }
+    _activeSegment = (uint32_t)[oldSegments lastIndex] + 1;
+    _activeSegmentLength = 0;
+    _segmentByteCount = 0;
+    [_segments removeAllIndexes];
+
+    NSMutableArray *lostKeys = [[NSMutableArray alloc] init];
+
+    for (AWSTMDiskCacheIndexEntry *entry in [_index allEntries]) {
+        __block BOOL copied = NO;
+        __block uint32_t segment = 0;
+        __block uint64_t offset = 0;
+
+        [self readEntry:entry usingBlock:^(NSData *data) {
+            copied = [self appendData:data segment:&segment offset:&offset];
+        }];
+
+        if (copied) {
+            entry.segment = segment;
+            entry.offset = offset;
+        } else {
+            [lostKeys addObject:entry.key];
+        }
+    }
+
+    for (NSString *key in lostKeys)
+        [_index removeKey:key];
+
+    // The snapshot must point at the new segments before the old ones can go.
+    [_index compact];
+
+    [oldSegments enumerateIndexesUsingBlock:^(NSUInteger segment, BOOL *stop) {
+        [_mappedSegments removeObjectForKey:@(segment)];
+        [[NSFileManager defaultManager] removeItemAtURL:[self URLForSegment:(uint32_t)segment] error:NULL];
+    }];
+
+    _deadByteCount = 0;
+}
+
+@end
 
 @interface AWSTMDiskCache ()
 @property (assign) NSUInteger byteCount;
 @property (strong, nonatomic) NSURL *cacheURL;
 @property (assign, nonatomic) dispatch_queue_t queue;
-@property (strong, nonatomic) NSMutableDictionary *dates;
-@property (strong, nonatomic) NSMutableDictionary *sizes;
+@property (strong, nonatomic) AWSTMDiskCacheIndex *index;
 @end
 
 @implementation AWSTMDiskCache
@@ -48,12 +936,18 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 }
 
 - (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath
+{
+    return [self initWithName:name rootPath:rootPath storage:AWSTMDiskCacheStorageFilePerKey];
+}
+
+- (instancetype)initWithName:(NSString *)name rootPath:(NSString *)rootPath storage:(AWSTMDiskCacheStorage)storage
 {
     if (!name)
         return nil;
 
     if (self = [super init]) {
         _name = [name copy];
+        _storage = storage;
         _queue = [AWSTMDiskCache sharedQueue];
 
         _willAddObjectBlock = nil;
@@ -67,15 +961,12 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
         _byteLimit = 0;
         _ageLimit = 0.0;
 
-        _dates = [[NSMutableDictionary alloc] init];
-        _sizes = [[NSMutableDictionary alloc] init];
-
         NSString *pathComponent = [[NSString alloc] initWithFormat:@"%@.%@", AWSTMDiskCachePrefix, _name];
         _cacheURL = [NSURL fileURLWithPathComponents:@[ rootPath, pathComponent ]];
 
         __weak AWSTMDiskCache *weakSelf = self;
 
-        dispatch_async(_queue, ^{
+        dispatch_barrier_async(_queue, ^{
             AWSTMDiskCache *strongSelf = weakSelf;
             [strongSelf createCacheDirectory];
             [strongSelf initializeDiskProperties];
@@ -107,7 +998,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     static dispatch_once_t predicate;
 
     dispatch_once(&predicate, ^{
-        queue = dispatch_queue_create([AWSTMDiskCachePrefix UTF8String], DISPATCH_QUEUE_SERIAL);
+        queue = dispatch_queue_create([AWSTMDiskCachePrefix UTF8String], DISPATCH_QUEUE_CONCURRENT);
     });
 
     return queue;
@@ -117,7 +1008,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
 - (NSURL *)encodedFileURLForKey:(NSString *)key
 {
-    if (![key length])
+    if (![key length] || _storage == AWSTMDiskCacheStorageSegments)
         return nil;
 
     return [_cacheURL URLByAppendingPathComponent:[self encodedString:key]];
@@ -249,7 +1140,26 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
 - (void)initializeDiskProperties
 {
-    NSUInteger byteCount = 0;
+    _index = [AWSTMDiskCacheIndex indexForCacheURL:_cacheURL queue:_queue];
+
+    if (![_index isLoaded] && ![_index load]) {
+        if (_storage == AWSTMDiskCacheStorageSegments)
+            [_index compact];
+        else
+            [self rebuildIndexFromDirectory];
+    }
+
+    if (_storage == AWSTMDiskCacheStorageSegments && ![_index segmentStore]) {
+        _index.segmentStore = [[AWSTMDiskCacheSegmentStore alloc] initWithDirectoryURL:_cacheURL index:_index];
+        [_index.segmentStore open];
+    }
+
+    self.byteCount = [_index byteCount]; // atomic
+}
+
+// Used when there is no readable journal, e.g. the first launch after upgrading from a version without one.
+- (void)rebuildIndexFromDirectory
+{
     NSArray *keys = @[ NSURLContentModificationDateKey, NSURLTotalFileAllocatedSizeKey ];
 
     NSError *error = nil;
@@ -267,63 +1177,86 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
         TMDiskCacheError(error);
 
         NSDate *date = [dictionary objectForKey:NSURLContentModificationDateKey];
-        if (date && key)
-            [_dates setObject:date forKey:key];
-
         NSNumber *fileSize = [dictionary objectForKey:NSURLTotalFileAllocatedSizeKey];
-        if (fileSize) {
-            [_sizes setObject:fileSize forKey:key];
-            byteCount += [fileSize unsignedIntegerValue];
-        }
+        if (!key)
+            continue;
+
+        [_index loadEntryForKey:key
+                      byteCount:[fileSize unsignedIntegerValue]
+                        segment:0
+                         offset:0
+                     accessTime:[(date ?: [NSDate date]) timeIntervalSinceReferenceDate]];
     }
 
-    if (byteCount > 0)
-        self.byteCount = byteCount; // atomic
+    [_index compact];
 }
 
-- (BOOL)setFileModificationDate:(NSDate *)date forURL:(NSURL *)fileURL
+- (id <NSCoding>)unarchiveObjectForKey:(NSString *)key fileURL:(NSURL *)fileURL
 {
-    if (!date || !fileURL) {
-        return NO;
-    }
-    
-    NSError *error = nil;
-    BOOL success = [[NSFileManager defaultManager] setAttributes:@{ NSFileModificationDate: date }
-                                                    ofItemAtPath:[fileURL path]
-                                                           error:&error];
-    TMDiskCacheError(error);
+    if (_storage == AWSTMDiskCacheStorageFilePerKey)
+        return [NSKeyedUnarchiver unarchiveObjectWithFile:[fileURL path]];
 
-    if (success) {
-        NSString *key = [self keyForEncodedFileURL:fileURL];
-        if (key) {
-            [_dates setObject:date forKey:key];
-        }
+    AWSTMDiskCacheIndexEntry *entry = [_index entryForKey:key];
+    if (!entry)
+        return nil; // forgotten by a concurrent reader
+
+    __block id <NSCoding> object = nil;
+    [[_index segmentStore] readEntry:entry usingBlock:^(NSData *data) {
+        object = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+    }];
+    return object;
+}
+
+- (BOOL)archiveObject:(id <NSCoding>)object forKey:(NSString *)key fileURL:(NSURL *)fileURL date:(NSDate *)date
+{
+    if (_storage == AWSTMDiskCacheStorageFilePerKey) {
+        if (![NSKeyedArchiver archiveRootObject:object toFile:[fileURL path]])
+            return NO;
+
+        NSError *error = nil;
+        NSDictionary *values = [fileURL resourceValuesForKeys:@[ NSURLTotalFileAllocatedSizeKey ] error:&error];
+        TMDiskCacheError(error);
+
+        NSNumber *diskFileSize = [values objectForKey:NSURLTotalFileAllocatedSizeKey];
+        [_index setByteCount:[diskFileSize unsignedIntegerValue] accessDate:date forKey:key];
+    } else {
+        AWSTMDiskCacheSegmentStore *segmentStore = [_index segmentStore];
+        NSData *data = [NSKeyedArchiver archivedDataWithRootObject:object];
+        uint32_t segment = 0;
+        uint64_t offset = 0;
+
+        if (![segmentStore appendData:data segment:&segment offset:&offset])
+            return NO;
+
+        [segmentStore releaseByteCount:[_index entryForKey:key].byteCount]; // the value being replaced, if any
+        [_index setByteCount:[data length] segment:segment offset:offset accessDate:date forKey:key];
     }
 
-    return success;
+    self.byteCount = [_index byteCount]; // atomic
+    return YES;
+}
+
+- (void)forgetKey:(NSString *)key
+{
+    [[_index segmentStore] releaseByteCount:[_index removeKey:key]];
+    self.byteCount = [_index byteCount]; // atomic
 }
 
 - (BOOL)removeFileAndExecuteBlocksForKey:(NSString *)key
 {
-    NSURL *fileURL = [self encodedFileURLForKey:key];
-    if (!fileURL || ![[NSFileManager defaultManager] fileExistsAtPath:[fileURL path]])
+    if (![key length] || ![_index containsKey:key])
         return NO;
 
+    NSURL *fileURL = [self encodedFileURLForKey:key];
+
     if (_willRemoveObjectBlock)
         _willRemoveObjectBlock(self, key, nil, fileURL);
 
-    BOOL trashed = [AWSTMDiskCache moveItemAtURLToTrash:fileURL];
-    if (!trashed)
-        return NO;
-    
-    [AWSTMDiskCache emptyTrash];
-
-    NSNumber *byteSize = [_sizes objectForKey:key];
-    if (byteSize)
-        self.byteCount = _byteCount - [byteSize unsignedIntegerValue]; // atomic
+    if (fileURL && [AWSTMDiskCache moveItemAtURLToTrash:fileURL])
+        [AWSTMDiskCache emptyTrash];
 
-    [_sizes removeObjectForKey:key];
-    [_dates removeObjectForKey:key];
+    // A file that is already gone was deleted behind the cache's back; the index entry is stale either way.
+    [self forgetKey:key];
 
     if (_didRemoveObjectBlock)
         _didRemoveObjectBlock(self, key, nil, fileURL);
@@ -336,14 +1269,12 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     if (_byteCount <= trimByteCount)
         return;
 
-    NSArray *keysSortedBySize = [_sizes keysSortedByValueUsingSelector:@selector(compare:)];
+    NSString *key = nil;
 
-    for (NSString *key in [keysSortedBySize reverseObjectEnumerator]) { // largest objects first
+    while (_byteCount > trimByteCount && (key = [_index largestKey])) // largest objects first
         [self removeFileAndExecuteBlocksForKey:key];
 
-        if (_byteCount <= trimByteCount)
-            break;
-    }
+    [[_index segmentStore] compactIfNeeded];
 }
 
 - (void)trimDiskToSizeByDate:(NSUInteger)trimByteCount
@@ -351,31 +1282,22 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     if (_byteCount <= trimByteCount)
         return;
 
-    NSArray *keysSortedByDate = [_dates keysSortedByValueUsingSelector:@selector(compare:)];
+    NSString *key = nil;
 
-    for (NSString *key in keysSortedByDate) { // oldest objects first
+    while (_byteCount > trimByteCount && (key = [_index oldestKey])) // oldest objects first
         [self removeFileAndExecuteBlocksForKey:key];
 
-        if (_byteCount <= trimByteCount)
-            break;
-    }
+    [[_index segmentStore] compactIfNeeded];
 }
 
 - (void)trimDiskToDate:(NSDate *)trimDate
 {
-    NSArray *keysSortedByDate = [_dates keysSortedByValueUsingSelector:@selector(compare:)];
-    
-    for (NSString *key in keysSortedByDate) { // oldest files first
-        NSDate *accessDate = [_dates objectForKey:key];
-        if (!accessDate)
-            continue;
-        
-        if ([accessDate compare:trimDate] == NSOrderedAscending) { // older than trim date
-            [self removeFileAndExecuteBlocksForKey:key];
-        } else {
-            break;
-        }
-    }
+    NSDate *accessDate = nil;
+
+    while ((accessDate = [_index oldestAccessDate]) && [accessDate compare:trimDate] == NSOrderedAscending) // oldest files first
+        [self removeFileAndExecuteBlocksForKey:[_index oldestKey]];
+
+    [[_index segmentStore] compactIfNeeded];
 }
 
 - (void)trimToAgeLimitRecursively
@@ -387,14 +1309,124 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     [self trimDiskToDate:date];
     
     __weak AWSTMDiskCache *weakSelf = self;
+    dispatch_queue_t queue = _queue;
     
     dispatch_time_t time = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_ageLimit * NSEC_PER_SEC));
-    dispatch_after(time, _queue, ^(void) {
-        AWSTMDiskCache *strongSelf = weakSelf;
-        [strongSelf trimToAgeLimitRecursively];
+    dispatch_after(time, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^(void) {
+        dispatch_barrier_async(queue, ^{
+            AWSTMDiskCache *strongSelf = weakSelf;
+            [strongSelf trimToAgeLimitRecursively];
+        });
     });
 }
 
+#pragma mark - Private Reader Methods -
+
+// Readers run concurrently with each other on the <sharedQueue>, never with a writer.
+
+- (id <NSCoding>)readObjectForKey:(NSString *)key date:(NSDate *)date fileURL:(NSURL **)outFileURL
+{
+    NSURL *fileURL = [self encodedFileURLForKey:key];
+    id <NSCoding> object = nil;
+
+    if ([_index containsKey:key]) {
+        @try {
+            object = [self unarchiveObjectForKey:key fileURL:fileURL];
+        }
+        @catch (NSException *exception) {
+            if (fileURL) {
+                NSError *error = nil;
+                [[NSFileManager defaultManager] removeItemAtPath:[fileURL path] error:&error];
+                TMDiskCacheError(error);
+            }
+        }
+
+        if (object)
+            [_index touchKey:key accessDate:date];
+        else
+            [self forgetKey:key];
+    }
+
+    if (outFileURL)
+        *outFileURL = fileURL;
+
+    return object;
+}
+
+- (NSURL *)readFileURLForKey:(NSString *)key date:(NSDate *)date
+{
+    if (![_index containsKey:key])
+        return nil;
+
+    [_index touchKey:key accessDate:date];
+    return [self encodedFileURLForKey:key];
+}
+
+#pragma mark - Private Writer Methods -
+
+// Writers run as barrier blocks on the <sharedQueue>.
+
+- (NSURL *)writeObject:(id <NSCoding>)object forKey:(NSString *)key date:(NSDate *)date
+{
+    NSURL *fileURL = [self encodedFileURLForKey:key];
+
+    if (_willAddObjectBlock)
+        _willAddObjectBlock(self, key, object, fileURL);
+
+    BOOL written = [self archiveObject:object forKey:key fileURL:fileURL date:date];
+
+    if (written) {
+        if (_byteLimit > 0 && _byteCount > _byteLimit)
+            [self trimDiskToSizeByDate:_byteLimit];
+        else
+            [[_index segmentStore] compactIfNeeded];
+    } else {
+        fileURL = nil;
+    }
+
+    if (_didAddObjectBlock)
+        _didAddObjectBlock(self, key, object, fileURL);
+
+    return fileURL;
+}
+
+- (NSURL *)removeObjectAndCompactForKey:(NSString *)key
+{
+    NSURL *fileURL = [self encodedFileURLForKey:key];
+    [self removeFileAndExecuteBlocksForKey:key];
+    [[_index segmentStore] compactIfNeeded];
+
+    return fileURL;
+}
+
+- (void)removeAllFilesAndExecuteBlocks
+{
+    if (_willRemoveAllObjectsBlock)
+        _willRemoveAllObjectsBlock(self);
+    
+    [AWSTMDiskCache moveItemAtURLToTrash:_cacheURL];
+    [AWSTMDiskCache emptyTrash];
+
+    [self createCacheDirectory];
+
+    [_index removeAllKeys];
+    [[_index segmentStore] reset];
+    self.byteCount = 0; // atomic
+
+    if (_didRemoveAllObjectsBlock)
+        _didRemoveAllObjectsBlock(self);
+}
+
+- (void)enumerateKeysWithBlock:(AWSTMDiskCacheObjectBlock)block
+{
+    NSArray *keysSortedByDate = [_index keysSortedByAccessDate];
+
+    for (NSString *key in keysSortedByDate) {
+        NSURL *fileURL = [self encodedFileURLForKey:key];
+        block(self, key, nil, fileURL);
+    }
+}
+
 #pragma mark - Public Asynchronous Methods -
 
 - (void)objectForKey:(NSString *)key block:(AWSTMDiskCacheObjectBlock)block
@@ -411,21 +1443,8 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
         if (!strongSelf)
             return;
 
-        NSURL *fileURL = [strongSelf encodedFileURLForKey:key];
-        id <NSCoding> object = nil;
-
-        if ([[NSFileManager defaultManager] fileExistsAtPath:[fileURL path]]) {
-            @try {
-                object = [NSKeyedUnarchiver unarchiveObjectWithFile:[fileURL path]];
-            }
-            @catch (NSException *exception) {
-                NSError *error = nil;
-                [[NSFileManager defaultManager] removeItemAtPath:[fileURL path] error:&error];
-                TMDiskCacheError(error);
-            }
-
-            [strongSelf setFileModificationDate:now forURL:fileURL];
-        }
+        NSURL *fileURL = nil;
+        id <NSCoding> object = [strongSelf readObjectForKey:key date:now fileURL:&fileURL];
 
         block(strongSelf, key, object, fileURL);
     });
@@ -445,13 +1464,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
         if (!strongSelf)
             return;
 
-        NSURL *fileURL = [strongSelf encodedFileURLForKey:key];
-
-        if ([[NSFileManager defaultManager] fileExistsAtPath:[fileURL path]]) {
-            [strongSelf setFileModificationDate:now forURL:fileURL];
-        } else {
-            fileURL = nil;
-        }
+        NSURL *fileURL = [strongSelf readFileURLForKey:key date:now];
 
         block(strongSelf, key, nil, fileURL);
     });
@@ -468,47 +1481,14 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
             return;
         }
 
-        NSURL *fileURL = [strongSelf encodedFileURLForKey:key];
-
-        if (strongSelf->_willAddObjectBlock)
-            strongSelf->_willAddObjectBlock(strongSelf, key, object, fileURL);
-
-        BOOL written = [NSKeyedArchiver archiveRootObject:object toFile:[fileURL path]];
-
-        if (written) {
-            [strongSelf setFileModificationDate:now forURL:fileURL];
-
-            NSError *error = nil;
-            NSDictionary *values = [fileURL resourceValuesForKeys:@[ NSURLTotalFileAllocatedSizeKey ] error:&error];
-            TMDiskCacheError(error);
-
-            NSNumber *diskFileSize = [values objectForKey:NSURLTotalFileAllocatedSizeKey];
-            if (diskFileSize) {
-                NSNumber *oldEntry = [strongSelf->_sizes objectForKey:key];
-                
-                if ([oldEntry isKindOfClass:[NSNumber class]]){
-                    strongSelf.byteCount = strongSelf->_byteCount - [oldEntry unsignedIntegerValue];
-                }
-                
-                [strongSelf->_sizes setObject:diskFileSize forKey:key];
-                strongSelf.byteCount = strongSelf->_byteCount + [diskFileSize unsignedIntegerValue]; // atomic
-            }
-            
-            if (strongSelf->_byteLimit > 0 && strongSelf->_byteCount > strongSelf->_byteLimit)
-                [strongSelf trimToSizeByDate:strongSelf->_byteLimit block:nil];
-        } else {
-            fileURL = nil;
-        }
-
-        if (strongSelf->_didAddObjectBlock)
-            strongSelf->_didAddObjectBlock(strongSelf, key, object, written ? fileURL : nil);
+        NSURL *fileURL = [strongSelf writeObject:object forKey:key date:now];
 
         if (block)
             block(strongSelf, key, object, fileURL);
@@ -526,15 +1506,14 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
             return;
         }
 
-        NSURL *fileURL = [strongSelf encodedFileURLForKey:key];
-        [strongSelf removeFileAndExecuteBlocksForKey:key];
+        NSURL *fileURL = [strongSelf removeObjectAndCompactForKey:key];
 
         if (block)
             block(strongSelf, key, nil, fileURL);
@@ -554,7 +1533,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     
     __weak AWSTMDiskCache *weakSelf = self;
     
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
@@ -584,7 +1563,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
@@ -611,7 +1590,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
@@ -633,27 +1612,14 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
             return;
         }
 
-        if (strongSelf->_willRemoveAllObjectsBlock)
-            strongSelf->_willRemoveAllObjectsBlock(strongSelf);
-        
-        [AWSTMDiskCache moveItemAtURLToTrash:strongSelf->_cacheURL];
-        [AWSTMDiskCache emptyTrash];
-
-        [strongSelf createCacheDirectory];
-
-        [strongSelf->_dates removeAllObjects];
-        [strongSelf->_sizes removeAllObjects];
-        strongSelf.byteCount = 0; // atomic
-
-        if (strongSelf->_didRemoveAllObjectsBlock)
-            strongSelf->_didRemoveAllObjectsBlock(strongSelf);
+        [strongSelf removeAllFilesAndExecuteBlocks];
 
         if (block)
             block(strongSelf);
@@ -671,19 +1637,14 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf) {
             TMCacheEndBackgroundTask();
             return;
         }
 
-        NSArray *keysSortedByDate = [strongSelf->_dates keysSortedByValueUsingSelector:@selector(compare:)];
-
-        for (NSString *key in keysSortedByDate) {
-            NSURL *fileURL = [strongSelf encodedFileURLForKey:key];
-            block(strongSelf, key, nil, fileURL);
-        }
+        [strongSelf enumerateKeysWithBlock:block];
 
         if (completionBlock)
             completionBlock(strongSelf);
@@ -694,101 +1655,85 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 
 #pragma mark - Public Synchronous Methods -
 
+// The synchronous methods run their work directly on the calling thread through dispatch_sync, which still
+// honors the reader/writer ordering of the <sharedQueue> but needs no thread hop or semaphore.
+
 - (id <NSCoding>)objectForKey:(NSString *)key
 {
+    NSDate *now = [[NSDate alloc] init];
+
     if (!key)
         return nil;
 
     __block id <NSCoding> objectForKey = nil;
 
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self objectForKey:key block:^(AWSTMDiskCache *cache, NSString *key, id <NSCoding> object, NSURL *fileURL) {
-        objectForKey = object;
-        dispatch_semaphore_signal(semaphore);
-    }];
-    
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
-
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    dispatch_sync(_queue, ^{
+        objectForKey = [self readObjectForKey:key date:now fileURL:NULL];
+    });
 
     return objectForKey;
 }
 
 - (NSURL *)fileURLForKey:(NSString *)key
 {
+    NSDate *now = [[NSDate alloc] init];
+
     if (!key)
         return nil;
 
     __block NSURL *fileURLForKey = nil;
 
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self fileURLForKey:key block:^(AWSTMDiskCache *cache, NSString *key, id <NSCoding> object, NSURL *fileURL) {
-        fileURLForKey = fileURL;
-        dispatch_semaphore_signal(semaphore);
-    }];
-
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
-
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    dispatch_sync(_queue, ^{
+        fileURLForKey = [self readFileURLForKey:key date:now];
+    });
 
     return fileURLForKey;
 }
 
 - (void)setObject:(id <NSCoding>)object forKey:(NSString *)key
 {
+    NSDate *now = [[NSDate alloc] init];
+
     if (!object || !key)
         return;
-    
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
 
-    [self setObject:object forKey:key block:^(AWSTMDiskCache *cache, NSString *key, id <NSCoding> object, NSURL *fileURL) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self writeObject:object forKey:key date:now];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)removeObjectForKey:(NSString *)key
 {
     if (!key)
         return;
-    
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
 
-    [self removeObjectForKey:key block:^(AWSTMDiskCache *cache, NSString *key, id <NSCoding> object, NSURL *fileURL) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self removeObjectAndCompactForKey:key];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)trimToSize:(NSUInteger)byteCount
 {
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    if (byteCount == 0) {
+        [self removeAllObjects];
+        return;
+    }
 
-    [self trimToSize:byteCount block:^(AWSTMDiskCache *cache) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self trimDiskToSize:byteCount];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)trimToDate:(NSDate *)date
@@ -801,47 +1746,40 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
         return;
     }
 
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self trimToDate:date block:^(AWSTMDiskCache *cache) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self trimDiskToDate:date];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)trimToSizeByDate:(NSUInteger)byteCount
 {
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    if (byteCount == 0) {
+        [self removeAllObjects];
+        return;
+    }
 
-    [self trimToSizeByDate:byteCount block:^(AWSTMDiskCache *cache) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self trimDiskToSizeByDate:byteCount];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)removeAllObjects
 {
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self removeAllObjects:^(AWSTMDiskCache *cache) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self removeAllFilesAndExecuteBlocks];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 - (void)enumerateObjectsWithBlock:(AWSTMDiskCacheObjectBlock)block
@@ -849,17 +1787,13 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
     if (!block)
         return;
 
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self enumerateObjectsWithBlock:block completionBlock:^(AWSTMDiskCache *cache) {
-        dispatch_semaphore_signal(semaphore);
-    }];
+    TMCacheStartBackgroundTask();
 
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_barrier_sync(_queue, ^{
+        [self enumerateKeysWithBlock:block];
+    });
 
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    TMCacheEndBackgroundTask();
 }
 
 #pragma mark - Public Thread Safe Accessors -
@@ -879,7 +1813,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -903,7 +1837,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -927,7 +1861,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -951,7 +1885,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -975,7 +1909,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -999,7 +1933,7 @@ NSString * const AWSTMDiskCacheSharedName = @"TMDiskCacheShared";
 {
     __weak AWSTMDiskCache *weakSelf = self;
 
-    dispatch_async(_queue, ^{
+    dispatch_barrier_async(_queue, ^{
         AWSTMDiskCache *strongSelf = weakSelf;
         if (!strongSelf)
             return;
@@ -4,7 +4,47 @@
 #import <UIKit/UIKit.h>
 #endif
 
+#import <libkern/OSAtomic.h>
+
 NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
+static const NSUInteger AWSTMMemoryCacheEvictionSampleCount = 8;
+
+static inline int64_t AWSTMMemoryCacheTimestamp(NSDate *date)
+{
+    return (int64_t)([date timeIntervalSinceReferenceDate] * USEC_PER_SEC);
+}
+
+// One cached object, linked into the cache's recency list. The list is only changed inside barriers. Readers
+// running concurrently just stamp the access time and bump the use count atomically; an entry read since it was
+// linked (accessTime > linkedTime) is moved to the head lazily, when eviction reaches it.
+@interface AWSTMMemoryCacheEntry : NSObject {
+@public
+    NSString *_key;
+    id _object;
+    NSUInteger _cost;
+    volatile int64_t _accessTime;
+    volatile int32_t _accessCount;
+    int64_t _linkedTime;
+    __unsafe_unretained AWSTMMemoryCacheEntry *_previous; // towards the head, more recent
+    __unsafe_unretained AWSTMMemoryCacheEntry *_next; // towards the tail, less recent
+}
+@end
+
+@implementation AWSTMMemoryCacheEntry
+@end
+
+static inline void AWSTMMemoryCacheEntryRecordAccess(AWSTMMemoryCacheEntry *entry, int64_t timestamp)
+{
+    int64_t accessTime;
+    do {
+        accessTime = entry->_accessTime;
+        if (accessTime >= timestamp)
+            break;
+    } while (!OSAtomicCompareAndSwap64Barrier(accessTime, timestamp, &entry->_accessTime));
+
+    OSAtomicIncrement32(&entry->_accessCount);
+}
+
 
 @interface AWSTMMemoryCache ()
 #if OS_OBJECT_USE_OBJC
@@ -12,9 +52,9 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
 #else
 @property (assign, nonatomic) dispatch_queue_t queue;
 #endif
-@property (strong, nonatomic) NSMutableDictionary *dictionary;
-@property (strong, nonatomic) NSMutableDictionary *dates;
-@property (strong, nonatomic) NSMutableDictionary *costs;
+@property (strong, nonatomic) NSMutableDictionary *entries;
+@property (unsafe_unretained, nonatomic) AWSTMMemoryCacheEntry *head;
+@property (unsafe_unretained, nonatomic) AWSTMMemoryCacheEntry *tail;
 @end
 
 @implementation AWSTMMemoryCache
@@ -22,6 +62,7 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
 @synthesize ageLimit = _ageLimit;
 @synthesize costLimit = _costLimit;
 @synthesize totalCost = _totalCost;
+@synthesize evictionPolicy = _evictionPolicy;
 @synthesize willAddObjectBlock = _willAddObjectBlock;
 @synthesize willRemoveObjectBlock = _willRemoveObjectBlock;
 @synthesize willRemoveAllObjectsBlock = _willRemoveAllObjectsBlock;
@@ -49,9 +90,9 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         NSString *queueName = [[NSString alloc] initWithFormat:@"%@.%p", AWSTMMemoryCachePrefix, self];
         _queue = dispatch_queue_create([queueName UTF8String], DISPATCH_QUEUE_CONCURRENT);
 
-        _dictionary = [[NSMutableDictionary alloc] init];
-        _dates = [[NSMutableDictionary alloc] init];
-        _costs = [[NSMutableDictionary alloc] init];
+        _entries = [[NSMutableDictionary alloc] init];
+        _head = nil;
+        _tail = nil;
 
         _willAddObjectBlock = nil;
         _willRemoveObjectBlock = nil;
@@ -67,6 +108,7 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         _ageLimit = 0.0;
         _costLimit = 0;
         _totalCost = 0;
+        _evictionPolicy = AWSTMMemoryCacheEvictionPolicyLRU;
 
         _removeAllObjectsOnMemoryWarning = YES;
         _removeAllObjectsOnEnteringBackground = YES;
@@ -134,20 +176,126 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
     #endif
 }
 
+#pragma mark - Private Recency List Methods -
+
+// These run inside barriers only.
+
+- (void)linkEntryAtHead:(AWSTMMemoryCacheEntry *)entry
+{
+    entry->_linkedTime = entry->_accessTime;
+    entry->_previous = nil;
+    entry->_next = _head;
+
+    if (_head)
+        _head->_previous = entry;
+    _head = entry;
+
+    if (!_tail)
+        _tail = entry;
+}
+
+- (void)unlinkEntry:(AWSTMMemoryCacheEntry *)entry
+{
+    if (entry->_previous)
+        entry->_previous->_next = entry->_next;
+    else
+        _head = entry->_next;
+
+    if (entry->_next)
+        entry->_next->_previous = entry->_previous;
+    else
+        _tail = entry->_previous;
+
+    entry->_previous = nil;
+    entry->_next = nil;
+}
+
+- (void)promoteEntry:(AWSTMMemoryCacheEntry *)entry
+{
+    [self unlinkEntry:entry];
+    [self linkEntryAtHead:entry];
+}
+
+// The least recently used entry. Entries read since they were linked get a second chance at the head instead,
+// which is how reads that happened outside barriers are applied to the list.
+- (AWSTMMemoryCacheEntry *)leastRecentlyUsedEntry
+{
+    AWSTMMemoryCacheEntry *entry = _tail;
+
+    while (entry && entry->_accessTime > entry->_linkedTime) {
+        [self promoteEntry:entry];
+        entry = _tail;
+    }
+
+    return entry;
+}
+
+// Picks the entry to evict among a sample of the least recently used ones. The survivors are aged and moved to
+// the head, so consecutive evictions sample different entries.
+- (AWSTMMemoryCacheEntry *)sampledEntryToEvict
+{
+    __unsafe_unretained AWSTMMemoryCacheEntry *candidates[AWSTMMemoryCacheEvictionSampleCount];
+    NSUInteger count = 0;
+
+    for (AWSTMMemoryCacheEntry *entry = _tail; entry && count < AWSTMMemoryCacheEvictionSampleCount; entry = entry->_previous)
+        candidates[count++] = entry;
+
+    if (count == 0)
+        return nil;
+
+    AWSTMMemoryCacheEntry *victim = candidates[0];
+    double victimScore = -1.0;
+
+    for (NSUInteger i = 0; i < count; i++) {
+        AWSTMMemoryCacheEntry *entry = candidates[i];
+        double score = 0.0;
+
+        if (_evictionPolicy == AWSTMMemoryCacheEvictionPolicyLFU)
+            score = 1.0 / (1.0 + entry->_accessCount);
+        else
+            score = (double)entry->_cost / (1.0 + entry->_accessCount);
+
+        if (score > victimScore) { // ties go to the least recent
+            victim = entry;
+            victimScore = score;
+        }
+    }
+
+    for (NSUInteger i = 0; i < count; i++) {
+        AWSTMMemoryCacheEntry *entry = candidates[i];
+        if (entry == victim)
+            continue;
+
+        entry->_accessCount /= 2;
+        [self promoteEntry:entry];
+    }
+
+    return victim;
+}
+
+- (AWSTMMemoryCacheEntry *)entryToEvict
+{
+    if (_evictionPolicy == AWSTMMemoryCacheEvictionPolicyLRU)
+        return [self leastRecentlyUsedEntry];
+
+    return [self sampledEntryToEvict];
+}
+
+#pragma mark - Private Trim Methods -
+
 - (void)removeObjectAndExecuteBlocksForKey:(NSString *)key
 {
-    id object = [_dictionary objectForKey:key];
-    NSNumber *cost = [_costs objectForKey:key];
+    AWSTMMemoryCacheEntry *entry = [_entries objectForKey:key];
+    if (!entry)
+        return;
 
     if (_willRemoveObjectBlock)
-        _willRemoveObjectBlock(self, key, object);
+        _willRemoveObjectBlock(self, key, entry->_object);
 
-    if (cost)
-        _totalCost -= [cost unsignedIntegerValue];
+    _totalCost -= entry->_cost;
 
-    [_dictionary removeObjectForKey:key];
-    [_dates removeObjectForKey:key];
-    [_costs removeObjectForKey:key];
+    [self unlinkEntry:entry];
+    [_entries removeObjectForKey:key];
 
     if (_didRemoveObjectBlock)
         _didRemoveObjectBlock(self, key, nil);
@@ -155,18 +303,16 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
 
 - (void)trimMemoryToDate:(NSDate *)trimDate
 {
-    NSArray *keysSortedByDate = [_dates keysSortedByValueUsingSelector:@selector(compare:)];
-    
-    for (NSString *key in keysSortedByDate) { // oldest objects first
-        NSDate *accessDate = [_dates objectForKey:key];
-        if (!accessDate)
-            continue;
-        
-        if ([accessDate compare:trimDate] == NSOrderedAscending) { // older than trim date
-            [self removeObjectAndExecuteBlocksForKey:key];
-        } else {
-            break;
-        }
+    int64_t trimTime = AWSTMMemoryCacheTimestamp(trimDate);
+
+    // Promoted entries are relinked with their old access time and reads are only applied lazily, so the list is
+    // not sorted by access time and every entry has to be checked.
+    AWSTMMemoryCacheEntry *entry = _tail;
+    while (entry) { // oldest objects first
+        AWSTMMemoryCacheEntry *previous = entry->_previous;
+        if (entry->_accessTime < trimTime)
+            [self removeObjectAndExecuteBlocksForKey:entry->_key];
+        entry = previous;
     }
 }
 
@@ -175,10 +321,16 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
     if (_totalCost <= limit)
         return;
 
-    NSArray *keysSortedByCost = [_costs keysSortedByValueUsingSelector:@selector(compare:)];
+    NSArray *entriesSortedByCost = [[_entries allValues] sortedArrayUsingComparator:^NSComparisonResult(AWSTMMemoryCacheEntry *entry, AWSTMMemoryCacheEntry *other) {
+        if (entry->_cost > other->_cost)
+            return NSOrderedAscending;
+        if (entry->_cost < other->_cost)
+            return NSOrderedDescending;
+        return NSOrderedSame;
+    }];
 
-    for (NSString *key in [keysSortedByCost reverseObjectEnumerator]) { // costliest objects first
-        [self removeObjectAndExecuteBlocksForKey:key];
+    for (AWSTMMemoryCacheEntry *entry in entriesSortedByCost) { // costliest objects first
+        [self removeObjectAndExecuteBlocksForKey:entry->_key];
 
         if (_totalCost <= limit)
             break;
@@ -187,17 +339,18 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
 
 - (void)trimToCostLimitByDate:(NSUInteger)limit
 {
-    if (_totalCost <= limit)
-        return;
+    AWSTMMemoryCacheEntry *entry = nil;
 
-    NSArray *keysSortedByDate = [_dates keysSortedByValueUsingSelector:@selector(compare:)];
+    while (_totalCost > limit && (entry = [self leastRecentlyUsedEntry])) // oldest objects first
+        [self removeObjectAndExecuteBlocksForKey:entry->_key];
+}
 
-    for (NSString *key in keysSortedByDate) { // oldest objects first
-        [self removeObjectAndExecuteBlocksForKey:key];
+- (void)trimToCostLimitByEvictionPolicy:(NSUInteger)limit
+{
+    AWSTMMemoryCacheEntry *entry = nil;
 
-        if (_totalCost <= limit)
-            break;
-    }
+    while (_totalCost > limit && (entry = [self entryToEvict]))
+        [self removeObjectAndExecuteBlocksForKey:entry->_key];
 }
 
 - (void)trimToAgeLimitRecursively
@@ -225,6 +378,19 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
     });
 }
 
+#pragma mark - Private Reader Methods -
+
+// Runs concurrently with other readers, so the access is recorded on the entry without touching the list.
+- (id)readObjectForKey:(NSString *)key date:(NSDate *)date
+{
+    AWSTMMemoryCacheEntry *entry = [_entries objectForKey:key];
+    if (!entry)
+        return nil;
+
+    AWSTMMemoryCacheEntryRecordAccess(entry, AWSTMMemoryCacheTimestamp(date));
+    return entry->_object;
+}
+
 #pragma mark - Public Asynchronous Methods -
 
 - (void)objectForKey:(NSString *)key block:(AWSTMMemoryCacheObjectBlock)block
@@ -241,16 +407,7 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         if (!strongSelf)
             return;
 
-        id object = [strongSelf->_dictionary objectForKey:key];
-
-        if (object) {
-            __weak AWSTMMemoryCache *weakSelf = strongSelf;
-            dispatch_barrier_async(strongSelf->_queue, ^{
-                AWSTMMemoryCache *strongSelf = weakSelf;
-                if (strongSelf)
-                    [strongSelf->_dates setObject:now forKey:key];
-            });
-        }
+        id object = [strongSelf readObjectForKey:key date:now];
 
         block(strongSelf, key, object);
     });
@@ -278,17 +435,30 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         if (strongSelf->_willAddObjectBlock)
             strongSelf->_willAddObjectBlock(strongSelf, key, object);
 
-        [strongSelf->_dictionary setObject:object forKey:key];
-        [strongSelf->_dates setObject:now forKey:key];
-        [strongSelf->_costs setObject:@(cost) forKey:key];
+        AWSTMMemoryCacheEntry *entry = [strongSelf->_entries objectForKey:key];
 
-        _totalCost += cost;
+        if (entry) {
+            strongSelf->_totalCost -= entry->_cost;
+            [strongSelf unlinkEntry:entry];
+        } else {
+            entry = [[AWSTMMemoryCacheEntry alloc] init];
+            entry->_key = [key copy];
+            [strongSelf->_entries setObject:entry forKey:entry->_key];
+        }
+
+        entry->_object = object;
+        entry->_cost = cost;
+        entry->_accessTime = AWSTMMemoryCacheTimestamp(now);
+        entry->_accessCount++;
+        [strongSelf linkEntryAtHead:entry];
+
+        strongSelf->_totalCost += cost;
 
         if (strongSelf->_didAddObjectBlock)
             strongSelf->_didAddObjectBlock(strongSelf, key, object);
 
         if (strongSelf->_costLimit > 0)
-            [strongSelf trimToCostByDate:strongSelf->_costLimit block:nil];
+            [strongSelf trimToCostLimitByEvictionPolicy:strongSelf->_costLimit];
 
         if (block) {
             __weak AWSTMMemoryCache *weakSelf = strongSelf;
@@ -412,9 +582,9 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         if (strongSelf->_willRemoveAllObjectsBlock)
             strongSelf->_willRemoveAllObjectsBlock(strongSelf);
 
-        [strongSelf->_dictionary removeAllObjects];
-        [strongSelf->_dates removeAllObjects];
-        [strongSelf->_costs removeAllObjects];
+        [strongSelf->_entries removeAllObjects];
+        strongSelf->_head = nil;
+        strongSelf->_tail = nil;
         
         strongSelf->_totalCost = 0;
 
@@ -444,10 +614,16 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         if (!strongSelf)
             return;
 
-        NSArray *keysSortedByDate = [strongSelf->_dates keysSortedByValueUsingSelector:@selector(compare:)];
+        NSArray *entriesSortedByDate = [[strongSelf->_entries allValues] sortedArrayUsingComparator:^NSComparisonResult(AWSTMMemoryCacheEntry *entry, AWSTMMemoryCacheEntry *other) {
+            if (entry->_accessTime < other->_accessTime)
+                return NSOrderedAscending;
+            if (entry->_accessTime > other->_accessTime)
+                return NSOrderedDescending;
+            return NSOrderedSame;
+        }];
         
-        for (NSString *key in keysSortedByDate) {
-            block(strongSelf, key, [strongSelf->_dictionary objectForKey:key]);
+        for (AWSTMMemoryCacheEntry *entry in entriesSortedByDate) {
+            block(strongSelf, entry->_key, entry->_object);
         }
 
         if (completionBlock) {
@@ -465,23 +641,16 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
 
 - (id)objectForKey:(NSString *)key
 {
+    NSDate *now = [[NSDate alloc] init];
+
     if (!key)
         return nil;
 
     __block id objectForKey = nil;
 
-    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-
-    [self objectForKey:key block:^(AWSTMMemoryCache *cache, NSString *key, id object) {
-        objectForKey = object;
-        dispatch_semaphore_signal(semaphore);
-    }];
-
-    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
-
-    #if !OS_OBJECT_USE_OBJC
-    dispatch_release(semaphore);
-    #endif
+    dispatch_sync(_queue, ^{
+        objectForKey = [self readObjectForKey:key date:now];
+    });
 
     return objectForKey;
 }
@@ -856,7 +1025,31 @@ NSString * const AWSTMMemoryCachePrefix = @"com.tumblr.TMMemoryCache";
         strongSelf->_costLimit = costLimit;
 
         if (costLimit > 0)
-            [strongSelf trimToCostLimitByDate:costLimit];
+            [strongSelf trimToCostLimitByEvictionPolicy:costLimit];
+    });
+}
+
+- (AWSTMMemoryCacheEvictionPolicy)evictionPolicy
+{
+    __block AWSTMMemoryCacheEvictionPolicy evictionPolicy = AWSTMMemoryCacheEvictionPolicyLRU;
+
+    dispatch_sync(_queue, ^{
+        evictionPolicy = _evictionPolicy;
+    });
+
+    return evictionPolicy;
+}
+
+- (void)setEvictionPolicy:(AWSTMMemoryCacheEvictionPolicy)evictionPolicy
+{
+    __weak AWSTMMemoryCache *weakSelf = self;
+
+    dispatch_barrier_async(_queue, ^{
+        AWSTMMemoryCache *strongSelf = weakSelf;
+        if (!strongSelf)
+            return;
+
+        strongSelf->_evictionPolicy = evictionPolicy;
     });
 }
 
@@ -21,6 +21,13 @@
  */
 + (instancetype)defaultExecutor;
 
+/*!
+ Returns an executor that runs continuations immediately until the call stack gets too deep, like
+ the default executor, but keeps the depth in a thread-local counter and hands overflow work to a
+ fixed pool of worker threads that steal from each other's queues instead of dispatching to GCD.
+ */
++ (instancetype)workStealingExecutor;
+
 /*!
  Returns an executor that runs continuations on the thread where the previous task was completed.
  */
@@ -10,6 +10,30 @@
 #import "sqlite3.h"
 
 @class AWSFMDatabase;
+@class AWSFMResultSet;
+
+/** Value for `PRAGMA synchronous` while a bulk import runs. */
+
+typedef NS_ENUM(NSInteger, AWSFMDatabaseSynchronous) {
+    /** Leave the connection's current setting alone. */
+    AWSFMDatabaseSynchronousDefault = -1,
+    /** `PRAGMA synchronous = OFF`. Fastest; a power loss can corrupt the database. */
+    AWSFMDatabaseSynchronousOff = 0,
+    /** `PRAGMA synchronous = NORMAL`. Syncs at critical moments only. */
+    AWSFMDatabaseSynchronousNormal = 1,
+    /** `PRAGMA synchronous = FULL`. SQLite's default. */
+    AWSFMDatabaseSynchronousFull = 2,
+};
+
+/** Binds one row of arguments for a bulk import.
+ 
+ @param statement The prepared statement, already reset with its bindings cleared.
+ @param rowIndex Zero-based index of the row being bound.
+ 
+ @return `YES` to insert the row; `NO` when there are no more rows.
+ */
+
+typedef BOOL (^AWSFMDatabaseBulkBindingBlock)(sqlite3_stmt *statement, NSUInteger rowIndex);
 
 /** To perform queries and updates on multiple threads, you'll want to use `FMDatabaseQueue`.
 
@@ -155,6 +179,58 @@
 
 - (void)inDeferredTransaction:(void (^)(AWSFMDatabase *db, BOOL *rollback))block;
 
+///-----------------------------
+/// @name Bulk import and export
+///-----------------------------
+
+/** Synchronously run one statement over many rows, committing in batches.
+ 
+ `sql` is prepared once and reused for every row; `block` binds each row directly with the `sqlite3_bind_*` functions. Rows are committed every `batchSize` rows so a long import does not hold one giant transaction. If a row fails, the current batch is rolled back and the import stops; earlier batches stay committed.
+ 
+ @param sql The SQL statement run once per row.
+ @param batchSize Number of rows per transaction. `0` puts every row in one transaction.
+ @param synchronous `PRAGMA synchronous` to use for the import. The previous setting is restored afterwards.
+ @param block Binds the arguments for each row. See `AWSFMDatabaseBulkBindingBlock`.
+ @param outRowCount Receives the number of committed rows. May be `NULL`.
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if every row was inserted; `NO` on failure.
+ */
+
+- (BOOL)importRowsWithStatement:(NSString *)sql batchSize:(NSUInteger)batchSize synchronous:(AWSFMDatabaseSynchronous)synchronous bindingBlock:(AWSFMDatabaseBulkBindingBlock)block rowCount:(NSUInteger *)outRowCount error:(NSError **)outErr;
+
+/** Synchronously run one statement over rows of argument arrays, committing in batches.
+ 
+ Like `<importRowsWithStatement:batchSize:synchronous:bindingBlock:rowCount:error:>`, but each row is an `NSArray` of arguments bound the same way as `executeUpdate:withArgumentsInArray:`. Missing trailing arguments bind as `NULL`. Pass a lazy enumerator to stream rows without building them all up front.
+ 
+ @param sql The SQL statement run once per row.
+ @param rows Enumerator yielding one `NSArray` of arguments per row.
+ @param batchSize Number of rows per transaction. `0` puts every row in one transaction.
+ @param synchronous `PRAGMA synchronous` to use for the import.
+ @param outRowCount Receives the number of committed rows. May be `NULL`.
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if every row was inserted; `NO` on failure.
+ */
+
+- (BOOL)importRowsWithStatement:(NSString *)sql argumentRows:(NSEnumerator *)rows batchSize:(NSUInteger)batchSize synchronous:(AWSFMDatabaseSynchronous)synchronous rowCount:(NSUInteger *)outRowCount error:(NSError **)outErr;
+
+/** Synchronously stream the rows of a query to a block.
+ 
+ Rows are read one at a time from the open statement and never collected into an array. Use the typed row mapping on `<FMResultSet>` inside the block to avoid boxing values.
+ 
+ @param sql The SELECT statement to be performed.
+ @param arguments Arguments for the `?` placeholders in `sql`. May be `nil`.
+ @param block Called once per row. Set `*stop` to `YES` to end early.
+ @param outErr A 'NSError' object to receive any error object (if any).
+ 
+ @return `YES` if the query ran to completion or was stopped; `NO` on failure.
+ 
+ @warning The block runs on the queue; do not call back into this `FMDatabaseQueue` from it.
+ */
+
+- (BOOL)exportRowsWithQuery:(NSString *)sql arguments:(NSArray *)arguments usingBlock:(void (^)(AWSFMResultSet *rs, BOOL *stop))block error:(NSError **)outErr;
+
 ///-----------------------------------------------
 /// @name Dispatching database operations to queue
 ///-----------------------------------------------
@@ -31,6 +31,14 @@ FOUNDATION_EXPORT NSString *const AWSSignatureV4Terminator;
 + (NSString *)hexEncode:(NSString *)string;
 + (NSString *)HMACSign:(NSData *)data withKey:(NSString *)key usingAlgorithm:(uint32_t)algorithm;
 
+/**
+ Byte-oriented helpers for the SigV4 hot path. Digests and their hex encodings are computed in stack buffers; only the returned lowercase hex string is allocated.
+ */
++ (NSString *)hexEncodeData:(NSData *)data;
++ (NSString *)hexSha256OfData:(NSData *)data;
++ (NSString *)hexSha256OfString:(NSString *)string;
++ (NSString *)hexSha256HMacWithData:(NSData *)data withKey:(NSData *)key;
+
 @end
 
 @interface AWSSignatureV4Signer : NSObject <AWSNetworkingRequestInterceptor>
@@ -49,6 +57,16 @@ FOUNDATION_EXPORT NSString *const AWSSignatureV4Terminator;
                               headers:(NSDictionary *)headers
                         contentSha256:(NSString *)contentSha256;
 
+/**
+ Builds the canonical request and, in the same pass over the sorted headers, the signed headers list. Produces the same canonical request as `+ getCanonicalizedRequest:path:query:headers:contentSha256:`.
+ */
++ (NSString *)getCanonicalizedRequest:(NSString *)method
+                                 path:(NSString *)path
+                                query:(NSString *)query
+                              headers:(NSDictionary *)headers
+                        contentSha256:(NSString *)contentSha256
+                        signedHeaders:(NSString *__autoreleasing *)signedHeaders;
+
 + (NSData *)getV4DerivedKey:(NSString *)secret
                        date:(NSString *)dateStamp
                      region:(NSString *)regionName
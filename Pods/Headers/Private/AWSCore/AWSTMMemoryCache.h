@@ -5,11 +5,13 @@
  Access is natively asynchronous. Every method accepts a callback block that runs on a concurrent
  <queue>, with cache writes protected by GCD barriers. Synchronous variations are provided.
  
- All access to the cache is dated so the that the least-used objects can be trimmed first. Setting an
+ All access to the cache is dated so the that the least-used objects can be trimmed first. Reads record
+ their access with atomic operations instead of a barrier, so they never wait for each other. Setting an
  optional <ageLimit> will trigger a GCD timer to periodically to trim the cache to that age.
  
  Objects can optionally be set with a "cost", which could be a byte count or any other meaningful integer.
- Setting a <costLimit> will automatically keep the cache below that value with <trimToCostByDate:>.
+ Setting a <costLimit> will automatically keep the cache below that value, removing objects in the order
+ given by the <evictionPolicy>.
 
  Values will not persist after application relaunch or returning from the background. See <TMCache> for
  a memory cache backed by a disk cache.
@@ -19,6 +21,18 @@
 
 @class AWSTMMemoryCache;
 
+/**
+ The order in which objects are removed when the cache goes over its <costLimit>.
+ */
+typedef NS_ENUM(NSInteger, AWSTMMemoryCacheEvictionPolicy) {
+    /** Least recently used first. This is the default. */
+    AWSTMMemoryCacheEvictionPolicyLRU,
+    /** Least frequently used first. Use counts are halved each time an object survives an eviction, so old popularity fades. */
+    AWSTMMemoryCacheEvictionPolicyLFU,
+    /** Highest cost per use first, so expensive objects that are rarely read go before cheap popular ones. */
+    AWSTMMemoryCacheEvictionPolicyCostWeighted,
+};
+
 typedef void (^AWSTMMemoryCacheBlock)(AWSTMMemoryCache *cache);
 typedef void (^AWSTMMemoryCacheObjectBlock)(AWSTMMemoryCache *cache, NSString *key, id object);
 
@@ -39,10 +53,17 @@ typedef void (^AWSTMMemoryCacheObjectBlock)(AWSTMMemoryCache *cache, NSString *k
 @property (readonly) NSUInteger totalCost;
 
 /**
- The maximum cost allowed to accumulate before objects begin to be removed with <trimToCostByDate:>.
+ The maximum cost allowed to accumulate before objects begin to be removed according to the <evictionPolicy>.
  */
 @property (assign) NSUInteger costLimit;
 
+/**
+ How objects are picked for removal when the <totalCost> goes over the <costLimit>. LFU and cost-weighted
+ eviction choose among a small sample of the least recently used objects. Defaults to
+ `AWSTMMemoryCacheEvictionPolicyLRU`, which behaves like <trimToCostByDate:>.
+ */
+@property (assign) AWSTMMemoryCacheEvictionPolicy evictionPolicy;
+
 /**
  The maximum number of seconds an object is allowed to exist in the cache. Setting this to a value
  greater than `0.0` will start a recurring GCD timer with the same period that calls <trimToDate:>.
@@ -12,18 +12,20 @@
 
 typedef void (^STPAPIConnectionCompletionBlock)(NSURLResponse * __nullable response, NSData * __nullable body, NSError * __nullable requestError);
 
-// Like NSURLConnection but verifies that the server isn't using a revoked certificate.
-@interface STPAPIConnection : NSObject<NSURLConnectionDelegate, NSURLConnectionDataDelegate>
+// Runs a request through an NSURLSession shared by all connections, so that requests to the Stripe API reuse a kept-alive
+// connection instead of doing a TLS handshake each time. Verifies the server trust like the system does.
+@interface STPAPIConnection : NSObject
 
 - (nonnull instancetype)initWithRequest:(nonnull NSURLRequest *)request;
-- (void)runOnOperationQueue:(nonnull NSOperationQueue *)queue completion:(nullable STPAPIConnectionCompletionBlock)handler;
+
+// Calls the handler on a private serial queue, so that the response can be handled off the main thread.
+- (void)runWithCompletion:(nullable STPAPIConnectionCompletionBlock)handler;
+
+// Opens a connection to the host of `URL` ahead of time with a HEAD request. Does nothing if a connection was warmed up recently.
++ (void)warmUpConnectionToURL:(nonnull NSURL *)URL;
 
 @property (nonatomic) BOOL started;
 @property (nonatomic, copy, nonnull) NSURLRequest *request;
-@property (nonatomic, strong, nullable) NSURLConnection *connection;
-@property (nonatomic, strong, nullable) NSMutableData *receivedData;
-@property (nonatomic, strong, nullable) NSURLResponse *receivedResponse;
-@property (nonatomic, strong, nullable) NSError *overrideError; // Replaces the request's error
-@property (nonatomic, copy, nullable) STPAPIConnectionCompletionBlock completionBlock;
+@property (nonatomic, strong, nullable) NSURLSessionDataTask *task;
 
 @end
@@ -11,6 +11,17 @@
 #import "STPCardBrand.h"
 #import "STPCardValidationState.h"
 
+/**
+ *  A set of card brands, with one bit per STPCardBrand.
+ */
+typedef NS_OPTIONS(NSUInteger, STPCardBrandMask) {
+    STPCardBrandMaskNone = 0,
+};
+
+static inline STPCardBrandMask STPCardBrandMaskForBrand(STPCardBrand brand) {
+    return (STPCardBrandMask)1 << brand;
+}
+
 /**
  *  This class contains static methods to validate card numbers, expiration dates, and CVCs. For a list of test card numbers to use with this code, see https://stripe.com/docs/testing
  */
@@ -45,6 +56,29 @@
  */
 + (STPCardBrand)brandForNumber:(nonnull NSString *)cardNumber;
 
+/**
+ *  The card brands a card number or substring thereof could belong to, in a single pass over its digits and without allocating. Non-digit characters are ignored.
+ *
+ *  @param cardNumber A card number, or partial card number. For example, @"3", @"4242", or @"4242 4242 4242 4242".
+ *
+ *  @return A mask of the possible brands. The example parameters would return the masks for Amex, JCB and Diners Club, for Visa, and for Visa, respectively.
+ */
++ (STPCardBrandMask)possibleBrandMaskForNumber:(nonnull NSString *)cardNumber;
+
+/**
+ *  Replaces the BIN ranges used to determine card brands, for instance with ranges downloaded from your server. The data must be a JSON array of objects such as
+ *  {"brand": "discover", "low": "622126", "high": "622925"}, where "low" and "high" are card number prefixes of the same length (at most 8 digits) and "brand" is
+ *  one of "visa", "amex", "mastercard", "discover", "jcb" and "diners_club". The current ranges are kept if the data is invalid.
+ *
+ *  @return YES if the ranges were replaced, NO otherwise, with the reason in `error`.
+ */
++ (BOOL)updateBINRangesWithJSONData:(nonnull NSData *)data error:(NSError * __nullable * __nullable)error;
+
+/**
+ *  Restores the BIN ranges built into the SDK.
+ */
++ (void)resetBINRanges;
+
 /**
  *  The number length for cards associated with a card brand. For example, Visa card numbers contain 16 characters, while American Express cards contain 15 characters.
  */
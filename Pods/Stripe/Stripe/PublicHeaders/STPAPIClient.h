@@ -55,10 +55,16 @@ typedef void (^STPCompletionBlock)(STPToken * __nullable token, NSError * __null
 @property (nonatomic, copy, nullable) NSString *publishableKey;
 
 /**
- *  The operation queue on which to run the url connection and delegate methods. Cannot be nil. @see NSURLConnection
+ *  The operation queue on which to run the completion blocks. Cannot be nil. Responses are parsed before, on a background queue.
  */
 @property (nonatomic, nonnull) NSOperationQueue *operationQueue;
 
+/**
+ *  Opens a connection to the Stripe API ahead of time, so that creating a token does not wait for a TLS handshake. Call this when a payment is likely,
+ *  for instance when presenting a payment sheet. The connection is shared by all API clients and kept alive for a short while.
+ */
+- (void)warmUpConnection;
+
 @end
 
 #pragma mark Bank Accounts
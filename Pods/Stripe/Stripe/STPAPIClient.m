@@ -41,6 +41,8 @@ static NSString *STPDefaultPublishableKey;
 
 @interface STPAPIClient ()
 @property (nonatomic, readwrite) NSURL *apiURL;
+// The URL, method and headers of token requests, built once per publishable key.
+@property (nonatomic, copy) NSURLRequest *tokenRequestTemplate;
 @end
 
 @implementation STPAPIClient
@@ -62,62 +64,86 @@ static NSString *STPDefaultPublishableKey;
         [self.class validateKey:publishableKey];
         _apiURL = [[[NSURL URLWithString:[NSString stringWithFormat:@"https://%@", apiURLBase]] URLByAppendingPathComponent:apiVersion]
             URLByAppendingPathComponent:tokenEndpoint];
-        _publishableKey = [publishableKey copy];
         _operationQueue = [NSOperationQueue mainQueue];
+        self.publishableKey = publishableKey;
     }
     return self;
 }
 
+- (void)setPublishableKey:(NSString *)publishableKey {
+    _publishableKey = [publishableKey copy];
+
+    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:self.apiURL];
+    request.HTTPMethod = @"POST";
+    [request setValue:[self.class stripeUserAgentHeaderValue] forHTTPHeaderField:@"X-Stripe-User-Agent"];
+    if (_publishableKey) {
+        [request setValue:[@"Bearer " stringByAppendingString:_publishableKey] forHTTPHeaderField:@"Authorization"];
+    }
+    self.tokenRequestTemplate = request;
+}
+
 - (void)setOperationQueue:(NSOperationQueue *)operationQueue {
     NSCAssert(operationQueue, @"Operation queue cannot be nil.");
     _operationQueue = operationQueue;
 }
 
+- (void)warmUpConnection {
+    [STPAPIConnection warmUpConnectionToURL:self.apiURL];
+}
+
 - (void)createTokenWithData:(NSData *)data completion:(STPCompletionBlock)completion {
     NSCAssert(data != nil, @"'data' is required to create a token");
     NSCAssert(completion != nil, @"'completion' is required to use the token that is created");
     
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:self.apiURL];
-    request.HTTPMethod = @"POST";
+    NSMutableURLRequest *request = [self.tokenRequestTemplate mutableCopy];
     request.HTTPBody = data;
-    [request setValue:[self.class JSONStringForObject:[self.class stripeUserAgentDetails]] forHTTPHeaderField:@"X-Stripe-User-Agent"];
-    [request setValue:[@"Bearer " stringByAppendingString:self.publishableKey] forHTTPHeaderField:@"Authorization"];
     
     STPAPIConnection *connection = [[STPAPIConnection alloc] initWithRequest:request];
+    NSOperationQueue *operationQueue = self.operationQueue;
     
-    [connection runOnOperationQueue:self.operationQueue
-                         completion:^(NSURLResponse *response, NSData *body, NSError *requestError) {
-                             if (requestError) {
-                                 // If this is an error that Stripe returned, let's handle it as a StripeDomain error
-                                 if (body) {
-                                     NSDictionary *jsonDictionary = [NSJSONSerialization JSONObjectWithData:body options:0 error:NULL];
-                                     if ([jsonDictionary valueForKey:@"error"] != nil) {
-                                         completion(nil, [self.class errorFromStripeResponse:jsonDictionary]);
-                                         return;
-                                     }
-                                 }
-                                 completion(nil, requestError);
-                                 return;
-                             } else {
-                                 NSDictionary *jsonDictionary = [NSJSONSerialization JSONObjectWithData:body options:0 error:NULL];
-                                 if (!jsonDictionary) {
-                                     NSDictionary *userInfo = @{
-                                                                NSLocalizedDescriptionKey: STPUnexpectedError,
-                                                                STPErrorMessageKey: @"The response from Stripe failed to get parsed into valid JSON."
-                                                                };
-                                     NSError *error = [[NSError alloc] initWithDomain:StripeDomain code:STPAPIError userInfo:userInfo];
-                                     completion(nil, error);
-                                 } else if ([(NSHTTPURLResponse *)response statusCode] == 200) {
-                                     completion([[STPToken alloc] initWithAttributeDictionary:jsonDictionary], nil);
-                                 } else {
-                                     completion(nil, [self.class errorFromStripeResponse:jsonDictionary]);
-                                 }
-                             }
-                         }];
+    // Parse the response on the connection queue, and only call back on the operation queue with the result.
+    [connection runWithCompletion:^(NSURLResponse *response, NSData *body, NSError *requestError) {
+        NSError *error;
+        STPToken *token = [self.class tokenFromResponse:response body:body requestError:requestError error:&error];
+        [operationQueue addOperationWithBlock:^{
+            completion(token, error);
+        }];
+    }];
 }
 
 #pragma mark - private helpers
 
++ (STPToken *)tokenFromResponse:(NSURLResponse *)response body:(NSData *)body requestError:(NSError *)requestError error:(NSError **)outError {
+    if (requestError) {
+        // If this is an error that Stripe returned, let's handle it as a StripeDomain error
+        if (body) {
+            NSDictionary *jsonDictionary = [NSJSONSerialization JSONObjectWithData:body options:0 error:NULL];
+            if ([jsonDictionary valueForKey:@"error"] != nil) {
+                *outError = [self errorFromStripeResponse:jsonDictionary];
+                return nil;
+            }
+        }
+        *outError = requestError;
+        return nil;
+    }
+
+    NSDictionary *jsonDictionary = body ? [NSJSONSerialization JSONObjectWithData:body options:0 error:NULL] : nil;
+    if (!jsonDictionary) {
+        NSDictionary *userInfo = @{
+                                   NSLocalizedDescriptionKey: STPUnexpectedError,
+                                   STPErrorMessageKey: @"The response from Stripe failed to get parsed into valid JSON."
+                                   };
+        *outError = [[NSError alloc] initWithDomain:StripeDomain code:STPAPIError userInfo:userInfo];
+        return nil;
+    } else if ([(NSHTTPURLResponse *)response statusCode] == 200) {
+        *outError = nil;
+        return [[STPToken alloc] initWithAttributeDictionary:jsonDictionary];
+    } else {
+        *outError = [self errorFromStripeResponse:jsonDictionary];
+        return nil;
+    }
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-variable"
 + (void)validateKey:(NSString *)publishableKey {
@@ -224,6 +250,14 @@ static NSString *STPDefaultPublishableKey;
     return [details copy];
 }
 
+// The user agent details do not change while the app runs, so they are only serialized once.
++ (NSString *)stripeUserAgentHeaderValue {
+    static NSString *headerValue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ headerValue = [self JSONStringForObject:[self stripeUserAgentDetails]]; });
+    return headerValue;
+}
+
 + (NSString *)JSONStringForObject:(id)object {
     return [[NSString alloc] initWithData:[NSJSONSerialization dataWithJSONObject:object options:0 error:NULL] encoding:NSUTF8StringEncoding];
 }
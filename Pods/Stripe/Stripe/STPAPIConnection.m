@@ -10,67 +10,94 @@
 #import "StripeError.h"
 #import <CommonCrypto/CommonDigest.h>
 
-@implementation STPAPIConnection
+// Servers close idle connections after a while, so a warm-up older than this one no longer helps.
+static const NSTimeInterval STPAPIConnectionWarmUpInterval = 30;
 
-- (instancetype)initWithRequest:(NSURLRequest *)request {
-    if (self = [super init]) {
-        _request = request;
-        _connection = [[NSURLConnection alloc] initWithRequest:_request delegate:self startImmediately:NO];
-        _receivedData = [[NSMutableData alloc] init];
+@interface STPAPIConnectionSessionDelegate : NSObject<NSURLSessionTaskDelegate>
+@end
+
+@implementation STPAPIConnectionSessionDelegate
+
+// Server trust challenges are left to the session, which evaluates them like the system does. HTTP authentication
+// challenges come per task.
+- (void)URLSession:(__unused NSURLSession *)session
+                task:(__unused NSURLSessionTask *)task
+ didReceiveChallenge:(NSURLAuthenticationChallenge *)challenge
+   completionHandler:(void (^)(NSURLSessionAuthChallengeDisposition, NSURLCredential *))completionHandler {
+    NSString *authenticationMethod = challenge.protectionSpace.authenticationMethod;
+    if ([authenticationMethod isEqualToString:NSURLAuthenticationMethodDefault]
+        || [authenticationMethod isEqualToString:NSURLAuthenticationMethodHTTPBasic]
+        || [authenticationMethod isEqualToString:NSURLAuthenticationMethodHTTPDigest]) {
+        // The publishable key is sent in the Authorization header, so there is no credential to offer. Rejecting the
+        // challenge lets the 401 response and its error body bubble back through the request's error handler.
+        completionHandler(NSURLSessionAuthChallengeRejectProtectionSpace, nil);
+    } else {
+        completionHandler(NSURLSessionAuthChallengePerformDefaultHandling, nil);
     }
-    return self;
 }
 
-- (void)runOnOperationQueue:(NSOperationQueue *)queue completion:(STPAPIConnectionCompletionBlock)handler {
-    NSCAssert(!self.started, @"This API connection has already started.");
-    NSCAssert(queue, @"'queue' is required");
-    NSCAssert(handler, @"'handler' is required");
-    
-    self.started = YES;
-    self.completionBlock = handler;
-    [self.connection setDelegateQueue:queue];
-    [self.connection start];
-}
+@end
 
-#pragma mark NSURLConnectionDataDelegate
+@implementation STPAPIConnection
 
-- (void)connection:(__unused NSURLConnection *)connection didReceiveResponse:(NSURLResponse *)response {
-    self.receivedResponse = response;
-}
++ (NSURLSession *)sharedSession {
+    static NSURLSession *sharedSession;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        // Card data must not end up in a cache or cookie store on disk.
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        configuration.URLCache = nil;
+        configuration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        configuration.HTTPShouldSetCookies = NO;
+        configuration.TLSMinimumSupportedProtocol = kTLSProtocol12;
 
-- (void)connection:(__unused NSURLConnection *)connection didReceiveData:(NSData *)data {
-    [self.receivedData appendData:data];
-}
+        NSOperationQueue *delegateQueue = [[NSOperationQueue alloc] init];
+        delegateQueue.name = @"com.stripe.STPAPIConnection";
+        delegateQueue.maxConcurrentOperationCount = 1;
 
-- (void)connectionDidFinishLoading:(__unused NSURLConnection *)connection {
-    self.connection = nil;
-    self.completionBlock(self.receivedResponse, self.receivedData, nil);
-    self.receivedData = nil;
-    self.receivedResponse = nil;
+        sharedSession = [NSURLSession sessionWithConfiguration:configuration delegate:[STPAPIConnectionSessionDelegate new] delegateQueue:delegateQueue];
+    });
+    return sharedSession;
 }
 
-#pragma mark NSURLConnectionDelegate
++ (void)warmUpConnectionToURL:(NSURL *)URL {
+    static CFAbsoluteTime lastWarmUpTime;
+    @synchronized(self) {
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        if (lastWarmUpTime != 0 && now - lastWarmUpTime < STPAPIConnectionWarmUpInterval) {
+            return;
+        }
+        lastWarmUpTime = now;
+    }
 
-- (void)connection:(__unused NSURLConnection *)connection didFailWithError:(NSError *)error {
-    self.connection = nil;
-    self.receivedData = nil;
-    self.receivedResponse = nil;
-    self.completionBlock(self.receivedResponse, self.receivedData, self.overrideError ?: error);
+    // Any response will do: what matters is the connection left open in the session.
+    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:URL];
+    request.HTTPMethod = @"HEAD";
+    [[[self sharedSession] dataTaskWithRequest:request] resume];
 }
 
-- (void)connection:(__unused NSURLConnection *)connection willSendRequestForAuthenticationChallenge:(NSURLAuthenticationChallenge *)challenge {
-    if ([challenge.protectionSpace.authenticationMethod isEqualToString:NSURLAuthenticationMethodServerTrust]) {
-        SecTrustRef serverTrust = [[challenge protectionSpace] serverTrust];
-        SecTrustResultType resultType;
-        SecTrustEvaluate(serverTrust, &resultType);
-        [challenge.sender performDefaultHandlingForAuthenticationChallenge:challenge];
-    } else if ([challenge.protectionSpace.authenticationMethod isEqualToString:NSURLAuthenticationMethodDefault]) {
-        // If this is an HTTP Authorization request, just continue. We want to bubble this back through the
-        // request's error handler.
-        [challenge.sender continueWithoutCredentialForAuthenticationChallenge:challenge];
-    } else {
-        [challenge.sender performDefaultHandlingForAuthenticationChallenge:challenge];
+- (instancetype)initWithRequest:(NSURLRequest *)request {
+    if (self = [super init]) {
+        _request = [request copy];
     }
+    return self;
+}
+
+- (void)runWithCompletion:(STPAPIConnectionCompletionBlock)handler {
+    NSCAssert(!self.started, @"This API connection has already started.");
+    NSCAssert(handler, @"'handler' is required");
+
+    self.started = YES;
+    self.task = [[self.class sharedSession] dataTaskWithRequest:self.request
+                                               completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+                                                   self.task = nil;
+                                                   if (error) {
+                                                       handler(nil, nil, error);
+                                                   } else {
+                                                       handler(response, data, nil);
+                                                   }
+                                               }];
+    [self.task resume];
 }
 
 @end
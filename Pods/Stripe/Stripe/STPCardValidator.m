@@ -6,24 +6,109 @@
 //  Copyright (c) 2015 Stripe, Inc. All rights reserved.
 //
 
+#import <pthread.h>
+
 #import "STPCardValidator.h"
+#import "StripeError.h"
+
+#pragma mark - BIN ranges
+
+// The longest card number prefix a BIN range can be defined on.
+#define STPBINRangeMaxDigits 8
+
+// All the card numbers starting with `digitCount` digits between `low` and `high` belong to `brand`.
+typedef struct {
+    uint32_t low;
+    uint32_t high;
+    uint8_t digitCount;
+    STPCardBrand brand;
+} STPBINRange;
+
+static const STPBINRange STPDefaultBINRanges[] = {
+    {34, 34, 2, STPCardBrandAmex},
+    {37, 37, 2, STPCardBrandAmex},
+    {30, 30, 2, STPCardBrandDinersClub},
+    {36, 36, 2, STPCardBrandDinersClub},
+    {38, 39, 2, STPCardBrandDinersClub},
+    {6011, 6011, 4, STPCardBrandDiscover},
+    {622, 622, 3, STPCardBrandDiscover},
+    {64, 65, 2, STPCardBrandDiscover},
+    {35, 35, 2, STPCardBrandJCB},
+    {50, 59, 2, STPCardBrandMasterCard},
+    {40, 49, 2, STPCardBrandVisa},
+};
+
+static const uint32_t STPPowersOfTen[STPBINRangeMaxDigits + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+// The table in use, replaced as a whole when the ranges are updated.
+static const STPBINRange *STPBINRanges = STPDefaultBINRanges;
+static NSUInteger STPBINRangeCount = sizeof(STPDefaultBINRanges) / sizeof(STPBINRange);
+static pthread_rwlock_t STPBINRangesLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static void STPReplaceBINRanges(const STPBINRange *ranges, NSUInteger count) {
+    pthread_rwlock_wrlock(&STPBINRangesLock);
+    const STPBINRange *previousRanges = STPBINRanges;
+    STPBINRanges = ranges;
+    STPBINRangeCount = count;
+    pthread_rwlock_unlock(&STPBINRangesLock);
+
+    if (previousRanges != STPDefaultBINRanges) {
+        free((void *)previousRanges);
+    }
+}
+
+static BOOL STPParseBINDigits(id value, uint32_t *outNumber, uint8_t *outDigitCount) {
+    if (![value isKindOfClass:[NSString class]]) {
+        return NO;
+    }
+    NSString *string = value;
+    NSUInteger length = string.length;
+    if (length == 0 || length > STPBINRangeMaxDigits) {
+        return NO;
+    }
+    uint32_t number = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar character = [string characterAtIndex:i];
+        if (character < '0' || character > '9') {
+            return NO;
+        }
+        number = number * 10 + (uint32_t)(character - '0');
+    }
+    *outNumber = number;
+    *outDigitCount = (uint8_t)length;
+    return YES;
+}
 
 @implementation STPCardValidator
 
+// Character sets are immutable, so they are only built once.
++ (NSCharacterSet *)nonDigitCharacterSet {
+    static NSCharacterSet *set;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ set = [[NSCharacterSet decimalDigitCharacterSet] invertedSet]; });
+    return set;
+}
+
 + (NSString *)sanitizedNumericStringForString:(NSString *)string {
-    NSCharacterSet *set = [[NSCharacterSet decimalDigitCharacterSet] invertedSet];
+    NSCharacterSet *set = [self nonDigitCharacterSet];
+    if ([string rangeOfCharacterFromSet:set].location == NSNotFound) {
+        return [string copy];
+    }
     NSArray *components = [string componentsSeparatedByCharactersInSet:set];
     return [components componentsJoinedByString:@""] ?: @"";
 }
 
 + (NSString *)stringByRemovingSpacesFromString:(NSString *)string {
     NSCharacterSet *set = [NSCharacterSet whitespaceCharacterSet];
+    if ([string rangeOfCharacterFromSet:set].location == NSNotFound) {
+        return [string copy];
+    }
     NSArray *components = [string componentsSeparatedByCharactersInSet:set];
     return [components componentsJoinedByString:@""];
 }
 
 + (BOOL)stringIsNumeric:(NSString *)string {
-    return [[self sanitizedNumericStringForString:string] isEqualToString:string];
+    return [string rangeOfCharacterFromSet:[self nonDigitCharacterSet]].location == NSNotFound;
 }
 
 + (STPCardValidationState)validationStateForExpirationMonth:(NSString *)expirationMonth {
@@ -115,13 +200,14 @@
         return STPCardValidationStateInvalid;
     }
     
-    NSArray *brands = [self possibleBrandsForNumber:sanitizedNumber];
-    if (brands.count == 0 && validatingCardBrand) {
+    STPCardBrandMask brands = [self possibleBrandMaskForNumber:sanitizedNumber];
+    NSInteger brandCount = __builtin_popcountl(brands);
+    if (brandCount == 0 && validatingCardBrand) {
         return STPCardValidationStateInvalid;
-    } else if (brands.count >= 2) {
+    } else if (brandCount >= 2) {
         return STPCardValidationStateIncomplete;
     } else {
-        STPCardBrand brand = (STPCardBrand)[brands.firstObject integerValue];
+        STPCardBrand brand = brandCount == 1 ? (STPCardBrand)__builtin_ctzl(brands) : STPCardBrandUnknown;
         NSInteger desiredLength = [self lengthForCardBrand:brand];
         if ((NSInteger)sanitizedNumber.length > desiredLength) {
             return STPCardValidationStateInvalid;
@@ -148,34 +234,98 @@
 }
 
 + (STPCardBrand)brandForNumber:(NSString *)cardNumber {
-    NSString *sanitizedNumber = [self sanitizedNumericStringForString:cardNumber];
-    NSArray *brands = [self possibleBrandsForNumber:sanitizedNumber];
-    if (brands.count == 1) {
-        return (STPCardBrand)[brands.firstObject integerValue];
+    STPCardBrandMask brands = [self possibleBrandMaskForNumber:cardNumber];
+    if (__builtin_popcountl(brands) == 1) {
+        return (STPCardBrand)__builtin_ctzl(brands);
     }
     return STPCardBrandUnknown;
 }
 
-+ (NSArray *)possibleBrandsForNumber:(NSString *)cardNumber {
-    NSMutableArray *possibleBrands = [@[] mutableCopy];
-    for (NSNumber *brandNumber in [self allValidBrands]) {
-        STPCardBrand brand = (STPCardBrand)brandNumber.integerValue;
-        if ([self prefixMatches:brand digits:cardNumber]) {
-            [possibleBrands addObject:@(brand)];
++ (STPCardBrandMask)possibleBrandMaskForNumber:(NSString *)cardNumber {
+    // prefixes[n] is the number made of the first n digits.
+    uint32_t prefixes[STPBINRangeMaxDigits + 1] = {0};
+    NSUInteger digitCount = 0;
+    NSUInteger length = cardNumber.length;
+    for (NSUInteger i = 0; i < length && digitCount < STPBINRangeMaxDigits; i++) {
+        unichar character = [cardNumber characterAtIndex:i];
+        if (character >= '0' && character <= '9') {
+            prefixes[digitCount + 1] = prefixes[digitCount] * 10 + (uint32_t)(character - '0');
+            digitCount++;
+        }
+    }
+
+    STPCardBrandMask brands = STPCardBrandMaskNone;
+    pthread_rwlock_rdlock(&STPBINRangesLock);
+    for (NSUInteger i = 0; i < STPBINRangeCount; i++) {
+        const STPBINRange *range = &STPBINRanges[i];
+        if (digitCount >= range->digitCount) {
+            // The number is long enough to be compared with the range directly.
+            uint32_t prefix = prefixes[range->digitCount];
+            if (prefix >= range->low && prefix <= range->high) {
+                brands |= STPCardBrandMaskForBrand(range->brand);
+            }
+        } else {
+            // The number could still end up in the range if some of the numbers it is a prefix of are in it.
+            uint32_t scale = STPPowersOfTen[range->digitCount - digitCount];
+            uint32_t lowest = prefixes[digitCount] * scale;
+            uint32_t highest = lowest + scale - 1;
+            if (lowest <= range->high && highest >= range->low) {
+                brands |= STPCardBrandMaskForBrand(range->brand);
+            }
+        }
+    }
+    pthread_rwlock_unlock(&STPBINRangesLock);
+
+    return brands;
+}
+
++ (BOOL)updateBINRangesWithJSONData:(NSData *)data error:(NSError **)outError {
+    NSDictionary *brandsByName = @{
+        @"visa": @(STPCardBrandVisa),
+        @"amex": @(STPCardBrandAmex),
+        @"mastercard": @(STPCardBrandMasterCard),
+        @"discover": @(STPCardBrandDiscover),
+        @"jcb": @(STPCardBrandJCB),
+        @"diners_club": @(STPCardBrandDinersClub),
+    };
+
+    NSArray *rangeDictionaries = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    if (![rangeDictionaries isKindOfClass:[NSArray class]] || rangeDictionaries.count == 0) {
+        if (outError) {
+            *outError = [[NSError alloc] initWithDomain:StripeDomain
+                                                   code:STPInvalidRequestError
+                                               userInfo:@{STPErrorMessageKey: @"BIN ranges must be a non-empty JSON array."}];
         }
+        return NO;
     }
-    return [possibleBrands copy];
+
+    STPBINRange *ranges = calloc(rangeDictionaries.count, sizeof(STPBINRange));
+    NSUInteger count = 0;
+    for (NSDictionary *rangeDictionary in rangeDictionaries) {
+        STPBINRange range;
+        uint8_t highDigitCount = 0;
+        NSNumber *brand = [rangeDictionary isKindOfClass:[NSDictionary class]] ? brandsByName[rangeDictionary[@"brand"]] : nil;
+        if (brand == nil ||
+            !STPParseBINDigits(rangeDictionary[@"low"], &range.low, &range.digitCount) ||
+            !STPParseBINDigits(rangeDictionary[@"high"], &range.high, &highDigitCount) ||
+            range.digitCount != highDigitCount || range.low > range.high) {
+            free(ranges);
+            if (outError) {
+                NSString *message = [NSString stringWithFormat:@"Invalid BIN range: %@", rangeDictionary];
+                *outError = [[NSError alloc] initWithDomain:StripeDomain code:STPInvalidRequestError userInfo:@{STPErrorMessageKey: message}];
+            }
+            return NO;
+        }
+        range.brand = (STPCardBrand)brand.integerValue;
+        ranges[count++] = range;
+    }
+
+    STPReplaceBINRanges(ranges, count);
+    return YES;
 }
 
-+ (NSArray *)allValidBrands {
-    return @[
-             @(STPCardBrandAmex),
-             @(STPCardBrandDinersClub),
-             @(STPCardBrandDiscover),
-             @(STPCardBrandJCB),
-             @(STPCardBrandMasterCard),
-             @(STPCardBrandVisa),
-         ];
++ (void)resetBINRanges {
+    STPReplaceBINRanges(STPDefaultBINRanges, sizeof(STPDefaultBINRanges) / sizeof(STPBINRange));
 }
 
 + (NSInteger)lengthForCardBrand:(STPCardBrand)brand {
@@ -200,50 +350,13 @@
     }
 }
 
-+ (BOOL)prefixMatches:(STPCardBrand)brand digits:(NSString *)digits {
-    if (digits.length == 0) {
-        return YES;
-    }
-    NSArray *digitPrefixes = [self validBeginningDigits:brand];
-    for (NSString *digitPrefix in digitPrefixes) {
-        if ((digitPrefix.length >= digits.length && [digitPrefix hasPrefix:digits]) ||
-            (digits.length >= digitPrefix.length && [digits hasPrefix:digitPrefix])) {
-            return YES;
-        }
-    }
-    return NO;
-}
-
-+ (NSArray *)validBeginningDigits:(STPCardBrand)brand {
-    switch (brand) {
-        case STPCardBrandAmex:
-            return @[@"34", @"37"];
-        case STPCardBrandDinersClub:
-            return @[@"30", @"36", @"38", @"39"];
-        case STPCardBrandDiscover:
-            return @[@"6011", @"622", @"64", @"65"];
-        case STPCardBrandJCB:
-            return @[@"35"];
-        case STPCardBrandMasterCard:
-            return @[@"50", @"51", @"52", @"53", @"54", @"55", @"56", @"57", @"58", @"59"];
-        case STPCardBrandVisa:
-            return @[@"40", @"41", @"42", @"43", @"44", @"45", @"46", @"47", @"48", @"49"];
-        case STPCardBrandUnknown:
-            return @[];
-    }
-}
-
 + (BOOL)stringIsValidLuhn:(NSString *)number {
     BOOL odd = true;
     int sum = 0;
-    NSMutableArray *digits = [NSMutableArray arrayWithCapacity:number.length];
-    
-    for (int i = 0; i < (NSInteger)number.length; i++) {
-        [digits addObject:[number substringWithRange:NSMakeRange(i, 1)]];
-    }
     
-    for (NSString *digitStr in [digits reverseObjectEnumerator]) {
-        int digit = [digitStr intValue];
+    for (NSInteger i = (NSInteger)number.length - 1; i >= 0; i--) {
+        unichar character = [number characterAtIndex:(NSUInteger)i];
+        int digit = (character >= '0' && character <= '9') ? character - '0' : 0;
         if ((odd = !odd)) digit *= 2;
         if (digit > 9) digit -= 9;
         sum += digit;